@@ -29,6 +29,7 @@
 #include "epicsRingPointer.h"
 #include "epicsString.h"
 #include "epicsThread.h"
+#include "epicsTime.h"
 #include "epicsTimer.h"
 #include "errlog.h"
 #include "errMdef.h"
@@ -59,6 +60,13 @@ typedef struct cbQueueSet {
     int shutdown; // use atomic
     int threadsConfigured;
     int threadsRunning;
+    /* Queue latency statistics */
+    double latencyBudget; /* seconds, 0 for none */
+    int lateReported;
+    size_t numRun;
+    size_t numLate;
+    size_t maxLatency; /* microseconds */
+    size_t histogram[NUM_CALLBACK_LATENCY_BINS];
 } cbQueueSet;
 
 static cbQueueSet callbackQueue[NUM_CALLBACK_PRIORITIES];
@@ -97,6 +105,8 @@ static unsigned int threadPriority[NUM_CALLBACK_PRIORITIES] = {
 };
 static int priorityValue[NUM_CALLBACK_PRIORITIES] = {0, 1, 2};
 
+static void ProcessCallback(epicsCallback *pcallback);
+
 
 int callbackSetQueueSize(int size)
 {
@@ -134,14 +144,45 @@ int callbackQueueStatus(const int reset, callbackQueueStats *result)
     return ret;
 }
 
+int callbackLatencyStatus(const int reset, callbackLatencyStats *result)
+{
+    int prio, bin;
+
+    if (epicsAtomicGetIntT(&cbState)==cbInit) return -1;
+    for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+        cbQueueSet *mySet = &callbackQueue[prio];
+
+        if (result) {
+            result->budget[prio] = mySet->latencyBudget;
+            result->maxLatency[prio] =
+                epicsAtomicGetSizeT(&mySet->maxLatency) * 1e-6;
+            result->numRun[prio] = epicsAtomicGetSizeT(&mySet->numRun);
+            result->numLate[prio] = epicsAtomicGetSizeT(&mySet->numLate);
+            for (bin = 0; bin < NUM_CALLBACK_LATENCY_BINS; bin++)
+                result->histogram[prio][bin] =
+                    epicsAtomicGetSizeT(&mySet->histogram[bin]);
+        }
+        if (reset) {
+            epicsAtomicSetSizeT(&mySet->maxLatency, 0);
+            epicsAtomicSetSizeT(&mySet->numRun, 0);
+            epicsAtomicSetSizeT(&mySet->numLate, 0);
+            for (bin = 0; bin < NUM_CALLBACK_LATENCY_BINS; bin++)
+                epicsAtomicSetSizeT(&mySet->histogram[bin], 0);
+        }
+    }
+    return result ? 0 : -2;
+}
+
 void callbackQueueShow(const int reset)
 {
     callbackQueueStats stats;
-    if (callbackQueueStatus(reset, &stats) == -1) {
+    callbackLatencyStats latency;
+    if (callbackQueueStatus(reset, &stats) == -1 ||
+        callbackLatencyStatus(reset, &latency) == -1) {
         fprintf(stderr, "Callback system not initialized, yet. Please run "
             "iocInit before using this command.\n");
     } else {
-        int prio;
+        int prio, bin;
         printf("PRIORITY  HIGH-WATER MARK  ITEMS IN Q  Q SIZE  %% USED  Q OVERFLOWS\n");
         for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
             double qusage = 100.0 * stats.numUsed[prio] / stats.size;
@@ -150,11 +191,83 @@ void callbackQueueShow(const int reset)
                    stats.numUsed[prio], stats.size, qusage,
                    stats.numOverflow[prio]);
         }
+        printf("\nPRIORITY  CALLBACKS RUN  MAX LATENCY (ms)  BUDGET (ms)"
+            "  LATE\n");
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+            printf("%8s  %13lu  %16.3f  %11.3f  %4lu\n",
+                   threadNamePrefix[prio],
+                   (unsigned long) latency.numRun[prio],
+                   latency.maxLatency[prio] * 1e3,
+                   latency.budget[prio] * 1e3,
+                   (unsigned long) latency.numLate[prio]);
+        }
+        printf("\nLATENCY      <10us   <100us     <1ms    <10ms   <100ms"
+            "      <1s     <10s    >=10s\n");
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+            printf("%8s", threadNamePrefix[prio]);
+            for (bin = 0; bin < NUM_CALLBACK_LATENCY_BINS; bin++)
+                printf(" %8lu", (unsigned long) latency.histogram[prio][bin]);
+            printf("\n");
+        }
+    }
+}
+
+/* Find prio in menuPriority, -1 meaning all priorities */
+static int findPriority(const char *func, const char *prio, int *pprio)
+{
+    dbMenu *pdbMenu;
+    int i;
+
+    if (!prio || *prio == 0 || strcmp(prio, "*") == 0) {
+        *pprio = -1;
+        return 0;
+    }
+
+    if (!pdbbase) {
+        fprintf(stderr, "%s: pdbbase not set\n", func);
+        return -1;
+    }
+
+    pdbMenu = dbFindMenu(pdbbase, "menuPriority");
+    if (!pdbMenu) {
+        fprintf(stderr, "%s: No Priority menu\n", func);
+        return -1;
+    }
+
+    for (i = 0; i < pdbMenu->nChoice; i++) {
+        if (epicsStrCaseCmp(prio, pdbMenu->papChoiceValue[i]) == 0) {
+            *pprio = i;
+            return 0;
+        }
+    }
+    fprintf(stderr, "%s: Unknown priority \"%s\"\n", func, prio);
+    return -1;
+}
+
+int callbackLatencyBudget(double seconds, const char *prio)
+{
+    int i;
+
+    if (findPriority("callbackLatencyBudget", prio, &i))
+        return -1;
+    if (seconds < 0)
+        seconds = 0;
+
+    if (i < 0) {
+        for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
+            callbackQueue[i].latencyBudget = seconds;
+        }
     }
+    else {
+        callbackQueue[i].latencyBudget = seconds;
+    }
+    return 0;
 }
 
 int callbackParallelThreads(int count, const char *prio)
 {
+    int i;
+
     if (epicsAtomicGetIntT(&cbState)!=cbInit) {
         fprintf(stderr, "Callback system already initialized\n");
         return -1;
@@ -166,43 +279,65 @@ int callbackParallelThreads(int count, const char *prio)
         count = callbackParallelThreadsDefault;
     if (count < 1) count = 1;
 
-    if (!prio || *prio == 0 || strcmp(prio, "*") == 0) {
-        int i;
+    if (findPriority("callbackParallelThreads", prio, &i))
+        return -1;
 
+    if (i < 0) {
         for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
             callbackQueue[i].threadsConfigured = count;
         }
     }
     else {
-        dbMenu *pdbMenu;
-        int i;
-
-        if (!pdbbase) {
-            fprintf(stderr, "callbackParallelThreads: pdbbase not set\n");
-            return -1;
-        }
-
-        /* Find prio in menuPriority */
-        pdbMenu = dbFindMenu(pdbbase, "menuPriority");
-        if (!pdbMenu) {
-            fprintf(stderr, "callbackParallelThreads: No Priority menu\n");
-            return -1;
-        }
-
-        for (i = 0; i < pdbMenu->nChoice; i++) {
-            if (epicsStrCaseCmp(prio, pdbMenu->papChoiceValue[i]) == 0)
-                goto found;
-        }
-        fprintf(stderr, "callbackParallelThreads: "
-            "Unknown priority \"%s\"\n", prio);
-        return -1;
-
-found:
         callbackQueue[i].threadsConfigured = count;
     }
     return 0;
 }
 
+/* Account for the time a callback spent in the queue */
+static void latencyUpdate(cbQueueSet *mySet, epicsCallback *pcallback,
+    epicsUInt64 queued)
+{
+    epicsUInt64 nsec = epicsMonotonicGet() - queued;
+    epicsUInt64 usec64 = nsec / 1000u;
+    size_t usec = usec64 > (size_t) -1 ? (size_t) -1 : (size_t) usec64;
+    size_t limit = 10, max;
+    double budget = mySet->latencyBudget;
+    int bin;
+
+    for (bin = 0; bin < NUM_CALLBACK_LATENCY_BINS - 1 && usec >= limit; bin++)
+        limit *= 10;
+    epicsAtomicIncrSizeT(&mySet->histogram[bin]);
+    epicsAtomicIncrSizeT(&mySet->numRun);
+
+    max = epicsAtomicGetSizeT(&mySet->maxLatency);
+    while (usec > max) {
+        size_t prev = epicsAtomicCmpAndSwapSizeT(&mySet->maxLatency,
+            max, usec);
+
+        if (prev == max)
+            break;
+        max = prev;
+    }
+
+    if (budget <= 0 || nsec * 1e-9 <= budget) {
+        mySet->lateReported = FALSE;
+        return;
+    }
+    epicsAtomicIncrSizeT(&mySet->numLate);
+    if (mySet->lateReported)
+        return;
+
+    /* Report the start of a run of late callbacks */
+    mySet->lateReported = TRUE;
+    if (pcallback->callback == ProcessCallback && pcallback->user)
+        errlogPrintf("callbackTask: %s queue latency %.3f ms exceeds budget, "
+            "record %s\n", threadNamePrefix[mySet - callbackQueue],
+            nsec * 1e-6, ((dbCommon *) pcallback->user)->name);
+    else
+        errlogPrintf("callbackTask: %s queue latency %.3f ms exceeds budget\n",
+            threadNamePrefix[mySet - callbackQueue], nsec * 1e-6);
+}
+
 static void callbackTask(void *arg)
 {
     int prio = *(int*)arg;
@@ -221,6 +356,7 @@ static void callbackTask(void *arg)
             if(!epicsRingPointerIsEmpty(mySet->queue))
                 epicsEventMustTrigger(mySet->semWakeUp);
             mySet->queueOverflow = FALSE;
+            latencyUpdate(mySet, pcallback, pcallback->queued);
             (*pcallback->callback)(pcallback);
         }
     }
@@ -336,10 +472,17 @@ int callbackRequest(epicsCallback *pcallback)
     mySet = &callbackQueue[priority];
     if (mySet->queueOverflow) return S_db_bufFull;
 
+    pcallback->queued = epicsMonotonicGet();
     pushOK = epicsRingPointerPush(mySet->queue, pcallback);
 
     if (!pushOK) {
-        epicsInterruptContextMessage(fullMessage[priority]);
+        if (pcallback->callback == ProcessCallback && pcallback->user &&
+            !epicsInterruptIsInterruptContext())
+            errlogPrintf("callbackRequest: %s ring buffer full, "
+                "record %s not processed\n", threadNamePrefix[priority],
+                ((dbCommon *) pcallback->user)->name);
+        else
+            epicsInterruptContextMessage(fullMessage[priority]);
         mySet->queueOverflow = TRUE;
         epicsAtomicIncrIntT(&mySet->queueOverflows);
         return S_db_bufFull;
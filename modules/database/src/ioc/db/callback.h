@@ -18,7 +18,10 @@
 #ifndef INCcallbackh
 #define INCcallbackh 1
 
+#include <stddef.h>
+
 #include "shareLib.h"
+#include "epicsTypes.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +46,7 @@ typedef struct callbackPvt {
         int             priority;
         void            *user; /*for use by callback user*/
         void            *timer; /*for use by callback itself*/
+        epicsUInt64     queued; /*for use by callback itself*/
 }epicsCallback;
 
 #if !defined(EPICS_NO_CALLBACK)
@@ -58,6 +62,17 @@ typedef struct callbackQueueStats {
     int numOverflow[NUM_CALLBACK_PRIORITIES];
 } callbackQueueStats;
 
+/* Queue latency histogram bins: <10us, <100us, ... <10s, >=10s */
+#define NUM_CALLBACK_LATENCY_BINS 8
+
+typedef struct callbackLatencyStats {
+    double budget[NUM_CALLBACK_PRIORITIES];      /* seconds, 0 if none */
+    double maxLatency[NUM_CALLBACK_PRIORITIES];  /* seconds */
+    size_t numRun[NUM_CALLBACK_PRIORITIES];
+    size_t numLate[NUM_CALLBACK_PRIORITIES];
+    size_t histogram[NUM_CALLBACK_PRIORITIES][NUM_CALLBACK_LATENCY_BINS];
+} callbackLatencyStats;
+
 #define callbackSetCallback(PFUN, PCALLBACK) \
     ( (PCALLBACK)->callback = (PFUN) )
 #define callbackSetPriority(PRIORITY, PCALLBACK) \
@@ -85,6 +100,9 @@ epicsShareFunc void callbackRequestProcessCallbackDelayed(
 epicsShareFunc int callbackSetQueueSize(int size);
 epicsShareFunc int callbackQueueStatus(const int reset, callbackQueueStats *result);
 epicsShareFunc void callbackQueueShow(const int reset);
+epicsShareFunc int callbackLatencyStatus(const int reset,
+    callbackLatencyStats *result);
+epicsShareFunc int callbackLatencyBudget(double seconds, const char *prio);
 epicsShareFunc int callbackParallelThreads(int count, const char *prio);
 
 #ifdef __cplusplus
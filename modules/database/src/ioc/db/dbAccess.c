@@ -30,6 +30,7 @@
 #include "dbDefs.h"
 #include "ellLib.h"
 #include "epicsMath.h"
+#include "epicsString.h"
 #include "epicsThread.h"
 #include "epicsTime.h"
 #include "errlog.h"
@@ -761,12 +762,40 @@ long dbBufferSize(short dbr_type, long options, long no_elements)
     if (options & DBR_AL_DOUBLE)   nbytes += dbr_alDouble_size;
     return(nbytes);
 }
+/* Files queued by dbLoadRecordsParallel() */
+typedef struct pendingLoad {
+    ELLNODE node;
+    char *file;
+    char *subs;
+} pendingLoad;
+
+static ELLLIST pendingLoads = ELLLIST_INIT;
+
+static void loadRecordsResult(const char *cmd, const char *file,
+    const char *subs, int status)
+{
+    switch(status)
+    {
+    case 0:
+        if(dbLoadRecordsHook)
+            dbLoadRecordsHook(file, subs);
+        break;
+    case -2:
+        errlogPrintf("%s: failed to load '%s'\n"
+            "    Records cannot be loaded after iocInit!\n", cmd, file);
+        break;
+    default:
+        errlogPrintf("%s: failed to load '%s'\n", cmd, file);
+    }
+}
+
 int dbLoadDatabase(const char *file, const char *path, const char *subs)
 {
     if (!file) {
         printf("Usage: dbLoadDatabase \"file\", \"path\", \"subs\"\n");
         return -1;
     }
+    dbLoadRecordsWait();
     return dbReadDatabase(&pdbbase, file, path, subs);
 }
 
@@ -778,20 +807,63 @@ int dbLoadRecords(const char* file, const char* subs)
         printf("Usage: dbLoadRecords \"file\", \"subs\"\n");
         return -1;
     }
+    dbLoadRecordsWait();
     status = dbReadDatabase(&pdbbase, file, 0, subs);
-    switch(status)
-    {
-    case 0:
-        if(dbLoadRecordsHook)
-            dbLoadRecordsHook(file, subs);
-        break;
-    case -2:
-        errlogPrintf("dbLoadRecords: failed to load '%s'\n"
-            "    Records cannot be loaded after iocInit!\n", file);
-        break;
-    default:
-        errlogPrintf("dbLoadRecords: failed to load '%s'\n", file);
+    loadRecordsResult("dbLoadRecords", file, subs, status);
+    return status;
+}
+
+int dbLoadRecordsParallel(const char* file, const char* subs)
+{
+    pendingLoad *pload;
+
+    if (!file) {
+        printf("Usage: dbLoadRecordsParallel \"file\", \"subs\"\n");
+        return -1;
+    }
+    pload = dbCalloc(1, sizeof(pendingLoad));
+    pload->file = epicsStrDup(file);
+    pload->subs = subs ? epicsStrDup(subs) : NULL;
+    ellAdd(&pendingLoads, &pload->node);
+    return 0;
+}
+
+int dbLoadRecordsWait(void)
+{
+    int nfiles = ellCount(&pendingLoads);
+    const char **files, **subs;
+    pendingLoad *pload;
+    long *statuses;
+    long status;
+    int i;
+
+    if (!nfiles)
+        return 0;
+
+    files = dbCalloc(nfiles, sizeof(char *));
+    subs = dbCalloc(nfiles, sizeof(char *));
+    statuses = dbCalloc(nfiles, sizeof(long));
+    for (i = 0, pload = (pendingLoad *)ellFirst(&pendingLoads); pload;
+         i++, pload = (pendingLoad *)ellNext(&pload->node)) {
+        files[i] = pload->file;
+        subs[i] = pload->subs;
+    }
+
+    status = dbReadDatabaseParallel(&pdbbase, nfiles, files, subs, NULL,
+        statuses);
+    for (i = 0; i < nfiles; i++) {
+        loadRecordsResult("dbLoadRecordsParallel", files[i], subs[i],
+            status == -2 ? -2 : statuses[i]);
+    }
+
+    while ((pload = (pendingLoad *)ellGet(&pendingLoads))) {
+        free(pload->file);
+        free(pload->subs);
+        free(pload);
     }
+    free(files);
+    free(subs);
+    free(statuses);
     return status;
 }
 
@@ -269,6 +269,9 @@ epicsShareFunc int  dbLoadDatabase(
     const char *filename, const char *path, const char *substitutions);
 epicsShareFunc int dbLoadRecords(
     const char* filename, const char* substitutions);
+epicsShareFunc int dbLoadRecordsParallel(
+    const char* filename, const char* substitutions);
+epicsShareFunc int dbLoadRecordsWait(void);
 
 #ifdef __cplusplus
 }
@@ -49,6 +49,7 @@
 #include "dbLink.h"
 #include "dbLock.h"
 #include "dbScan.h"
+#include "epicsExport.h"
 #include "link.h"
 #include "recGbl.h"
 #include "recSup.h"
@@ -62,17 +63,18 @@
 extern void dbServiceIOInit();
 extern int dbServiceIsolate;
 
-static ELLLIST workList = ELLLIST_INIT;    /* Work list for dbCaTask */
-static epicsMutexId workListLock; /*Mutual exclusions semaphores for workList*/
-static epicsEventId workListEvent; /*wakeup event for dbCaTask*/
-static int removesOutstanding = 0;
+/* Number of dbCaTask threads, takes effect at the next iocInit */
+int dbCaLinkThreads = 1;
+epicsExportAddress(int, dbCaLinkThreads);
+
+dbCaShard *dbCaShards;  /* One per dbCaTask */
+int dbCaNShards;
 #define removesOutstandingWarning 10000
 
 static volatile enum dbCaCtl_t {
     ctlInit, ctlRun, ctlPause, ctlExit
 } dbCaCtl;
 static epicsEventId startStopEvent;
-static epicsThreadId dbCaWorker;
 
 struct ca_client_context * dbCaClientContext;
 
@@ -93,7 +95,9 @@ static int dbca_chan_count;
  *  dbScanLock -> caLink.lock -> workListLock
  *
  * workListLock:
- *   Guards access to workList.
+ *   Guards access to the workList of one dbCaShard.  Each link is
+ *   assigned to a shard when it is added, by a hash of the target
+ *   record name, and all its actions are run by that shard's dbCaTask.
  *
  * dbScanLock:
  *   All dbCa* functions operating on a single link may only be called when
@@ -110,9 +114,16 @@ static int dbca_chan_count;
  *
  * caLink.lock:
  *   Guards the caLink structure (but not the struct DBLINK)
+ *   Also serializes writers of the caLink.value[] snapshot, which
+ *   dbCaGetLink() reads without locking (see caLinkReadValue()).
+ *   The cached scalar converter in pv_link.getCvt and caLink.getCvtType
+ *   are guarded by dbScanLock like the rest of the DBLINK.
  *
  * The dbCaTask only locks caLink, and must not lock the record (a violation of lock order).
  *
+ * All dbCaTask threads share the preemptive CA context created by the
+ * first one, which is also the last to exit.
+ *
  * During link modification or IOC shutdown the pca->plink pointer (guarded by caLink.lock)
  * is used as a flag to indicate that a link is no longer active.
  *
@@ -131,9 +142,10 @@ static int dbca_chan_count;
 
 static void addAction(caLink *pca, short link_action)
 {
+    dbCaShard *shard = pca->shard;
     int callAdd;
 
-    epicsMutexMustLock(workListLock);
+    epicsMutexMustLock(shard->workListLock);
     callAdd = (pca->link_action == 0);
     if (pca->link_action & CA_CLEAR_CHANNEL) {
         errlogPrintf("dbCa::addAction %d with CA_CLEAR_CHANNEL set\n",
@@ -142,22 +154,37 @@ static void addAction(caLink *pca, short link_action)
         link_action = 0;
     }
     if (link_action & CA_CLEAR_CHANNEL) {
-        if (++removesOutstanding >= removesOutstandingWarning) {
+        if (++shard->removesOutstanding >= removesOutstandingWarning) {
             errlogPrintf("dbCa::addAction pausing, %d channels to clear\n",
-                removesOutstanding);
+                shard->removesOutstanding);
         }
-        while (removesOutstanding >= removesOutstandingWarning) {
-            epicsMutexUnlock(workListLock);
+        while (shard->removesOutstanding >= removesOutstandingWarning) {
+            epicsMutexUnlock(shard->workListLock);
             epicsThreadSleep(1.0);
-            epicsMutexMustLock(workListLock);
+            epicsMutexMustLock(shard->workListLock);
         }
     }
     pca->link_action |= link_action;
+    if (callAdd) {
+        ellAdd(&shard->workList, &pca->node);
+        if (ellCount(&shard->workList) > shard->maxBacklog)
+            shard->maxBacklog = ellCount(&shard->workList);
+    }
+    epicsMutexUnlock(shard->workListLock);
     if (callAdd)
-        ellAdd(&workList, &pca->node);
-    epicsMutexUnlock(workListLock);
-    if (callAdd)
-        epicsEventSignal(workListEvent);
+        epicsEventSignal(shard->workListEvent);
+}
+
+/* Links to the same record share a shard, so actions on one target
+ * are still run in the order they were requested.
+ */
+static dbCaShard* shardForPV(const char *pvname)
+{
+    size_t len = strcspn(pvname, ".");
+
+    if (dbCaNShards <= 1)
+        return dbCaShards;
+    return &dbCaShards[epicsMemHash(pvname, len, 0) % dbCaNShards];
 }
 
 static void caLinkInc(caLink *pca)
@@ -179,8 +206,9 @@ static void caLinkDec(caLink *pca)
 
     if (pca->chid) {
         ca_clear_channel(pca->chid);
-        --dbca_chan_count;
+        epicsAtomicDecrIntT(&dbca_chan_count);
     }
+    epicsAtomicDecrIntT(&pca->shard->nLinks);
     callback = pca->putCallback;
     if (callback) {
         userPvt = pca->putUserPvt;
@@ -197,10 +225,41 @@ static void caLinkDec(caLink *pca)
     if (callback) callback(userPvt);
 }
 
-/* Block until worker thread has processed all previously queued actions.
- * Does not prevent additional actions from being queued.
+/* Publish the current value and alarm for the lock-free scalar path.
+ * Must be called with pca->lock held.
  */
-void dbCaSync(void)
+static void caLinkPublish(caLink *pca)
+{
+    int seq = pca->valueSeq + 1;
+    caLinkValue *pval = &pca->value[seq & 1];
+
+    pval->valid = pca->isConnected && pca->hasReadAccess &&
+        pca->gotInNative && pca->usedelements >= 1 && pca->pgetNative;
+    pval->dbrType = pca->dbrType;
+    pval->sevr = pca->sevr;
+    pval->stat = pca->stat;
+    if (pval->valid)
+        memcpy(pval->value.bytes, pca->pgetNative, pca->elementSize);
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetIntT(&pca->valueSeq, seq);
+}
+
+/* Copy the current snapshot.  Readers never wait for a writer,
+ * they only retry if a new value was published while copying.
+ */
+static void caLinkReadValue(caLink *pca, caLinkValue *pval)
+{
+    int seq;
+
+    do {
+        seq = epicsAtomicGetIntT(&pca->valueSeq);
+        epicsAtomicReadMemoryBarrier();
+        *pval = pca->value[seq & 1];
+        epicsAtomicReadMemoryBarrier();
+    } while (seq != epicsAtomicGetIntT(&pca->valueSeq));
+}
+
+static void dbCaSyncShard(dbCaShard *shard)
 {
     epicsEventId wake;
     caLink templink;
@@ -211,6 +270,7 @@ void dbCaSync(void)
      */
     memset(&templink, 0, sizeof(templink));
     templink.refcount = 1;
+    templink.shard = shard;
 
     wake = epicsEventMustCreate(epicsEventEmpty);
     templink.lock = epicsMutexMustCreate();
@@ -224,8 +284,8 @@ void dbCaSync(void)
      * we cycle through workListLock to ensure worker call to
      * epicsEventMustTrigger() returns before we destroy the event.
      */
-    epicsMutexMustLock(workListLock);
-    epicsMutexUnlock(workListLock);
+    epicsMutexMustLock(shard->workListLock);
+    epicsMutexUnlock(shard->workListLock);
 
     assert(templink.refcount==1);
 
@@ -233,6 +293,17 @@ void dbCaSync(void)
     epicsEventDestroy(wake);
 }
 
+/* Block until worker threads have processed all previously queued actions.
+ * Does not prevent additional actions from being queued.
+ */
+void dbCaSync(void)
+{
+    int i;
+
+    for (i = 0; i < dbCaNShards; i++)
+        dbCaSyncShard(&dbCaShards[i]);
+}
+
 epicsShareFunc unsigned long dbCaGetUpdateCount(struct link *plink)
 {
     caLink *pca = (caLink *)plink->value.pv_link.pvt;
@@ -256,20 +327,31 @@ void dbCaCallbackProcess(void *userPvt)
     dbLinkAsyncComplete(plink);
 }
 
+static void signalAllShards(void)
+{
+    int i;
+
+    for (i = 0; i < dbCaNShards; i++)
+        epicsEventSignal(dbCaShards[i].workListEvent);
+}
+
 void dbCaShutdown(void)
 {
     enum dbCaCtl_t cur = dbCaCtl;
     assert(cur == ctlRun || cur == ctlPause);
     dbCaCtl = ctlExit;
-    epicsEventSignal(workListEvent);
+    signalAllShards();
+    /* The first worker joins the others before it signals */
     epicsEventMustWait(startStopEvent);
-    if(dbCaWorker)
-        epicsThreadMustJoin(dbCaWorker);
+    if(dbCaShards[0].worker)
+        epicsThreadMustJoin(dbCaShards[0].worker);
 }
 
 static void dbCaLinkInitImpl(int isolate)
 {
     epicsThreadOpts opts = EPICS_THREAD_OPTS_INIT;
+    int nShards = dbCaLinkThreads > 0 ? dbCaLinkThreads : 1;
+    int i;
 
     opts.stackSize = epicsThreadGetStackSize(epicsThreadStackBig);
     opts.priority = epicsThreadPriorityMedium;
@@ -278,18 +360,42 @@ static void dbCaLinkInitImpl(int isolate)
     dbServiceIsolate = isolate;
     dbServiceIOInit();
 
-    if (!workListLock)
-        workListLock = epicsMutexMustCreate();
-    if (!workListEvent)
-        workListEvent = epicsEventMustCreate(epicsEventEmpty);
+    if (dbCaNShards != nShards) {
+        /* No links exist between iocShutdown and iocInit */
+        for (i = 0; i < dbCaNShards; i++) {
+            epicsMutexDestroy(dbCaShards[i].workListLock);
+            epicsEventDestroy(dbCaShards[i].workListEvent);
+        }
+        free(dbCaShards);
+        dbCaShards = dbCalloc(nShards, sizeof(dbCaShard));
+        for (i = 0; i < nShards; i++) {
+            dbCaShard *shard = &dbCaShards[i];
+
+            shard->index = i;
+            ellInit(&shard->workList);
+            shard->workListLock = epicsMutexMustCreate();
+            shard->workListEvent = epicsEventMustCreate(epicsEventEmpty);
+        }
+        dbCaNShards = nShards;
+    }
 
     if(!startStopEvent)
         startStopEvent = epicsEventMustCreate(epicsEventEmpty);
     dbCaCtl = ctlPause;
 
-    dbCaWorker = epicsThreadCreateOpt("dbCaLink", dbCaTask, NULL, &opts);
-    /* wait for worker to startup and initialize dbCaClientContext */
-    epicsEventMustWait(startStopEvent);
+    for (i = 0; i < dbCaNShards; i++) {
+        char name[32];
+
+        if (i)
+            sprintf(name, "dbCaLink-%d", i);
+        else
+            strcpy(name, "dbCaLink");
+        dbCaShards[i].worker = epicsThreadCreateOpt(name, dbCaTask,
+            &dbCaShards[i], &opts);
+        /* wait for worker to startup, the first initializes
+         * dbCaClientContext which the others attach to */
+        epicsEventMustWait(startStopEvent);
+    }
 }
 
 void dbCaLinkInitIsolated(void)
@@ -306,7 +412,7 @@ void dbCaRun(void)
 {
     if (dbCaCtl == ctlPause) {
         dbCaCtl = ctlRun;
-        epicsEventSignal(workListEvent);
+        signalAllShards();
     }
 }
 
@@ -314,7 +420,7 @@ void dbCaPause(void)
 {
     if (dbCaCtl == ctlRun) {
         dbCaCtl = ctlPause;
-        epicsEventSignal(workListEvent);
+        signalAllShards();
     }
 }
 
@@ -330,6 +436,8 @@ void dbCaAddLinkCallback(struct link *plink,
     pca->lock = epicsMutexMustCreate();
     pca->plink = plink;
     pca->pvname = epicsStrDup(plink->value.pv_link.pvname);
+    pca->shard = shardForPV(pca->pvname);
+    epicsAtomicIncrIntT(&pca->shard->nLinks);
     pca->connect = connect;
     pca->monitor = monitor;
     pca->userPvt = userPvt;
@@ -338,6 +446,8 @@ void dbCaAddLinkCallback(struct link *plink,
     plink->lset = &dbCa_lset;
     plink->type = CA_LINK;
     plink->value.pv_link.pvt = pca;
+    plink->value.pv_link.getCvt = 0;
+    plink->value.pv_link.lastGetdbrType = 0;
     addAction(pca, CA_CONNECT);
     epicsMutexUnlock(pca->lock);
 }
@@ -357,6 +467,8 @@ void dbCaRemoveLink(struct dbLocker *locker, struct link *plink)
     pca->plink = 0;
     plink->value.pv_link.pvt = 0;
     plink->value.pv_link.pvlMask = 0;
+    plink->value.pv_link.getCvt = 0;
+    plink->value.pv_link.lastGetdbrType = 0;
     plink->type = PV_LINK;
     plink->lset = NULL;
     /* Unlock before addAction or dbCaTask might free first */
@@ -373,6 +485,34 @@ long dbCaGetLink(struct link *plink, short dbrType, void *pdest,
     int    newType;
 
     assert(pca);
+    if (!nelements || *nelements == 1) {
+        caLinkValue val;
+
+        caLinkReadValue(pca, &val);
+        /* dbrType is a dbFldTypes.h request type, DBR_ENUM here is CA's */
+        if (val.valid && dbrType >= 0 && dbrType <= newDBR_ENUM &&
+            !(val.dbrType == DBR_ENUM &&
+              dbDBRnewToDBRold[dbrType] == DBR_STRING)) {
+            struct pv_link *ppv_link = &plink->value.pv_link;
+
+            /* shortcut: scalar with known conversion */
+            newType = dbDBRoldToDBFnew[val.dbrType];
+            if (!ppv_link->getCvt || ppv_link->lastGetdbrType != dbrType ||
+                pca->getCvtType != newType) {
+                ppv_link->getCvt = dbFastGetConvertRoutine[newType][dbrType];
+                ppv_link->lastGetdbrType = dbrType;
+                pca->getCvtType = newType;
+            }
+            status = ppv_link->getCvt(val.value.bytes, pdest, 0);
+            if (nelements) *nelements = 1;
+            pca->nFastGet++;
+            if (!status)
+                recGblInheritSevr(ppv_link->pvlMask & pvlOptMsMode,
+                    plink->precord, val.stat, val.sevr);
+            return status;
+        }
+    }
+
     epicsMutexMustLock(pca->lock);
     assert(pca->plink);
     if (!pca->isConnected || !pca->hasReadAccess) {
@@ -855,6 +995,7 @@ static void connectionCallback(struct connection_handler_args arg)
         link_action |= CA_GET_ATTRIBUTES;
     }
 done:
+    if (plink) caLinkPublish(pca);
     if (link_action) addAction(pca, link_action);
     epicsMutexUnlock(pca->lock);
 }
@@ -930,6 +1071,7 @@ static void eventCallback(struct event_handler_args arg)
             ((ppv_link->pvlMask & pvlOptCPP) && precord->scan == 0))
         scanLinkOnce(precord, pca);
     }
+    caLinkPublish(pca);
 done:
     epicsMutexUnlock(pca->lock);
     if (monitor) monitor(userPvt);
@@ -995,6 +1137,7 @@ static void accessRightsCallback(struct access_rights_handler_args arg)
     if (!plink) goto done;
     pca->hasReadAccess = ca_read_access(arg.chid);
     pca->hasWriteAccess = ca_write_access(arg.chid);
+    caLinkPublish(pca);
     if (pca->hasReadAccess && pca->hasWriteAccess) goto done;
     ppv_link = &plink->value.pv_link;
     precord = plink->precord;
@@ -1059,27 +1202,37 @@ static void getAttribEventCallback(struct event_handler_args arg)
 
 static void dbCaTask(void *arg)
 {
+    dbCaShard *shard = (dbCaShard *)arg;
+    int i;
+
     taskwdInsert(0, NULL, NULL);
-    SEVCHK(ca_context_create(ca_enable_preemptive_callback),
-        "dbCaTask calling ca_context_create");
-    dbCaClientContext = ca_current_context ();
-    SEVCHK(ca_add_exception_event(exceptionCallback,NULL),
-        "ca_add_exception_event");
+    if (shard->index == 0) {
+        SEVCHK(ca_context_create(ca_enable_preemptive_callback),
+            "dbCaTask calling ca_context_create");
+        dbCaClientContext = ca_current_context ();
+        SEVCHK(ca_add_exception_event(exceptionCallback,NULL),
+            "ca_add_exception_event");
+    } else {
+        SEVCHK(ca_attach_context(dbCaClientContext),
+            "dbCaTask calling ca_attach_context");
+    }
     epicsEventSignal(startStopEvent);
 
     /* channel access event loop */
     while (TRUE){
+        unsigned long nPut = shard->nPut;
+
         do {
-            epicsEventMustWait(workListEvent);
+            epicsEventMustWait(shard->workListEvent);
         } while (dbCaCtl == ctlPause);
         while (TRUE) { /* process all requests in workList*/
             caLink *pca;
             short  link_action;
             int    status;
 
-            epicsMutexMustLock(workListLock);
-            if (!(pca = (caLink *)ellGet(&workList))){  /* Take off list head */
-                epicsMutexUnlock(workListLock);
+            epicsMutexMustLock(shard->workListLock);
+            if (!(pca = (caLink *)ellGet(&shard->workList))){  /* Take off list head */
+                epicsMutexUnlock(shard->workListLock);
                 if (dbCaCtl == ctlExit) goto shutdown;
                 break; /* workList is empty */
             }
@@ -1087,8 +1240,8 @@ static void dbCaTask(void *arg)
             if (link_action&CA_SYNC)
                 epicsEventMustTrigger((epicsEventId)pca->userPvt); /* dbCaSync() requires workListLock to be held here */
             pca->link_action = 0;
-            if (link_action & CA_CLEAR_CHANNEL) --removesOutstanding;
-            epicsMutexUnlock(workListLock);         /* Give back immediately */
+            if (link_action & CA_CLEAR_CHANNEL) --shard->removesOutstanding;
+            epicsMutexUnlock(shard->workListLock);  /* Give back immediately */
             if (link_action&CA_SYNC)
                 continue;
             if (link_action & CA_CLEAR_CHANNEL) {   /* This must be first */
@@ -1106,7 +1259,7 @@ static void dbCaTask(void *arg)
                     printLinks(pca);
                     continue;
                 }
-                dbca_chan_count++;
+                epicsAtomicIncrIntT(&dbca_chan_count);
                 status = ca_replace_access_rights_event(pca->chid,
                     accessRightsCallback);
                 if (status != ECA_NORMAL) {
@@ -1139,6 +1292,7 @@ static void dbCaTask(void *arg)
                 epicsMutexMustLock(pca->lock);
                 if (status == ECA_NORMAL) pca->newOutNative = FALSE;
                 epicsMutexUnlock(pca->lock);
+                if (status == ECA_NORMAL) shard->nPut++;
             }
             if (link_action & CA_WRITE_STRING) {
                 assert(pca->pputString);
@@ -1162,6 +1316,7 @@ static void dbCaTask(void *arg)
                 epicsMutexMustLock(pca->lock);
                 if (status == ECA_NORMAL) pca->newOutString = FALSE;
                 epicsMutexUnlock(pca->lock);
+                if (status == ECA_NORMAL) shard->nPut++;
             }
             /*CA_GET_ATTRIBUTES before CA_MONITOR so that attributes available
              * before the first monitor callback                              */
@@ -1206,13 +1361,24 @@ static void dbCaTask(void *arg)
                 }
             }
         }
+        /* All puts queued during this pass go out together */
         SEVCHK(ca_flush_io(), "dbCaTask");
+        if (shard->nPut != nPut)
+            shard->nPutFlush++;
     }
 shutdown:
     taskwdRemove(0);
-    if (dbca_chan_count == 0)
+    if (shard->index != 0) {
+        ca_detach_context();
+        return;
+    }
+    /* The other workers share our context */
+    for (i = 1; i < dbCaNShards; i++)
+        epicsThreadMustJoin(dbCaShards[i].worker);
+    if (epicsAtomicGetIntT(&dbca_chan_count) == 0)
         ca_context_destroy();
     else
-        fprintf(stderr, "dbCa: chan_count = %d at shutdown\n", dbca_chan_count);
+        fprintf(stderr, "dbCa: chan_count = %d at shutdown\n",
+            epicsAtomicGetIntT(&dbca_chan_count));
     epicsEventSignal(startStopEvent);
 }
@@ -46,6 +46,7 @@ epicsShareFunc long dbCaPutLink(struct link *plink,short dbrType,
     const void *pbuffer,long nRequest);
 
 extern struct ca_client_context * dbCaClientContext;
+epicsShareExtern int dbCaLinkThreads;
 
 #ifdef EPICS_DBCA_PRIVATE_API
 epicsShareFunc void dbCaSync(void);
@@ -18,7 +18,9 @@
 
 #include "dbCa.h"
 #include "ellLib.h"
+#include "epicsEvent.h"
 #include "epicsMutex.h"
+#include "epicsThread.h"
 #include "epicsTypes.h"
 #include "link.h"
 
@@ -35,9 +37,45 @@
 #define CA_PUT          0x1
 #define CA_PUT_CALLBACK 0x2
 
+/* Snapshot of the first element of the most recent native monitor
+ * update, published by the CA callbacks and read without caLink.lock
+ * by the scalar fast path of dbCaGetLink().
+ */
+typedef struct caLinkValue
+{
+    char            valid;      /* connected, readable and has data */
+    short           dbrType;    /* native DBR type of the value */
+    epicsEnum16     sevr;
+    epicsEnum16     stat;
+    union {
+        epicsFloat64    align;
+        char            bytes[MAX_STRING_SIZE];
+    } value;
+}caLinkValue;
+
+/* One dbCaTask thread, serving the links whose target hashes to it */
+typedef struct dbCaShard
+{
+    int             index;
+    ELLLIST         workList;       /* Work list for dbCaTask */
+    epicsMutexId    workListLock;   /* Guards workList */
+    epicsEventId    workListEvent;  /* wakeup event for dbCaTask */
+    epicsThreadId   worker;
+    int             removesOutstanding;
+    /* The following are for dbcar */
+    int             nLinks;         /* links assigned to this shard */
+    int             maxBacklog;     /* high-water mark of workList */
+    unsigned long   nPut;           /* puts sent */
+    unsigned long   nPutFlush;      /* ca_flush_io() calls sending puts */
+}dbCaShard;
+
+extern dbCaShard *dbCaShards;
+extern int dbCaNShards;
+
 typedef struct caLink
 {
     ELLNODE         node;
+    dbCaShard       *shard;
     int             refcount;
     epicsMutexId    lock;
     struct link     *plink;
@@ -90,6 +128,14 @@ typedef struct caLink
     char            newOutNative;
     char            newOutString;
     unsigned char scanningOnce;
+    /* The following are for lock-free scalar reads.
+     * valueSeq is incremented after each write to value[],
+     * value[valueSeq & 1] is the current snapshot.
+     */
+    int             valueSeq;
+    caLinkValue     value[2];
+    short           getCvtType; /* DBF type of pv_link.getCvt source */
+    unsigned long   nFastGet;   /* gets served without locking, under dbScanLock */
     /* The following are for dbcar*/
     unsigned long   nDisconnect;
     unsigned long   nNoWrite; /*only modified by dbCaPutLink*/
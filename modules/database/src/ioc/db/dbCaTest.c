@@ -157,6 +157,23 @@ done:
            nDisconnect, nNoWrite);
     dbFinishEntry(pdbentry);
 
+    if (level > 0 || dbCaNShards > 1) {
+        for (j = 0; j < dbCaNShards; j++) {
+            dbCaShard *shard = &dbCaShards[j];
+            int backlog;
+
+            epicsMutexMustLock(shard->workListLock);
+            backlog = ellCount(&shard->workList);
+            epicsMutexUnlock(shard->workListLock);
+            printf("    dbCaLink worker %d: %d links, backlog %d (max %d)\n",
+                j, shard->nLinks, backlog, shard->maxBacklog);
+            printf("        %lu puts in %lu flushes (%.1f puts/flush)\n",
+                shard->nPut, shard->nPutFlush, shard->nPutFlush ?
+                (double)shard->nPut / shard->nPutFlush : 0.0);
+        }
+        printf("\n");
+    }
+
     if ( level > 2  && dbCaClientContext != 0 ) {
         ca_context_status ( dbCaClientContext, level - 2 );
     }
@@ -61,6 +61,27 @@ static void copyNoConvert(const void *pfrom,
 #define COPYNOCONVERT(N, FROM, TO, NREQ, NO_ELEM, OFFSET) \
     copyNoConvert(FROM, TO, (N)*(NREQ), (N)*(NO_ELEM), (N)*(OFFSET))
 
+/* As copyNoConvert, but the offset applies to the destination */
+static void putNoConvert(const void *pfrom,
+    void *pto, long nRequest, long no_bytes, long offset)
+{
+    void *pto_offset = (char *) pto + offset;
+
+    if (offset > 0 && offset < no_bytes && offset + nRequest > no_bytes) {
+        const size_t N = no_bytes - offset;
+        const void *pfrom_N = (const char *) pfrom + N;
+
+        /* copy with wrap */
+        memmove(pto_offset, pfrom,   N);
+        memmove(pto,        pfrom_N, nRequest - N);
+    } else {
+        /* no wrap, just copy */
+        memmove(pto_offset, pfrom, nRequest);
+    }
+}
+#define PUTNOCONVERT(N, FROM, TO, NREQ, NO_ELEM, OFFSET) \
+    putNoConvert(FROM, TO, (N)*(NREQ), (N)*(NO_ELEM), (N)*(OFFSET))
+
 #define GET(typea, typeb) (const dbAddr *paddr, \
     void *pto, long nRequest, long no_elements, long offset) \
 { \
@@ -123,7 +144,7 @@ static void copyNoConvert(const void *pfrom,
         *pdst = (typeb) *psrc; \
         return 0; \
     } \
-    COPYNOCONVERT(sizeof(typeb), pfrom, paddr->pfield, nRequest, no_elements, offset); \
+    PUTNOCONVERT(sizeof(typeb), pfrom, paddr->pfield, nRequest, no_elements, offset); \
     return 0; \
 }
 
@@ -230,6 +230,65 @@ static long dbDbGetValue(struct link *plink, short dbrType, void *pbuffer,
     return status;
 }
 
+/* Like dbDbGetValue, but if the target field already holds dbrType data
+ * and there are no filters, point *ppdata at the field instead of copying
+ * it into pbuffer.  The link target is in the caller's lock set, so the
+ * data stays valid until the caller's record is unlocked.  An array that
+ * wraps around the end of its buffer is copied into pbuffer.
+ * Returns S_db_badDbrtype before doing anything if the field can't be
+ * referenced at all.
+ */
+long dbDbGetValueRef(struct link *plink, short dbrType, void *pbuffer,
+        void **ppdata, long *pnRequest)
+{
+    struct pv_link *ppv_link = &plink->value.pv_link;
+    dbChannel *chan = linkChannel(plink);
+    dbCommon *precord = plink->precord;
+    long capacity = dbChannelElements(chan);
+    long nElements = capacity;
+    long offset = 0;
+    void *pfield;
+    long status;
+
+    if (dbrType < 0 || dbrType > DBR_ENUM ||
+        dbChannelFinalFieldType(chan) != dbrType ||
+        (dbrType == DBR_STRING &&
+            dbChannelFieldSize(chan) != MAX_STRING_SIZE) ||
+        dbChannelSpecial(chan) == SPC_ATTRIBUTE ||
+        ellCount(&chan->filters))
+        return S_db_badDbrtype;
+
+    /* scan passive records if link is process passive  */
+    if (ppv_link->pvlMask & pvlOptPP) {
+        status = dbScanPassive(precord, dbChannelRecord(chan));
+        if (status)
+            return status;
+    }
+
+    pfield = dbChannelField(chan);
+    dbChannelGetArrayInfo(chan, &pfield, &nElements, &offset);
+    if (capacity > 0)
+        offset %= capacity;
+    if (nElements > *pnRequest)
+        nElements = *pnRequest;
+
+    if (offset + nElements <= capacity) {
+        *ppdata = (char *) pfield + offset * dbChannelFieldSize(chan);
+        *pnRequest = nElements;
+    }
+    else {
+        status = dbChannelGet(chan, dbrType, pbuffer, NULL, pnRequest, NULL);
+        if (status)
+            return status;
+        *ppdata = pbuffer;
+    }
+
+    if (precord != dbChannelRecord(chan))
+        recGblInheritSevr(ppv_link->pvlMask & pvlOptMsMode, precord,
+            dbChannelRecord(chan)->stat, dbChannelRecord(chan)->sevr);
+    return 0;
+}
+
 static long dbDbGetControlLimits(const struct link *plink, double *low,
         double *high)
 {
@@ -28,6 +28,8 @@ struct dbLocker;
 epicsShareFunc long dbDbInitLink(struct link *plink, short dbfType);
 epicsShareFunc void dbDbAddLink(struct dbLocker *locker, struct link *plink,
     short dbfType, dbChannel *ptarget);
+epicsShareFunc long dbDbGetValueRef(struct link *plink, short dbrType,
+    void *pbuffer, void **ppdata, long *pnRequest);
 
 #ifdef __cplusplus
 }
@@ -28,6 +28,7 @@
 #include "cantProceed.h"
 #include "dbDefs.h"
 #include "epicsAssert.h"
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
 #include "epicsMutex.h"
 #include "epicsThread.h"
@@ -494,6 +495,7 @@ void db_event_enable (dbEventSubscription event)
     if ( ! pevent->enabled ) {
         ellAdd (&precord->mlis, &pevent->node);
         pevent->enabled = TRUE;
+        epicsAtomicIncrIntT (&pevent->chan->monitors);
     }
     UNLOCKREC (precord);
 }
@@ -510,6 +512,7 @@ void db_event_disable (dbEventSubscription event)
     if ( pevent->enabled ) {
         ellDelete(&precord->mlis, &pevent->node);
         pevent->enabled = FALSE;
+        epicsAtomicDecrIntT (&pevent->chan->monitors);
     }
     UNLOCKREC (precord);
 }
@@ -716,6 +719,7 @@ db_field_log* db_create_event_log (struct evSubscrip *pevent)
     db_field_log *pLog = db_create_field_log(pevent->chan, pevent->useValque);
     if (pLog) {
         pLog->ctx  = dbfl_context_event;
+        pLog->mask = pevent->select;
     }
     return pLog;
 }
@@ -851,6 +855,7 @@ unsigned int    caEventMask
         if ( (dbChannelField(pevent->chan) == (void *)pField || pField==NULL) &&
             (caEventMask & pevent->select)) {
             db_field_log *pLog = db_create_event_log(pevent);
+            if (pLog) pLog->mask = caEventMask;
             pLog = dbChannelRunPreChain(pevent->chan, pLog);
             if (pLog) db_queue_event_log(pevent, pLog);
         }
@@ -879,6 +884,81 @@ void db_post_single_event (dbEventSubscription event)
     dbScanUnlock (prec);
 }
 
+static void db_free_log_copy (db_field_log *pLog)
+{
+    free(pLog->u.r.field);
+}
+
+/*
+ *  DB_COPY_FIELD_LOG()
+ *
+ *  Duplicate a field log, including the field data if the field log
+ *  owns it.  A reference to the record's own data is shared.
+ */
+static db_field_log* db_copy_field_log (const db_field_log *pLog)
+{
+    db_field_log *pCopy = (db_field_log *) freeListMalloc(dbevFieldLogFreeList);
+
+    if (!pCopy)
+        return NULL;
+    *pCopy = *pLog;
+    if (pLog->type == dbfl_type_ref && pLog->u.r.dtor) {
+        size_t size = pLog->no_elements * pLog->field_size;
+
+        pCopy->u.r.field = malloc(size);
+        if (!pCopy->u.r.field) {
+            freeListFree(dbevFieldLogFreeList, pCopy);
+            return NULL;
+        }
+        memcpy(pCopy->u.r.field, pLog->u.r.field, size);
+        pCopy->u.r.dtor = db_free_log_copy;
+        pCopy->u.r.pvt = NULL;
+    }
+    return pCopy;
+}
+
+/*
+ *  DB_POST_CHANNEL_LOG()
+ *
+ *  Queue a field log that has already been through the channel's
+ *  pre-chain, e.g. an update a filter held back, to every monitor on
+ *  that channel which selects one of the events in its mask.  Each
+ *  monitor after the first gets a copy.  The field log is deleted if
+ *  there is no such monitor.  Only takes the record's monitor list lock,
+ *  so it may be called without the scan lock.
+ */
+int db_post_channel_log (struct dbChannel *chan, db_field_log *pLog)
+{
+    struct dbCommon * const prec = dbChannelRecord(chan);
+    struct evSubscrip *pevent;
+    struct evSubscrip *pfirst = NULL;
+
+    LOCKREC (prec);
+
+    for (pevent = (struct evSubscrip *) prec->mlis.node.next;
+        pevent; pevent = (struct evSubscrip *) pevent->node.next) {
+        db_field_log *pCopy;
+
+        if (pevent->chan != chan || !(pevent->select & pLog->mask))
+            continue;
+        if (!pfirst) {
+            pfirst = pevent;
+            continue;
+        }
+        pCopy = db_copy_field_log(pLog);
+        if (pCopy) db_queue_event_log(pevent, pCopy);
+    }
+    if (pfirst) db_queue_event_log(pfirst, pLog);
+
+    UNLOCKREC (prec);
+
+    if (!pfirst) {
+        db_delete_field_log(pLog);
+        return DB_EVENT_ERROR;
+    }
+    return DB_EVENT_OK;
+}
+
 /*
  * EVENT_READ()
  */
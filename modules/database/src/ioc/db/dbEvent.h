@@ -78,6 +78,8 @@ epicsShareFunc dbEventSubscription db_add_event (
     EVENTFUNC *user_sub, void *user_arg, unsigned select);
 epicsShareFunc void db_cancel_event (dbEventSubscription es);
 epicsShareFunc void db_post_single_event (dbEventSubscription es);
+epicsShareFunc int db_post_channel_log (
+    struct dbChannel *chan, struct db_field_log *pfl);
 epicsShareFunc void db_event_enable (dbEventSubscription es);
 epicsShareFunc void db_event_disable (dbEventSubscription es);
 
@@ -53,6 +53,28 @@ static void dbLoadRecordsCallFunc(const iocshArgBuf *args)
     iocshSetError(dbLoadRecords(args[0].sval,args[1].sval));
 }
 
+/* dbLoadRecordsParallel */
+static const iocshFuncDef dbLoadRecordsParallelFuncDef = {
+    "dbLoadRecordsParallel",2,dbLoadRecordsArgs,
+    "Queue a file to be loaded like dbLoadRecords.\n"
+    "Queued files are read and macro-expanded concurrently, then\n"
+    "their records are created in the order they were queued.\n"
+    "This happens at the next dbLoadRecordsWait, dbLoadRecords,\n"
+    "dbLoadDatabase or iocInit.\n"};
+static void dbLoadRecordsParallelCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbLoadRecordsParallel(args[0].sval,args[1].sval));
+}
+
+/* dbLoadRecordsWait */
+static const iocshFuncDef dbLoadRecordsWaitFuncDef = {
+    "dbLoadRecordsWait",0,0,
+    "Load all files queued by dbLoadRecordsParallel.\n"};
+static void dbLoadRecordsWaitCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbLoadRecordsWait());
+}
+
 /* dbb */
 static const iocshArg dbbArg0 = { "record name",iocshArgString};
 static const iocshArg * const dbbArgs[1] = {&dbbArg0};
@@ -365,6 +387,18 @@ static const iocshFuncDef scanpplFuncDef = {"scanppl",1,scanpplArgs,
 static void scanpplCallFunc(const iocshArgBuf *args)
 { scanppl(args[0].dval);}
 
+/* scanPeriodicShow */
+static const iocshArg scanPeriodicShowArg0 = { "reset",iocshArgInt};
+static const iocshArg * const scanPeriodicShowArgs[1] =
+    {&scanPeriodicShowArg0};
+static const iocshFuncDef scanPeriodicShowFuncDef =
+    {"scanPeriodicShow",1,scanPeriodicShowArgs,
+     "Show how late the periodic scans start, for each rate.\n"};
+static void scanPeriodicShowCallFunc(const iocshArgBuf *args)
+{
+    scanPeriodicShow(args[0].ival);
+}
+
 /* scanpel */
 static const iocshArg scanpelArg0 = { "event name",iocshArgString};
 static const iocshArg * const scanpelArgs[1] = {&scanpelArg0};
@@ -429,6 +463,22 @@ static void callbackParallelThreadsCallFunc(const iocshArgBuf *args)
     callbackParallelThreads(args[0].ival, args[1].sval);
 }
 
+/* callbackLatencyBudget */
+static const iocshArg callbackLatencyBudgetArg0 = { "seconds", iocshArgDouble};
+static const iocshArg callbackLatencyBudgetArg1 = { "priority", iocshArgString};
+static const iocshArg * const callbackLatencyBudgetArgs[2] =
+    {&callbackLatencyBudgetArg0,&callbackLatencyBudgetArg1};
+static const iocshFuncDef callbackLatencyBudgetFuncDef =
+    {"callbackLatencyBudget",2,callbackLatencyBudgetArgs,
+     "Set how long callbacks may wait in the queue of a priority level\n"
+     "before they are counted and reported as late; 0 disables this.\n"
+     "priority may be omitted or \"*\" to act on all priorities\n"
+     "or one of LOW, MEDIUM, or HIGH.\n"};
+static void callbackLatencyBudgetCallFunc(const iocshArgBuf *args)
+{
+    callbackLatencyBudget(args[0].dval, args[1].sval);
+}
+
 /* dbStateCreate */
 static const iocshArg dbStateArgName = { "name", iocshArgString };
 static const iocshArg * const dbStateCreateArgs[] = { &dbStateArgName };
@@ -503,6 +553,8 @@ void dbIocRegister(void)
 
     iocshRegister(&dbLoadDatabaseFuncDef,dbLoadDatabaseCallFunc);
     iocshRegister(&dbLoadRecordsFuncDef,dbLoadRecordsCallFunc);
+    iocshRegister(&dbLoadRecordsParallelFuncDef,dbLoadRecordsParallelCallFunc);
+    iocshRegister(&dbLoadRecordsWaitFuncDef,dbLoadRecordsWaitCallFunc);
 
     iocshRegister(&dbaFuncDef,dbaCallFunc);
     iocshRegister(&dblFuncDef,dblCallFunc);
@@ -530,6 +582,7 @@ void dbIocRegister(void)
     iocshRegister(&scanOnceSetQueueSizeFuncDef,scanOnceSetQueueSizeCallFunc);
     iocshRegister(&scanOnceQueueShowFuncDef,scanOnceQueueShowCallFunc);
     iocshRegister(&scanpplFuncDef,scanpplCallFunc);
+    iocshRegister(&scanPeriodicShowFuncDef,scanPeriodicShowCallFunc);
     iocshRegister(&scanpelFuncDef,scanpelCallFunc);
     iocshRegister(&postEventFuncDef,postEventCallFunc);
     iocshRegister(&scanpiolFuncDef,scanpiolCallFunc);
@@ -537,6 +590,7 @@ void dbIocRegister(void)
     iocshRegister(&callbackSetQueueSizeFuncDef,callbackSetQueueSizeCallFunc);
     iocshRegister(&callbackQueueShowFuncDef,callbackQueueShowCallFunc);
     iocshRegister(&callbackParallelThreadsFuncDef,callbackParallelThreadsCallFunc);
+    iocshRegister(&callbackLatencyBudgetFuncDef,callbackLatencyBudgetCallFunc);
 
     /* Needed before callback system is initialized */
     callbackParallelThreadsDefault = epicsThreadGetCPUs();
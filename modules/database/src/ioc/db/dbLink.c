@@ -334,6 +334,23 @@ long dbGetLink(struct link *plink, short dbrType, void *pbuffer,
     return status;
 }
 
+long dbGetLinkRef(struct link *plink, short dbrType, void *pbuffer,
+        void **ppdata, long *pnRequest)
+{
+    long status;
+
+    *ppdata = pbuffer;
+    if (plink->type != DB_LINK)
+        return dbGetLink(plink, dbrType, pbuffer, 0, pnRequest);
+
+    status = dbDbGetValueRef(plink, dbrType, pbuffer, ppdata, pnRequest);
+    if (status == S_db_badDbrtype)
+        return dbGetLink(plink, dbrType, pbuffer, 0, pnRequest);
+    if (status)
+        recGblSetSevr(plink->precord, LINK_ALARM, INVALID_ALARM);
+    return status;
+}
+
 long dbGetControlLimits(const struct link *plink, double *low, double *high)
 {
     lset *plset = plink->lset;
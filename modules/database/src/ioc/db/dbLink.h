@@ -391,6 +391,8 @@ epicsShareFunc long dbTryGetLink(struct link *, short dbrType, void *pbuffer,
         long *nRequest);
 epicsShareFunc long dbGetLink(struct link *, short dbrType, void *pbuffer,
         long *options, long *nRequest);
+epicsShareFunc long dbGetLinkRef(struct link *, short dbrType,
+        void *pbuffer, void **ppdata, long *pnRequest);
 epicsShareFunc long dbGetControlLimits(const struct link *plink, double *low,
         double *high);
 epicsShareFunc long dbGetGraphicLimits(const struct link *plink, double *low,
@@ -34,7 +34,9 @@
 #include "epicsStdlib.h"
 #include "epicsString.h"
 #include "epicsThread.h"
+#include "epicsThreadPool.h"
 #include "epicsTime.h"
+#include "epicsTypes.h"
 #include "taskwd.h"
 
 #define epicsExportSharedSymbols
@@ -48,6 +50,7 @@
 #include "dbScan.h"
 #include "dbStaticLib.h"
 #include "devSup.h"
+#include "epicsExport.h"
 #include "link.h"
 #include "recGbl.h"
 
@@ -95,12 +98,49 @@ typedef struct periodic_scan_list {
     unsigned long       overruns;
     volatile enum ctl   scanCtl;
     epicsEventId        loopEvent;
+    /* Lateness of the scans, protected by scan_list.lock */
+    unsigned long       scans;
+    double              jitterSum;
+    double              jitterMin;
+    double              jitterMax;
+    /* Only used by the shared scheduler */
+    ELLNODE             wheelNode;
+    epicsUInt64         cycle;      /* periods since the wheel epoch */
+    epicsUInt64         dueTick;
+    epicsTimeStamp      due;
+    int                 busy;       /* job queued or running */
+    epicsJob            *job;
+    unsigned int        overrunsInRow;
+    double              reportDelay;
+    epicsTimeStamp      reported;
 } periodic_scan_list;
 
 static int nPeriodic = 0;
 static periodic_scan_list **papPeriodic; /* pointer to array of pointers */
 static epicsThreadId *periodicTaskId;    /* array of thread ids */
 
+/* Number of threads scanning all periodic lists from one scheduler,
+ * 0 for one thread per scan rate.  Read by scanInit().
+ */
+int dbScanPeriodicThreads = 0;
+epicsExportAddress(int, dbScanPeriodicThreads);
+
+/* The shared scheduler is a timer wheel on the monotonic clock.  Every
+ * list is due at a whole number of its periods after the same epoch,
+ * so rates which are multiples of each other scan together.
+ */
+#define WHEEL_SLOTS 256
+#define WHEEL_TICK 0.001        /* seconds */
+
+static struct {
+    ELLLIST             slot[WHEEL_SLOTS];
+    epicsTimeStamp      epoch;
+    epicsUInt64         tick;       /* next tick to expire */
+    epicsThreadPool     *pool;
+    epicsEventId        wakeup;
+    volatile enum ctl   scanCtl;
+} wheel;
+
 
 static char *priorityName[NUM_CALLBACK_PRIORITIES] = {
     "Low", "Medium", "High"
@@ -142,6 +182,9 @@ static void periodicTask(void *arg);
 static void initPeriodic(void);
 static void deletePeriodic(void);
 static void spawnPeriodic(int ind);
+static int startWheel(void);
+static void stopWheel(void);
+static void deleteWheel(void);
 static void eventCallback(epicsCallback *pcallback);
 static void ioscanInit(void);
 static void ioscanCallback(epicsCallback *pcallback);
@@ -166,9 +209,12 @@ void scanStop(void)
 
         if (!ppsl) continue;
         ppsl->scanCtl = ctlExit;
+        if (wheel.pool) continue;
         epicsEventSignal(ppsl->loopEvent);
         epicsEventWait(startStopEvent);
     }
+    if (wheel.pool)
+        stopWheel();
 
     scanOnce((dbCommon *)&exitOnce);
     epicsEventWait(startStopEvent);
@@ -198,8 +244,10 @@ long scanInit(void)
     initPeriodic();
     initOnce();
     buildScanLists();
-    for (i = 0; i < nPeriodic; i++)
-        spawnPeriodic(i);
+    if (dbScanPeriodicThreads <= 0 || startWheel()) {
+        for (i = 0; i < nPeriodic; i++)
+            spawnPeriodic(i);
+    }
 
     return 0;
 }
@@ -405,6 +453,63 @@ int scanppl(double period)      /* print periodic scan list(s) */
     return 0;
 }
 
+int scanPeriodicStatus(int scan, const int reset, scanPeriodicStats *result)
+{
+    periodic_scan_list *ppsl;
+
+    scan -= SCAN_1ST_PERIODIC;
+    if (scan < 0 || scan >= nPeriodic || !papPeriodic)
+        return -1;
+    ppsl = papPeriodic[scan];
+    if (!ppsl)
+        return -1;
+
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    if (result) {
+        result->period = ppsl->period;
+        result->numRecords = ellCount(&ppsl->scan_list.list);
+        result->numScans = ppsl->scans;
+        result->numOverruns = ppsl->overruns;
+        result->jitterMean = ppsl->scans ? ppsl->jitterSum / ppsl->scans : 0.0;
+        result->jitterMin = ppsl->jitterMin;
+        result->jitterMax = ppsl->jitterMax;
+    }
+    if (reset) {
+        ppsl->scans = 0;
+        ppsl->jitterSum = ppsl->jitterMin = ppsl->jitterMax = 0.0;
+    }
+    epicsMutexUnlock(ppsl->scan_list.lock);
+    return 0;
+}
+
+void scanPeriodicShow(const int reset)
+{
+    int i;
+
+    if (!papPeriodic) {
+        fprintf(stderr, "Periodic scans not initialized, yet. Please run "
+            "iocInit before using this command.\n");
+        return;
+    }
+    if (wheel.pool)
+        printf("Periodic scans shared by %u threads\n",
+            epicsThreadPoolNThreads(wheel.pool));
+    else
+        printf("Periodic scans use one thread per rate\n");
+    printf("%-14s %7s %10s %9s %9s %9s %9s\n", "SCAN", "RECORDS", "SCANS",
+        "OVERRUNS", "LATE ms", "MIN ms", "MAX ms");
+    for (i = 0; i < nPeriodic; i++) {
+        scanPeriodicStats stats;
+
+        if (scanPeriodicStatus(i + SCAN_1ST_PERIODIC, reset, &stats))
+            continue;
+        printf("%-14s %7d %10lu %9lu %9.3f %9.3f %9.3f\n",
+            papPeriodic[i]->name, stats.numRecords, stats.numScans,
+            stats.numOverruns, stats.jitterMean * 1e3,
+            stats.jitterMin * 1e3, stats.jitterMax * 1e3);
+    }
+}
+
 int scanpel(const char* eventname)   /* print event list */
 {
     char message[80];
@@ -774,6 +879,31 @@ static void initOnce(void)
     epicsEventWait(startStopEvent);
 }
 
+/* Scan a periodic list which was due at *pdue */
+static void periodicScan(periodic_scan_list *ppsl, const epicsTimeStamp *pdue)
+{
+    epicsTimeStamp now;
+    double late;
+
+    epicsTimeGetMonotonic(&now);
+    late = epicsTimeDiffInSeconds(&now, pdue);
+
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    if (ppsl->scans++ == 0) {
+        ppsl->jitterMin = ppsl->jitterMax = late;
+    }
+    else if (late < ppsl->jitterMin) {
+        ppsl->jitterMin = late;
+    }
+    else if (late > ppsl->jitterMax) {
+        ppsl->jitterMax = late;
+    }
+    ppsl->jitterSum += late;
+    epicsMutexUnlock(ppsl->scan_list.lock);
+
+    scanList(&ppsl->scan_list);
+}
+
 static void periodicTask(void *arg)
 {
     periodic_scan_list *ppsl = (periodic_scan_list *)arg;
@@ -796,7 +926,7 @@ static void periodicTask(void *arg)
         epicsTimeStamp now;
 
         if (ppsl->scanCtl == ctlRun)
-            scanList(&ppsl->scan_list);
+            periodicScan(ppsl, &next);
 
         epicsTimeAddSeconds(&next, ppsl->period);
         epicsTimeGetMonotonic(&now);
@@ -915,6 +1045,9 @@ static void deletePeriodic(void)
 {
     int i;
 
+    if (wheel.pool)
+        deleteWheel();
+
     for (i = 0; i < nPeriodic; i++) {
         periodic_scan_list *ppsl = papPeriodic[i];
 
@@ -945,6 +1078,202 @@ static void spawnPeriodic(int ind)
     epicsEventWait(startStopEvent);
 }
 
+/* Put a list into the wheel slot for its current cycle */
+static void wheelInsert(periodic_scan_list *ppsl)
+{
+    ELLLIST *pslot;
+    ELLNODE *pnode;
+
+    ppsl->dueTick = (epicsUInt64) (ppsl->cycle * ppsl->period / WHEEL_TICK
+        + 0.5);
+    pslot = &wheel.slot[ppsl->dueTick % WHEEL_SLOTS];
+
+    /* Faster rates first, the order they get dispatched in */
+    for (pnode = ellFirst(pslot); pnode; pnode = ellNext(pnode)) {
+        if (CONTAINER(pnode, periodic_scan_list, wheelNode)->period >
+            ppsl->period)
+            break;
+    }
+    ellInsert(pslot, pnode ? ellPrevious(pnode) : ellLast(pslot),
+        &ppsl->wheelNode);
+}
+
+static void wheelOverrun(periodic_scan_list *ppsl, const epicsTimeStamp *pnow)
+{
+    ppsl->overruns++;
+    if (++ppsl->overrunsInRow >= 10 &&
+        epicsTimeDiffInSeconds(pnow, &ppsl->reported) > ppsl->reportDelay) {
+        errlogPrintf("\ndbScan warning from '%s' scan list:\n"
+            "\tScans have not finished in time %u times in a row.\n"
+            "\tTo fix this, move some records to a slower scan rate\n"
+            "\tor increase dbScanPeriodicThreads.\n",
+            ppsl->name, ppsl->overrunsInRow);
+
+        ppsl->reported = *pnow;
+        if (ppsl->reportDelay < (OVERRUN_REPORT_MAX / 2))
+            ppsl->reportDelay *= 2;
+        else
+            ppsl->reportDelay = OVERRUN_REPORT_MAX;
+    }
+}
+
+static void periodicJob(void *arg, epicsJobMode mode)
+{
+    periodic_scan_list *ppsl = (periodic_scan_list *)arg;
+
+    if (mode != epicsJobModeRun)
+        return;
+    if (ppsl->scanCtl == ctlRun)
+        periodicScan(ppsl, &ppsl->due);
+    epicsAtomicSetIntT(&ppsl->busy, 0);
+}
+
+/* Dispatch the lists due at tick, and schedule their next scan */
+static void wheelExpire(epicsUInt64 tick, epicsUInt64 nowTick,
+    const epicsTimeStamp *pnow)
+{
+    ELLLIST *pslot = &wheel.slot[tick % WHEEL_SLOTS];
+    ELLNODE *pnode = ellFirst(pslot);
+
+    while (pnode) {
+        periodic_scan_list *ppsl =
+            CONTAINER(pnode, periodic_scan_list, wheelNode);
+
+        pnode = ellNext(pnode);
+        if (ppsl->dueTick != tick)
+            continue;   /* in a later turn of the wheel */
+        ellDelete(pslot, &ppsl->wheelNode);
+
+        if (ppsl->scanCtl != ctlRun) {
+            /* paused */
+        }
+        else if (epicsAtomicCmpAndSwapIntT(&ppsl->busy, 0, 1) == 0) {
+            ppsl->due = wheel.epoch;
+            epicsTimeAddSeconds(&ppsl->due, tick * WHEEL_TICK);
+            ppsl->overrunsInRow = 0;
+            ppsl->reportDelay = OVERRUN_REPORT_DELAY;
+            if (epicsJobQueue(ppsl->job)) {
+                epicsAtomicSetIntT(&ppsl->busy, 0);
+                wheelOverrun(ppsl, pnow);
+            }
+        }
+        else {
+            wheelOverrun(ppsl, pnow);
+        }
+
+        /* Skip the cycles which are already past */
+        ppsl->cycle++;
+        if (ppsl->cycle * ppsl->period / WHEEL_TICK < nowTick) {
+            epicsUInt64 cycle = (epicsUInt64) (nowTick * WHEEL_TICK /
+                ppsl->period) + 1;
+
+            if (ppsl->scanCtl == ctlRun)
+                ppsl->overruns += (unsigned long) (cycle - ppsl->cycle);
+            ppsl->cycle = cycle;
+        }
+        wheelInsert(ppsl);
+    }
+}
+
+static void wheelTask(void *arg)
+{
+    taskwdInsert(0, NULL, NULL);
+    epicsEventSignal(startStopEvent);
+
+    while (wheel.scanCtl != ctlExit) {
+        epicsTimeStamp now;
+        epicsUInt64 nowTick, next;
+
+        epicsTimeGetMonotonic(&now);
+        nowTick = (epicsUInt64) (epicsTimeDiffInSeconds(&now, &wheel.epoch) /
+            WHEEL_TICK);
+        while (wheel.tick <= nowTick)
+            wheelExpire(wheel.tick++, nowTick, &now);
+
+        /* Sleep until the next slot with a list due in this turn */
+        for (next = wheel.tick; next < wheel.tick + WHEEL_SLOTS; next++) {
+            ELLNODE *pnode = ellFirst(&wheel.slot[next % WHEEL_SLOTS]);
+
+            while (pnode && CONTAINER(pnode, periodic_scan_list,
+                    wheelNode)->dueTick != next)
+                pnode = ellNext(pnode);
+            if (pnode)
+                break;
+        }
+        epicsEventWaitWithTimeout(wheel.wakeup,
+            next * WHEEL_TICK - epicsTimeDiffInSeconds(&now, &wheel.epoch));
+    }
+
+    taskwdRemove(0);
+    epicsEventSignal(startStopEvent);
+}
+
+/* Start the shared scheduler, returns non-zero if it can't */
+static int startWheel(void)
+{
+    epicsThreadPoolConfig conf;
+    int i;
+
+    epicsThreadPoolConfigDefaults(&conf);
+    conf.initialThreads = conf.maxThreads = dbScanPeriodicThreads;
+    conf.workerStack = epicsThreadGetStackSize(epicsThreadStackBig);
+    conf.workerPriority = epicsThreadPriorityScanLow + nPeriodic;
+    wheel.pool = epicsThreadPoolCreate(&conf);
+    if (!wheel.pool) {
+        errlogPrintf("scanInit: Can't create the periodic scan threads\n");
+        return -1;
+    }
+
+    for (i = 0; i < WHEEL_SLOTS; i++)
+        ellInit(&wheel.slot[i]);
+    epicsTimeGetMonotonic(&wheel.epoch);
+    wheel.tick = 0;
+    for (i = 0; i < nPeriodic; i++) {
+        periodic_scan_list *ppsl = papPeriodic[i];
+
+        if (!ppsl) continue;
+        ppsl->job = epicsJobCreate(wheel.pool, periodicJob, ppsl);
+        if (!ppsl->job)
+            cantProceed("scanInit: Can't create periodic scan job\n");
+        ppsl->cycle = 0;
+        ppsl->reportDelay = OVERRUN_REPORT_DELAY;
+        ppsl->reported = wheel.epoch;
+        wheelInsert(ppsl);
+    }
+
+    wheel.wakeup = epicsEventMustCreate(epicsEventEmpty);
+    wheel.scanCtl = ctlRun;
+    epicsThreadMustCreate("scanWheel", epicsThreadPriorityScanHigh,
+        epicsThreadGetStackSize(epicsThreadStackSmall), wheelTask, NULL);
+    epicsEventWait(startStopEvent);
+    return 0;
+}
+
+static void stopWheel(void)
+{
+    wheel.scanCtl = ctlExit;
+    epicsEventSignal(wheel.wakeup);
+    epicsEventWait(startStopEvent);
+    epicsThreadPoolWait(wheel.pool, -1.0);
+}
+
+static void deleteWheel(void)
+{
+    int i;
+
+    for (i = 0; i < nPeriodic; i++) {
+        periodic_scan_list *ppsl = papPeriodic[i];
+
+        if (ppsl)
+            epicsJobDestroy(ppsl->job);
+    }
+    epicsThreadPoolDestroy(wheel.pool);
+    wheel.pool = NULL;
+    epicsEventDestroy(wheel.wakeup);
+    for (i = 0; i < WHEEL_SLOTS; i++)
+        ellInit(&wheel.slot[i]);
+}
+
 static void ioscanCallback(epicsCallback *pcallback)
 {
     ioscan_head *piosh;
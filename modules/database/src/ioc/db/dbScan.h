@@ -50,6 +50,20 @@ typedef struct scanOnceQueueStats {
     int numOverflow;
 } scanOnceQueueStats;
 
+typedef struct scanPeriodicStats {
+    double period;
+    int numRecords;
+    unsigned long numScans;
+    unsigned long numOverruns;
+    /* How late the scans started, in seconds */
+    double jitterMean;
+    double jitterMin;
+    double jitterMax;
+} scanPeriodicStats;
+
+/* Number of threads shared by all periodic scans, 0 for one per rate */
+epicsShareExtern int dbScanPeriodicThreads;
+
 epicsShareFunc long scanInit(void);
 epicsShareFunc void scanRun(void);
 epicsShareFunc void scanPause(void);
@@ -70,6 +84,9 @@ epicsShareFunc void scanOnceQueueShow(const int reset);
 
 /*print periodic lists*/
 epicsShareFunc int scanppl(double rate);
+epicsShareFunc int scanPeriodicStatus(int scan, const int reset,
+    scanPeriodicStats *result);
+epicsShareFunc void scanPeriodicShow(const int reset);
 
 /*print event lists*/
 epicsShareFunc int scanpel(const char *event_name);
@@ -109,6 +109,7 @@ typedef struct db_field_log {
     unsigned int     type:1;  /* type (union) selector */
     /* ctx is used for all types */
     unsigned int      ctx:1;  /* context (operation type) */
+    unsigned int     mask:8;  /* DBE_* bits of the event (event context) */
     /* the following are used for value and reference types */
     epicsTimeStamp     time;  /* Time stamp */
     unsigned short     stat;  /* Alarm Status */
@@ -10,7 +10,8 @@
 
 /* Author:  Marty Kraimer Date:    13JUL95*/
 
-/*The routines in this module are serially reusable NOT reentrant*/
+/*The routines in this module are serially reusable NOT reentrant,
+ *except for the file reading done by dbReadDatabaseParallel's workers*/
 
 #include <ctype.h>
 #include <epicsStdlib.h>
@@ -18,11 +19,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "cantProceed.h"
 #include "dbDefs.h"
 #include "dbmf.h"
 #include "ellLib.h"
 #include "epicsPrint.h"
+#include "epicsStdio.h"
 #include "epicsString.h"
+#include "epicsThreadPool.h"
 #include "errMdef.h"
 #include "freeList.h"
 #include "gpHash.h"
@@ -103,8 +107,47 @@ typedef struct inputFile{
     char        *path;
     char        *filename;
     FILE        *fp;
+    const char  *text;      /* pre-expanded input, used if fp is NULL */
     int         line_num;
 }inputFile;
+
+/* A file named in a dbReadDatabaseParallel() call, which is read only
+ * once however many times it is loaded.  The text holds one nil
+ * terminated string per fgets() call, and the lines with macro
+ * references are compiled so they can be expanded without parsing them
+ * again for every set of substitutions.
+ */
+typedef struct cachedFile {
+    ELLNODE     node;
+    char        *name;      /* as requested */
+    char        *filename;  /* as opened */
+    FILE        *fp;
+    char        *text;
+    size_t      size;
+    size_t      used;
+    int         nlines;
+    const char  **lines;
+    MAC_TEMPLATE **compiled; /* NULL for lines without macros */
+    epicsJob    *job;       /* reading it, if queued */
+}cachedFile;
+
+/* A top-level file read and macro-expanded by dbReadDatabaseParallel()
+ * on a worker thread, ready for the parser.  The text holds one nil
+ * terminated string per input line, so the parser sees exactly the
+ * same input lines as when it reads the file itself.
+ */
+typedef struct preparedFile {
+    char        *filename;
+    const char  *substitutions;
+    cachedFile  *pcache;
+    char        *text;
+    size_t      size;
+    size_t      used;
+    char        *warnings;
+    size_t      warnSize;
+    long        status;
+    epicsJob    *job;       /* expanding it, if queued */
+}preparedFile;
 static ELLLIST inputFileList = ELLLIST_INIT;
 
 static inputFile *pinputFileNow = NULL;
@@ -194,7 +237,7 @@ static void freeInputFileList(void)
     inputFile *pinputFileNow;
 
     while((pinputFileNow=(inputFile *)ellFirst(&inputFileList))) {
-        if(fclose(pinputFileNow->fp))
+        if(pinputFileNow->fp && fclose(pinputFileNow->fp))
             errPrintf(0,__FILE__, __LINE__,
                         "Closing file %s",pinputFileNow->filename);
         free((void *)pinputFileNow->filename);
@@ -212,12 +255,27 @@ int cmp_dbRecordNode(const ELLNODE *lhs, const ELLNODE *rhs)
     return strcmp(LHS->recordname, RHS->recordname);
 }
 
+static void dbSearchPath(const char *path)
+{
+    char        *penv;
+
+    if(path && strlen(path)>0) {
+        dbPath(pdbbase,path);
+    } else {
+        penv = getenv("EPICS_DB_INCLUDE_PATH");
+        if(penv) {
+            dbPath(pdbbase,penv);
+        } else {
+            dbPath(pdbbase,".");
+        }
+    }
+}
+
 static long dbReadCOM(DBBASE **ppdbbase,const char *filename, FILE *fp,
-        const char *path,const char *substitutions)
+        const char *path,const char *substitutions,preparedFile *pprepared)
 {
     long        status;
     inputFile   *pinputFile = NULL;
-    char        *penv;
     char        **macPairs;
 
     if (ellCount(&tempList)) {
@@ -229,16 +287,7 @@ static long dbReadCOM(DBBASE **ppdbbase,const char *filename, FILE *fp,
 
     if(*ppdbbase == 0) *ppdbbase = dbAllocBase();
     pdbbase = *ppdbbase;
-    if(path && strlen(path)>0) {
-        dbPath(pdbbase,path);
-    } else {
-        penv = getenv("EPICS_DB_INCLUDE_PATH");
-        if(penv) {
-            dbPath(pdbbase,penv);
-        } else {
-            dbPath(pdbbase,".");
-        }
-    }
+    dbSearchPath(path);
     my_buffer = dbCalloc(MY_BUFFER_SIZE,sizeof(char));
     freeListInitPvt(&freeListPvt,sizeof(tempListNode),100);
     if(substitutions) {
@@ -259,10 +308,18 @@ static long dbReadCOM(DBBASE **ppdbbase,const char *filename, FILE *fp,
         macSuppressWarning(macHandle,dbQuietMacroWarnings);
     }
     pinputFile = dbCalloc(1,sizeof(inputFile));
-    if (filename) {
+    if (pprepared) {
+        /* Already opened, read and expanded */
+        pinputFile->filename = epicsStrDup(pprepared->filename);
+        pinputFile->text = pprepared->text;
+        if (pprepared->warnings)
+            fputs(pprepared->warnings, stderr);
+    } else if (filename) {
         pinputFile->filename = macEnvExpand(filename);
     }
-    if (!fp) {
+    if (pprepared) {
+        pinputFile->fp = NULL;
+    } else if (!fp) {
         FILE *fp1 = 0;
 
         if (pinputFile->filename)
@@ -338,12 +395,273 @@ cleanup:
 
 long dbReadDatabase(DBBASE **ppdbbase,const char *filename,
         const char *path,const char *substitutions)
-{return (dbReadCOM(ppdbbase,filename,0,path,substitutions));}
+{return (dbReadCOM(ppdbbase,filename,0,path,substitutions,NULL));}
 
 long dbReadDatabaseFP(DBBASE **ppdbbase,FILE *fp,
         const char *path,const char *substitutions)
-{return (dbReadCOM(ppdbbase,0,fp,path,substitutions));}
-
+{return (dbReadCOM(ppdbbase,0,fp,path,substitutions,NULL));}
+
+static void prepareAppend(char **pbuf, size_t *psize, size_t *pused,
+    const char *str, size_t len)
+{
+    if (*pused + len > *psize) {
+        size_t size = *psize ? *psize : 4 * MY_BUFFER_SIZE;
+
+        while (*pused + len > size)
+            size *= 2;
+        *pbuf = realloc(*pbuf, size);
+        if (!*pbuf)
+            cantProceed("dbReadDatabaseParallel: Out of memory\n");
+        *psize = size;
+    }
+    memcpy(*pbuf + *pused, str, len);
+    *pused += len;
+}
+
+/* Runs on a thread pool worker, must not touch the parser globals */
+static void readFileJob(void *arg, epicsJobMode mode)
+{
+    cachedFile  *pcache = arg;
+    char        *inbuf;
+    size_t      offset;
+    int         i;
+
+    if (mode != epicsJobModeRun)
+        return;
+
+    inbuf = dbMalloc(MY_BUFFER_SIZE);
+    while (fgets(inbuf, MY_BUFFER_SIZE, pcache->fp)) {
+        prepareAppend(&pcache->text, &pcache->size, &pcache->used,
+            inbuf, strlen(inbuf) + 1);
+        pcache->nlines++;
+    }
+    free(inbuf);
+    if (fclose(pcache->fp))
+        errPrintf(0, __FILE__, __LINE__,
+            "Closing file %s", pcache->filename);
+    pcache->fp = NULL;
+
+    pcache->lines = dbCalloc(pcache->nlines + 1, sizeof(char *));
+    pcache->compiled = dbCalloc(pcache->nlines + 1, sizeof(MAC_TEMPLATE *));
+    for (i = 0, offset = 0; i < pcache->nlines; i++) {
+        const char *line = pcache->text + offset;
+
+        pcache->lines[i] = line;
+        if (strchr(line, '$'))
+            pcache->compiled[i] = macCompileTemplate(line);
+        offset += strlen(line) + 1;
+    }
+}
+
+/* Runs on a thread pool worker, must not touch the parser globals */
+static void prepareFileJob(void *arg, epicsJobMode mode)
+{
+    preparedFile *pprepared = arg;
+    cachedFile  *pcache = pprepared->pcache;
+    MAC_HANDLE  *handle = NULL;
+    char        **macPairs;
+    char        *outbuf;
+    size_t      warnUsed = 0;
+    int         i;
+
+    if (mode != epicsJobModeRun)
+        return;
+
+    outbuf = dbMalloc(MY_BUFFER_SIZE);
+    if (pprepared->substitutions) {
+        if (macCreateHandle(&handle, NULL)) {
+            pprepared->status = -1;
+            goto done;
+        }
+        macParseDefns(handle, pprepared->substitutions, &macPairs);
+        if (macPairs == NULL) {
+            macDeleteHandle(handle);
+            handle = NULL;
+        } else {
+            macInstallMacros(handle, macPairs);
+            free(macPairs);
+            macSuppressWarning(handle, dbQuietMacroWarnings);
+        }
+    }
+    for (i = 0; i < pcache->nlines; i++) {
+        const char *line = pcache->lines[i];
+
+        if (handle && pcache->compiled[i]) {
+            if (macExpandTemplate(handle, pcache->compiled[i], outbuf,
+                    MY_BUFFER_SIZE) < 0) {
+                char msg[256];
+                int len = epicsSnprintf(msg, sizeof(msg),
+                    "Warning: '%s' line %d has undefined macros\n",
+                    pprepared->filename, i + 1);
+
+                if (len >= (int) sizeof(msg))
+                    len = sizeof(msg) - 1;
+                prepareAppend(&pprepared->warnings, &pprepared->warnSize,
+                    &warnUsed, msg, len);
+            }
+            line = outbuf;
+        }
+        prepareAppend(&pprepared->text, &pprepared->size, &pprepared->used,
+            line, strlen(line) + 1);
+    }
+    /* Empty string marks the end */
+    prepareAppend(&pprepared->text, &pprepared->size, &pprepared->used,
+        "", 1);
+    if (warnUsed)
+        prepareAppend(&pprepared->warnings, &pprepared->warnSize,
+            &warnUsed, "", 1);
+
+done:
+    if (handle)
+        macDeleteHandle(handle);
+    free(outbuf);
+}
+
+/* Queue a job on the pool, or run it here if that fails.  Returns the
+ * queued job, which must be destroyed after epicsThreadPoolWait().
+ */
+static epicsJob* runJob(epicsThreadPool *pool, epicsJobFunction func,
+    void *arg)
+{
+    if (pool) {
+        epicsJob *job = epicsJobCreate(pool, func, arg);
+
+        if (job && !epicsJobQueue(job))
+            return job;
+        if (job)
+            epicsJobDestroy(job);
+    }
+    func(arg, epicsJobModeRun);
+    return NULL;
+}
+
+long dbReadDatabaseParallel(DBBASE **ppdbbase, int nfiles,
+    const char * const *filenames, const char * const *substitutions,
+    const char *path, long *pstatus)
+{
+    preparedFile *prepared;
+    ELLLIST     cacheList = ELLLIST_INIT;
+    cachedFile  *pcache;
+    epicsThreadPool *pool;
+    long        status = 0;
+    int         i;
+
+    if (getIocState() != iocVoid)
+        return -2;
+    if (nfiles <= 0)
+        return 0;
+
+    if (*ppdbbase == 0) *ppdbbase = dbAllocBase();
+    pdbbase = *ppdbbase;
+    prepared = dbCalloc(nfiles, sizeof(preparedFile));
+
+    /* Open each file once, the search path lives in pdbbase */
+    dbSearchPath(path);
+    for (i = 0; i < nfiles; i++) {
+        preparedFile *pprepared = &prepared[i];
+        char *name;
+
+        pprepared->substitutions = substitutions ? substitutions[i] : NULL;
+        name = filenames[i] ? macEnvExpand(filenames[i]) : NULL;
+        if (!name) {
+            pprepared->status = -1;
+            continue;
+        }
+        for (pcache = (cachedFile *) ellFirst(&cacheList); pcache;
+             pcache = (cachedFile *) ellNext(&pcache->node)) {
+            if (strcmp(pcache->name, name) == 0)
+                break;
+        }
+        if (!pcache) {
+            const char *dir;
+
+            pcache = dbCalloc(1, sizeof(cachedFile));
+            pcache->name = name;
+            dir = dbOpenFile(pdbbase, name, &pcache->fp);
+            if (pcache->fp && dir) {
+                /* Keep the directory in messages, the path is freed below */
+                pcache->filename = dbMalloc(strlen(dir) + strlen(name) + 2);
+                strcpy(pcache->filename, dir);
+                strcat(pcache->filename, "/");
+                strcat(pcache->filename, name);
+            } else {
+                pcache->filename = epicsStrDup(name);
+            }
+            ellAdd(&cacheList, &pcache->node);
+        } else {
+            free(name);
+        }
+        pprepared->pcache = pcache;
+        pprepared->filename = epicsStrDup(pcache->filename);
+        if (!pcache->fp)
+            pprepared->status = -1;
+    }
+    dbFreePath(pdbbase);
+
+    /* Read and compile the files, then expand them for each load */
+    pool = epicsThreadPoolCreate(NULL);
+    for (pcache = (cachedFile *) ellFirst(&cacheList); pcache;
+         pcache = (cachedFile *) ellNext(&pcache->node)) {
+        if (pcache->fp)
+            pcache->job = runJob(pool, readFileJob, pcache);
+    }
+    if (pool)
+        epicsThreadPoolWait(pool, -1.0);
+    for (pcache = (cachedFile *) ellFirst(&cacheList); pcache;
+         pcache = (cachedFile *) ellNext(&pcache->node)) {
+        if (pcache->job)
+            epicsJobDestroy(pcache->job);
+        pcache->job = NULL;
+    }
+    for (i = 0; i < nfiles; i++) {
+        if (!prepared[i].status)
+            prepared[i].job = runJob(pool, prepareFileJob, &prepared[i]);
+    }
+    if (pool) {
+        epicsThreadPoolWait(pool, -1.0);
+        for (i = 0; i < nfiles; i++) {
+            if (prepared[i].job)
+                epicsJobDestroy(prepared[i].job);
+            prepared[i].job = NULL;
+        }
+        epicsThreadPoolDestroy(pool);
+    }
+
+    /* Parse in the order given, the same as sequential loading */
+    for (i = 0; i < nfiles; i++) {
+        preparedFile *pprepared = &prepared[i];
+        long fstatus = pprepared->status;
+
+        if (!fstatus) {
+            fstatus = dbReadCOM(ppdbbase, NULL, NULL, path,
+                pprepared->substitutions, pprepared);
+        } else {
+            errPrintf(0, __FILE__, __LINE__, "dbRead opening file %s",
+                pprepared->filename ? pprepared->filename : filenames[i]);
+        }
+        if (pstatus)
+            pstatus[i] = fstatus;
+        if (fstatus && !status)
+            status = fstatus;
+        free(pprepared->filename);
+        free(pprepared->text);
+        free(pprepared->warnings);
+    }
+    free(prepared);
+
+    while ((pcache = (cachedFile *) ellGet(&cacheList))) {
+        for (i = 0; i < pcache->nlines; i++)
+            macDeleteTemplate(pcache->compiled[i]);
+        free(pcache->compiled);
+        free(pcache->lines);
+        free(pcache->text);
+        free(pcache->name);
+        free(pcache->filename);
+        free(pcache);
+    }
+    return status;
+}
+
 static int db_yyinput(char *buf, int max_size)
 {
     size_t  l,n;
@@ -352,10 +670,20 @@ static int db_yyinput(char *buf, int max_size)
     if(yyAbort) return(0);
     if(*my_buffer_ptr==0) {
         while(TRUE) { /*until we get some input*/
-            if(macHandle) {
+            if(!pinputFileNow->fp) {
+                fgetsRtn = NULL;
+                if(*pinputFileNow->text) {
+                    strncpy(my_buffer,pinputFileNow->text,MY_BUFFER_SIZE-1);
+                    pinputFileNow->text += strlen(pinputFileNow->text) + 1;
+                    fgetsRtn = my_buffer;
+                }
+            } else if(macHandle) {
                 fgetsRtn = fgets(mac_input_buffer,MY_BUFFER_SIZE,
                         pinputFileNow->fp);
-                if(fgetsRtn) {
+                if(fgetsRtn && !strchr(mac_input_buffer, '$')) {
+                    /* Nothing to expand */
+                    strcpy(my_buffer, mac_input_buffer);
+                } else if(fgetsRtn) {
                     int exp = macExpandString(macHandle,mac_input_buffer,
                         my_buffer,MY_BUFFER_SIZE);
                     if (exp < 0) {
@@ -367,7 +695,7 @@ static int db_yyinput(char *buf, int max_size)
                 fgetsRtn = fgets(my_buffer,MY_BUFFER_SIZE,pinputFileNow->fp);
             }
             if(fgetsRtn) break;
-            if(fclose(pinputFileNow->fp))
+            if(pinputFileNow->fp && fclose(pinputFileNow->fp))
                 errPrintf(0,__FILE__, __LINE__,
                         "Closing file %s",pinputFileNow->filename);
             free((void *)pinputFileNow->filename);
@@ -0,0 +1,468 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/* dbRecordImage.c
+ *
+ * Save the record instances of a loaded database to a binary image,
+ * and create them again from that image without the .db file parser.
+ *
+ * Image layout, all integers in host byte order:
+ *   header   magic, version, byte order marker, DBD hash
+ *   'R'      record type name, record name, visible flag
+ *   'F'      field index, value string     (fields of the last 'R')
+ *   'I'      info name, info value          (info items of the last 'R')
+ *   'A'      record name, alias name        (after the record types)
+ *   'E'      end of image
+ * Strings are stored with their length and terminating nil, so the
+ * loader can hand them to dbPutString() straight from the file buffer.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "ellLib.h"
+#include "epicsPrint.h"
+#include "epicsString.h"
+#include "epicsTypes.h"
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "dbBase.h"
+#include "dbStaticLib.h"
+#include "dbStaticPvt.h"
+#include "iocInit.h"
+
+#define IMAGE_MAGIC     "EPICSdbi"
+#define IMAGE_VERSION   2
+#define IMAGE_BYTEORDER 0x01020304u
+
+typedef struct imageHeader {
+    char        magic[8];
+    epicsUInt32 version;
+    epicsUInt32 byteOrder;
+    epicsUInt32 dbdHash;
+} imageHeader;
+
+enum imageTag {
+    tagRecord = 'R',
+    tagField = 'F',
+    tagInfo = 'I',
+    tagAlias = 'A',
+    tagEnd = 'E'
+};
+
+/* Hash of everything in the DBD which the field indices of an image
+ * depend on.  An image can only be loaded by an IOC with the same hash.
+ */
+static epicsUInt32 dbdHash(DBBASE *pdbbase)
+{
+    dbRecordType *precordType;
+    unsigned int hash = IMAGE_VERSION;
+
+    for (precordType = (dbRecordType *)ellFirst(&pdbbase->recordTypeList);
+         precordType;
+         precordType = (dbRecordType *)ellNext(&precordType->node)) {
+        int i;
+
+        hash = epicsStrHash(precordType->name, hash);
+        for (i = 0; i < precordType->no_fields; i++) {
+            dbFldDes *pflddes = precordType->papFldDes[i];
+
+            hash = epicsStrHash(pflddes->name, hash);
+            hash = epicsMemHash((const char *)&pflddes->field_type,
+                sizeof(pflddes->field_type), hash);
+            hash = epicsMemHash((const char *)&pflddes->size,
+                sizeof(pflddes->size), hash);
+        }
+    }
+    return hash;
+}
+
+/* Link fields hold their unparsed text until iocInit, which
+ * dbIsDefaultValue() doesn't look at.
+ */
+static int isDefault(DBENTRY *pdbentry)
+{
+    switch (pdbentry->pflddes->field_type) {
+    case DBF_INLINK:
+    case DBF_OUTLINK:
+    case DBF_FWDLINK: {
+        DBLINK *plink = (DBLINK *)pdbentry->pfield;
+
+        if (plink->text)
+            return pdbentry->pflddes->initial &&
+                strcmp(plink->text, pdbentry->pflddes->initial) == 0;
+        break;
+    }
+    default:
+        break;
+    }
+    return dbIsDefaultValue(pdbentry);
+}
+
+static void putTag(FILE *fp, int tag)
+{
+    fputc(tag, fp);
+}
+
+static void putString(FILE *fp, const char *str)
+{
+    epicsUInt32 len = strlen(str) + 1;
+
+    fwrite(&len, sizeof(len), 1, fp);
+    fwrite(str, 1, len, fp);
+}
+
+long dbWriteRecordImage(DBBASE *pdbbase, const char *filename)
+{
+    DBENTRY dbentry;
+    DBENTRY *pdbentry = &dbentry;
+    imageHeader header;
+    FILE *fp;
+    long status;
+
+    if (!pdbbase) {
+        fprintf(stderr, "dbWriteRecordImage: pdbbase not specified\n");
+        return -1;
+    }
+    if (!filename || !*filename) {
+        fprintf(stderr, "dbWriteRecordImage: No image file name\n");
+        return -1;
+    }
+    fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "dbWriteRecordImage: Can't open %s: %s\n",
+            filename, strerror(errno));
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+    header.version = IMAGE_VERSION;
+    header.byteOrder = IMAGE_BYTEORDER;
+    header.dbdHash = dbdHash(pdbbase);
+    fwrite(&header, sizeof(header), 1, fp);
+
+    dbInitEntry(pdbbase, pdbentry);
+    status = dbFirstRecordType(pdbentry);
+    while (!status) {
+        status = dbFirstRecord(pdbentry);
+        while (!status) {
+            if (dbIsAlias(pdbentry)) {
+                status = dbNextRecord(pdbentry);
+                continue;
+            }
+            putTag(fp, tagRecord);
+            putString(fp, dbGetRecordTypeName(pdbentry));
+            putString(fp, dbGetRecordName(pdbentry));
+            putTag(fp, dbIsVisibleRecord(pdbentry));
+
+            status = dbFirstField(pdbentry, FALSE);
+            while (!status) {
+                if (pdbentry->indfield != 0 &&
+                    pdbentry->pflddes->field_type != DBF_NOACCESS &&
+                    !isDefault(pdbentry)) {
+                    char *pvalstring = dbGetString(pdbentry);
+                    epicsUInt16 ind = pdbentry->indfield;
+
+                    if (pvalstring) {
+                        putTag(fp, tagField);
+                        fwrite(&ind, sizeof(ind), 1, fp);
+                        putString(fp, pvalstring);
+                    }
+                }
+                status = dbNextField(pdbentry, FALSE);
+            }
+
+            status = dbFirstInfo(pdbentry);
+            while (!status) {
+                putTag(fp, tagInfo);
+                putString(fp, dbGetInfoName(pdbentry));
+                putString(fp, dbGetInfoString(pdbentry));
+                status = dbNextInfo(pdbentry);
+            }
+            status = dbNextRecord(pdbentry);
+        }
+
+        /* aliases follow their record type, as in dbWriteRecordFP() */
+        status = dbFirstRecord(pdbentry);
+        while (!status) {
+            if (dbIsAlias(pdbentry)) {
+                putTag(fp, tagAlias);
+                putString(fp, dbRecordName(pdbentry));
+                putString(fp, dbGetRecordName(pdbentry));
+            }
+            status = dbNextRecord(pdbentry);
+        }
+        status = dbNextRecordType(pdbentry);
+    }
+    dbFinishEntry(pdbentry);
+
+    putTag(fp, tagEnd);
+    if (ferror(fp) | fclose(fp)) {
+        fprintf(stderr, "dbWriteRecordImage: Error writing %s\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct imageCursor {
+    const char *pos;
+    const char *end;
+} imageCursor;
+
+static int getTag(imageCursor *pcur)
+{
+    if (pcur->pos >= pcur->end)
+        return -1;
+    return (unsigned char) *pcur->pos++;
+}
+
+static int getIndex(imageCursor *pcur, epicsUInt16 *pind)
+{
+    if (pcur->end - pcur->pos < (ptrdiff_t) sizeof(*pind))
+        return -1;
+    memcpy(pind, pcur->pos, sizeof(*pind));
+    pcur->pos += sizeof(*pind);
+    return 0;
+}
+
+/* Returns a pointer into the image buffer, or NULL if truncated */
+static const char * getString(imageCursor *pcur)
+{
+    const char *str;
+    epicsUInt32 len;
+
+    if (pcur->end - pcur->pos < (ptrdiff_t) sizeof(len))
+        return NULL;
+    memcpy(&len, pcur->pos, sizeof(len));
+    pcur->pos += sizeof(len);
+    if (len == 0 || (size_t)(pcur->end - pcur->pos) < len ||
+        pcur->pos[len - 1] != 0)
+        return NULL;
+    str = pcur->pos;
+    pcur->pos += len;
+    return str;
+}
+
+static long loadImage(DBBASE *pdbbase, const char *filename,
+    imageCursor *pcur)
+{
+    DBENTRY dbentry;
+    DBENTRY *pdbentry = &dbentry;
+    int haveRecord = FALSE;
+    long status = 0;
+
+    dbInitEntry(pdbbase, pdbentry);
+    while (!status) {
+        int tag = getTag(pcur);
+
+        switch (tag) {
+        case tagRecord: {
+            const char *type = getString(pcur);
+            const char *name = getString(pcur);
+            int visible = getTag(pcur);
+
+            if (!type || !name || visible < 0)
+                goto truncated;
+            haveRecord = FALSE;
+            if (!pdbentry->precordType ||
+                strcmp(type, pdbentry->precordType->name) != 0) {
+                status = dbFindRecordType(pdbentry, type);
+                if (status) {
+                    errlogPrintf("dbReadRecordImage: Record \"%s\" is of "
+                        "unknown type \"%s\"\n", name, type);
+                    break;
+                }
+            }
+            status = dbCreateRecord(pdbentry, name);
+            if (status == S_dbLib_recExists) {
+                /* Duplicate records are ok if the same type */
+                if (strcmp(type, dbGetRecordTypeName(pdbentry)) != 0) {
+                    errlogPrintf("dbReadRecordImage: Record \"%s\" of type "
+                        "\"%s\" redefined with new type \"%s\"\n",
+                        name, dbGetRecordTypeName(pdbentry), type);
+                    break;
+                }
+                if (dbRecordsOnceOnly) {
+                    errlogPrintf("dbReadRecordImage: Record \"%s\" already "
+                        "defined (dbRecordsOnceOnly is set)\n", name);
+                    status = S_dbLib_recExists;
+                    break;
+                }
+                status = 0;
+            }
+            else if (status) {
+                errlogPrintf("dbReadRecordImage: Can't create record \"%s\" "
+                    "of type \"%s\"\n", name, type);
+                break;
+            }
+            if (visible)
+                dbVisibleRecord(pdbentry);
+            haveRecord = TRUE;
+            break;
+        }
+        case tagField: {
+            epicsUInt16 ind;
+            const char *value;
+
+            if (getIndex(pcur, &ind) || !(value = getString(pcur)))
+                goto truncated;
+            if (!haveRecord || ind == 0 ||
+                ind >= pdbentry->precordType->no_fields)
+                goto corrupt;
+            pdbentry->indfield = ind;
+            pdbentry->pflddes = pdbentry->precordType->papFldDes[ind];
+            dbGetFieldAddress(pdbentry);
+            status = dbPutString(pdbentry, value);
+            if (status)
+                errlogPrintf("dbReadRecordImage: Can't set \"%s.%s\" "
+                    "to \"%s\"\n", dbGetRecordName(pdbentry),
+                    pdbentry->pflddes->name, value);
+            break;
+        }
+        case tagInfo: {
+            const char *name = getString(pcur);
+            const char *value = getString(pcur);
+
+            if (!name || !value)
+                goto truncated;
+            if (!haveRecord)
+                goto corrupt;
+            status = dbPutInfo(pdbentry, name, value);
+            if (status)
+                errlogPrintf("dbReadRecordImage: Can't set \"%s\" info "
+                    "\"%s\" to \"%s\"\n", dbGetRecordName(pdbentry),
+                    name, value);
+            break;
+        }
+        case tagAlias: {
+            const char *name = getString(pcur);
+            const char *alias = getString(pcur);
+
+            if (!name || !alias)
+                goto truncated;
+            /* The record already exists, don't create it again */
+            haveRecord = FALSE;
+            status = dbFindRecord(pdbentry, name);
+            if (status) {
+                errlogPrintf("dbReadRecordImage: Alias \"%s\" refers to "
+                    "unknown record \"%s\"\n", alias, name);
+                break;
+            }
+            status = dbCreateAlias(pdbentry, alias);
+            if (status)
+                errlogPrintf("dbReadRecordImage: Can't create alias \"%s\" "
+                    "for \"%s\"\n", alias, name);
+            break;
+        }
+        case tagEnd:
+            dbFinishEntry(pdbentry);
+            return 0;
+        case -1:
+            goto truncated;
+        default:
+            goto corrupt;
+        }
+    }
+    dbFinishEntry(pdbentry);
+    return status;
+
+truncated:
+    errlogPrintf("dbReadRecordImage: Image file %s is truncated\n", filename);
+    dbFinishEntry(pdbentry);
+    return S_dbLib_badImage;
+
+corrupt:
+    errlogPrintf("dbReadRecordImage: Image file %s is corrupt\n", filename);
+    dbFinishEntry(pdbentry);
+    return S_dbLib_badImage;
+}
+
+long dbReadRecordImage(DBBASE *pdbbase, const char *filename)
+{
+    imageHeader header;
+    imageCursor cur;
+    char *buffer;
+    long size;
+    FILE *fp;
+    long status;
+
+    if (getIocState() != iocVoid) {
+        errlogPrintf("dbReadRecordImage: Records can't be loaded "
+            "after iocInit\n");
+        return -2;
+    }
+
+    if (!pdbbase) {
+        errlogPrintf("dbReadRecordImage: No database definitions loaded\n");
+        return -1;
+    }
+    if (!filename || !*filename) {
+        errlogPrintf("dbReadRecordImage: No image file name\n");
+        return -1;
+    }
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        errlogPrintf("dbReadRecordImage: Can't open %s: %s\n",
+            filename, strerror(errno));
+        return -1;
+    }
+    /* Read the whole image with one call, records are created from
+     * strings in the buffer without further copying.
+     */
+    if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < 0 ||
+        fseek(fp, 0, SEEK_SET)) {
+        errlogPrintf("dbReadRecordImage: Can't size %s\n", filename);
+        fclose(fp);
+        return -1;
+    }
+    if (size < (long) sizeof(header)) {
+        errlogPrintf("dbReadRecordImage: %s is not a record image\n",
+            filename);
+        fclose(fp);
+        return S_dbLib_badImage;
+    }
+    buffer = dbMalloc(size);
+    if (fread(buffer, 1, size, fp) != (size_t) size) {
+        errlogPrintf("dbReadRecordImage: Error reading %s\n", filename);
+        free(buffer);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    memcpy(&header, buffer, sizeof(header));
+    if (memcmp(header.magic, IMAGE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.byteOrder != IMAGE_BYTEORDER) {
+        errlogPrintf("dbReadRecordImage: %s is not a record image "
+            "for this architecture\n", filename);
+        status = S_dbLib_badImage;
+    }
+    else if (header.version != IMAGE_VERSION) {
+        errlogPrintf("dbReadRecordImage: %s has image version %u, "
+            "expected %u\n", filename, (unsigned) header.version,
+            IMAGE_VERSION);
+        status = S_dbLib_badImage;
+    }
+    else if (header.dbdHash != dbdHash(pdbbase)) {
+        errlogPrintf("dbReadRecordImage: %s was made with different "
+            "database definitions\n", filename);
+        status = S_dbLib_badImage;
+    }
+    else {
+        cur.pos = buffer + sizeof(header);
+        cur.end = buffer + size;
+        status = loadImage(pdbbase, filename, &cur);
+    }
+    free(buffer);
+    return status;
+}
@@ -161,6 +161,30 @@ static void dbReportDeviceConfigCallFunc(const iocshArgBuf *args)
     dbReportDeviceConfig(*iocshPpdbbase,stdout);
 }
 
+/* dbWriteRecordImage */
+static const iocshArg argImageFile = { "image file name",iocshArgString};
+static const iocshArg * const dbWriteRecordImageArgs[] = {
+    &argPdbbase, &argImageFile};
+static const iocshFuncDef dbWriteRecordImageFuncDef = {
+    "dbWriteRecordImage",2,dbWriteRecordImageArgs,
+    "Save all loaded records to a binary image file.\n"};
+static void dbWriteRecordImageCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbWriteRecordImage(*iocshPpdbbase,args[1].sval));
+}
+
+/* dbReadRecordImage */
+static const iocshArg * const dbReadRecordImageArgs[] = {
+    &argPdbbase, &argImageFile};
+static const iocshFuncDef dbReadRecordImageFuncDef = {
+    "dbReadRecordImage",2,dbReadRecordImageArgs,
+    "Load records from an image file made by dbWriteRecordImage.\n"
+    "The image must have been made with the same database definitions.\n"};
+static void dbReadRecordImageCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbReadRecordImage(*iocshPpdbbase,args[1].sval));
+}
+
 void dbStaticIocRegister(void)
 {
     iocshRegister(&dbDumpPathFuncDef, dbDumpPathCallFunc);
@@ -178,4 +202,6 @@ void dbStaticIocRegister(void)
     iocshRegister(&dbPvdDumpFuncDef, dbPvdDumpCallFunc);
     iocshRegister(&dbPvdTableSizeFuncDef,dbPvdTableSizeCallFunc);
     iocshRegister(&dbReportDeviceConfigFuncDef, dbReportDeviceConfigCallFunc);
+    iocshRegister(&dbWriteRecordImageFuncDef, dbWriteRecordImageCallFunc);
+    iocshRegister(&dbReadRecordImageFuncDef, dbReadRecordImageCallFunc);
 }
@@ -61,6 +61,9 @@ epicsShareFunc long dbReadDatabase(DBBASE **ppdbbase,
     const char *filename, const char *path, const char *substitutions);
 epicsShareFunc long dbReadDatabaseFP(DBBASE **ppdbbase,
     FILE *fp, const char *path, const char *substitutions);
+epicsShareFunc long dbReadDatabaseParallel(DBBASE **ppdbbase, int nfiles,
+    const char * const *filenames, const char * const *substitutions,
+    const char *path, long *pstatus);
 epicsShareFunc long dbPath(DBBASE *pdbbase, const char *path);
 epicsShareFunc long dbAddPath(DBBASE *pdbbase, const char *path);
 epicsShareFunc char * dbGetPromptGroupNameFromKey(DBBASE *pdbbase,
@@ -71,6 +74,10 @@ epicsShareFunc long dbWriteRecord(DBBASE *ppdbbase,
     const char *filename, const char *precordTypename, int level);
 epicsShareFunc long dbWriteRecordFP(DBBASE *ppdbbase,
     FILE *fp, const char *precordTypename, int level);
+epicsShareFunc long dbWriteRecordImage(DBBASE *pdbbase,
+    const char *filename);
+epicsShareFunc long dbReadRecordImage(DBBASE *pdbbase,
+    const char *filename);
 epicsShareFunc long dbWriteMenu(DBBASE *pdbbase,
     const char *filename, const char *menuName);
 epicsShareFunc long dbWriteMenuFP(DBBASE *pdbbase,
@@ -248,6 +255,7 @@ extern int dbConvertStrict;
 #define S_dbLib_noSizeOffset (M_dbLib|23)      /* Missing SizeOffset Routine - No record support? */
 #define S_dbLib_outMem (M_dbLib|27)            /* Out of memory */
 #define S_dbLib_infoNotFound (M_dbLib|29)      /* Info item Not Found */
+#define S_dbLib_badImage (M_dbLib|31)          /* Bad or mismatched record image */
 
 #ifdef __cplusplus
 }
@@ -40,6 +40,8 @@ void dbMsgPrint(DBENTRY *pdbentry, const char *fmt, ...) EPICS_PRINTF_STYLE(2,3)
 
 void dbPutStringSuggest(DBENTRY *pdbentry, const char *pstring);
 
+extern int dbRecordsOnceOnly;
+
 struct jlink;
 
 typedef struct dbLinkInfo {
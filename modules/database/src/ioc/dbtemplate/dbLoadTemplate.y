@@ -164,17 +164,17 @@ pattern_definition: global_definitions
     {
     #ifdef ERROR_STUFF
         fprintf(stderr, "pattern_definition: pattern_values empty\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
     }
     | O_BRACE pattern_values C_BRACE
     {
     #ifdef ERROR_STUFF
         fprintf(stderr, "pattern_definition:\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
         *sub_locals = '\0';
         sub_count = 0;
     }
@@ -187,9 +187,9 @@ pattern_definition: global_definitions
             $1, line_num);
     #ifdef ERROR_STUFF
         fprintf(stderr, "pattern_definition:\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
         dbmfFree($1);
         *sub_locals = '\0';
         sub_count = 0;
@@ -247,17 +247,17 @@ variable_substitution: global_definitions
     {
     #ifdef ERROR_STUFF
         fprintf(stderr, "variable_substitution: variable_definitions empty\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
     }
     | O_BRACE variable_definitions C_BRACE
     {
     #ifdef ERROR_STUFF
         fprintf(stderr, "variable_substitution:\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
         *sub_locals = '\0';
     }
     | WORD O_BRACE variable_definitions C_BRACE
@@ -269,9 +269,9 @@ variable_substitution: global_definitions
             $1, line_num);
     #ifdef ERROR_STUFF
         fprintf(stderr, "variable_substitution:\n");
-        fprintf(stderr, "    dbLoadRecords(%s)\n", sub_collect+1);
+        fprintf(stderr, "    dbLoadRecordsParallel(%s)\n", sub_collect+1);
     #endif
-        dbLoadRecords(db_file_name, sub_collect+1);
+        dbLoadRecordsParallel(db_file_name, sub_collect+1);
         dbmfFree($1);
         *sub_locals = '\0';
     }
@@ -378,6 +378,9 @@ int dbLoadTemplate(const char *sub_file, const char *cmd_collect)
 
     yyparse();
 
+    /* Load the records, reading each template file only once */
+    dbLoadRecordsWait();
+
     for (i = 0; i < var_count; i++) {
         dbmfFree(vars[i]);
     }
@@ -12,6 +12,8 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
 
 #include <stdlib.h>
 #include <stddef.h>
@@ -26,10 +28,17 @@
 #include <epicsString.h>
 #include <osiFileName.h>
 #include <osiUnistd.h>
+#include <epicsThreadPool.h>
 
 #define MAX_BUFFER_SIZE 4096
 #define MAX_DEPS 1024
 
+/* Substitution sets of a file block are expanded on a thread pool
+ * when there are enough of them, this many at a time.
+ */
+#define MIN_PARALLEL_SETS 64
+#define MAX_PARALLEL_SETS 4096
+
 #if 0
 /* Debug Tracing */
 int din = 0;
@@ -66,6 +75,21 @@ static char *inputNextLine(inputData * const pvt);
 static void inputNewIncludeFile(inputData * const pvt, const char * const name);
 static void inputErrPrint(const inputData * const pvt);
 
+/* Module to cache the template files.  A templateLine is a line of a
+ * template or included file, or the macro definitions of a substitute
+ * command.  Lines with macro references are compiled.
+ */
+struct templateLine {
+    std::string text;
+    MAC_TEMPLATE *compiled;
+    bool        isSubstitute;
+};
+typedef std::vector<templateLine> templateData;
+
+static const templateData& templateGet(inputData * const pvt,
+                                       const char * const templateName);
+static void templateFreeAll(inputData * const pvt);
+
 /* Module to read the substitution file */
 typedef struct subInfo subInfo;
 
@@ -79,11 +103,17 @@ static const char *substituteGetGlobalReplacements(subInfo * const pvt);
 /* Forward references to local routines */
 static void usageExit(const int status);
 static void abortExit(const int status);
+static const char *installMacros(MAC_HANDLE * const macPvt,
+                                 const char * const pval);
 static void addMacroReplacements(MAC_HANDLE * const macPvt,
                                  const char * const pval);
 static void makeSubstitutions(inputData * const inputPvt,
                               MAC_HANDLE * const macPvt,
                               const char * const templateName);
+static void makeSubstitutionSets(inputData * const inputPvt,
+                                 const char * const templateName,
+                                 const std::vector<std::string>& globals,
+                                 const std::vector<std::string>& sets);
 
 /*Global variables */
 static int opt_V = 0;
@@ -92,6 +122,9 @@ static bool opt_D = false;
 static char *outFile = 0;
 static int numDeps = 0, depHashes[MAX_DEPS];
 
+static epicsThreadPool *pool = 0;
+static size_t poolThreads = 0;
+
 
 int main(int argc,char **argv)
 {
@@ -101,6 +134,7 @@ int main(int argc,char **argv)
     std::string substitutionName;
     char *templateName = 0;
     bool localScope = true;
+    std::vector<std::string> globals;
 
     inputConstruct(&inputPvt);
     macCreateHandle(&macPvt, 0);
@@ -120,6 +154,7 @@ int main(int argc,char **argv)
         }
         else if(strncmp(argv[1], "-M", 2) == 0) {
             addMacroReplacements(macPvt, pval);
+            globals.push_back(pval);
         }
         else if(strncmp(argv[1], "-S", 2) == 0) {
             substitutionName = pval;
@@ -185,8 +220,10 @@ int main(int argc,char **argv)
             if (isGlobal) {
                 STEP("Handling global macros");
                 const char *macStr = substituteGetGlobalReplacements(substitutePvt);
-                if (macStr)
+                if (macStr) {
                     addMacroReplacements(macPvt, macStr);
+                    globals.push_back(macStr);
+                }
             }
             else if ((isFile = substituteGetNextSet(substitutePvt, &filename))) {
                 if (templateName)
@@ -198,7 +235,24 @@ int main(int argc,char **argv)
 
                 STEPS("Handling template file", filename);
                 const char *macStr;
-                while ((macStr = substituteGetReplacements(substitutePvt))) {
+                if (localScope && !opt_V && !opt_D) {
+                    /* Each set can be expanded separately.  The filename
+                     * is freed at the end of the file block, copy it.
+                     */
+                    std::string name(filename);
+                    std::vector<std::string> sets;
+
+                    while ((macStr = substituteGetReplacements(substitutePvt))) {
+                        sets.push_back(macStr);
+                        if (sets.size() == MAX_PARALLEL_SETS) {
+                            makeSubstitutionSets(inputPvt, name.c_str(),
+                                                 globals, sets);
+                            sets.clear();
+                        }
+                    }
+                    makeSubstitutionSets(inputPvt, name.c_str(), globals, sets);
+                }
+                else while ((macStr = substituteGetReplacements(substitutePvt))) {
                     if (localScope)
                         macPushScope(macPvt);
 
@@ -212,6 +266,8 @@ int main(int argc,char **argv)
         } while (isGlobal || isFile);
         substituteDestruct(substitutePvt);
     }
+    if (pool)
+        epicsThreadPoolDestroy(pool);
     macDeleteHandle(macPvt);
     errlogFlush();  // macLib calls errlogPrintf()
     inputDestruct(inputPvt);
@@ -250,121 +306,214 @@ void abortExit(const int status)
     exit(status);
 }
 
-static void addMacroReplacements(MAC_HANDLE * const macPvt,
+/* Returns 0, or a message if pval can't be installed */
+static const char *installMacros(MAC_HANDLE * const macPvt,
                                  const char * const pval)
 {
     char **pairs;
     long status;
 
     status = macParseDefns(macPvt, pval, &pairs);
-    if (status == -1) {
-        fprintf(stderr, "msi: Error from macParseDefns\n");
-        usageExit(1);
-    }
+    if (status == -1)
+        return "msi: Error from macParseDefns";
     if (status) {
         status = macInstallMacros(macPvt, pairs);
-        if (!status) {
-            fprintf(stderr, "Error from macInstallMacros\n");
-            usageExit(1);
-        }
         free(pairs);
+        if (!status)
+            return "Error from macInstallMacros";
     }
+    return 0;
 }
 
-typedef enum {cmdInclude,cmdSubstitute} cmdType;
-static const char *cmdNames[] = {"include","substitute"};
+static void addMacroReplacements(MAC_HANDLE * const macPvt,
+                                 const char * const pval)
+{
+    const char *error = installMacros(macPvt, pval);
+
+    if (error) {
+        fprintf(stderr, "%s\n", error);
+        usageExit(1);
+    }
+}
+
+/* Expand a template, appending the result to output.
+ * Returns 0, or a message if a substitute command failed.
+ */
+static const char *expandTemplate(const templateData& tmpl,
+                                  MAC_HANDLE * const macPvt,
+                                  std::string& output, bool& undefined)
+{
+    char buffer[MAX_BUFFER_SIZE];
+
+    ENTER;
+    for (templateData::const_iterator it = tmpl.begin();
+         it != tmpl.end(); ++it) {
+        if (it->isSubstitute) {
+            const char *error = installMacros(macPvt, it->text.c_str());
+
+            if (error) {
+                EXITS(error);
+                return error;
+            }
+        }
+        else if (opt_D) {
+            continue;
+        }
+        else if (!it->compiled) {
+            output += it->text;
+        }
+        else {
+            STEP("Expanding to output");
+            if (macExpandTemplate(macPvt, it->compiled, buffer,
+                                  MAX_BUFFER_SIZE - 1) < 0)
+                undefined = true;
+            output += buffer;
+        }
+    }
+    EXIT;
+    return 0;
+}
 
 static void makeSubstitutions(inputData * const inputPvt,
                               MAC_HANDLE * const macPvt,
                               const char * const templateName)
 {
-    char *input;
-    static char buffer[MAX_BUFFER_SIZE];
-    int  n;
+    const templateData& tmpl = templateGet(inputPvt, templateName);
+    std::string output;
+    bool undefined = false;
+    const char *error;
 
     ENTER;
-    inputBegin(inputPvt, templateName);
-    while ((input = inputNextLine(inputPvt))) {
-        int     expand=1;
-        char    *p;
-        char    *command = 0;
+    error = expandTemplate(tmpl, macPvt, output, undefined);
+    fputs(output.c_str(), stdout);
+    if (error) {
+        fprintf(stderr, "%s\n", error);
+        usageExit(1);
+    }
+    if (opt_V == 1 && undefined) {
+        fprintf(stderr, "msi: Error - undefined macros present\n");
+        opt_V++;
+    }
+    EXIT;
+}
 
-        p = input;
-        /*skip whitespace at beginning of line*/
-        while (*p && (isspace((int) *p))) ++p;
+/* A range of substitution sets, expanded by a thread pool worker with
+ * its own macro handle.
+ */
+typedef struct expandJob {
+    const templateData *tmpl;
+    const std::vector<std::string> *globals;
+    const std::string *sets;
+    std::string *outputs;
+    size_t count;
+    size_t done;
+    const char *error;
+    epicsJob *pjob;
+} expandJob;
+
+static void expandJobRun(void *arg, epicsJobMode mode)
+{
+    expandJob *job = static_cast<expandJob *>(arg);
+    MAC_HANDLE *macPvt;
+    bool undefined = false;
 
-        /*Look for i or s */
-        if (*p && (*p=='i' || *p=='s'))
-            command = p;
+    if (mode != epicsJobModeRun)
+        return;
 
-        if (command) {
-            char *pstart;
-            char *pend;
-            int  cmdind=-1;
-            size_t  i;
+    if (macCreateHandle(&macPvt, 0)) {
+        job->error = "msi: Can't create macro handle";
+        return;
+    }
+    macSuppressWarning(macPvt, 1);
+    for (size_t i = 0; !job->error && i < job->globals->size(); i++)
+        job->error = installMacros(macPvt, (*job->globals)[i].c_str());
+
+    while (!job->error && job->done < job->count) {
+        macPushScope(macPvt);
+        job->error = installMacros(macPvt, job->sets[job->done].c_str());
+        if (!job->error)
+            job->error = expandTemplate(*job->tmpl, macPvt,
+                                        job->outputs[job->done], undefined);
+        macPopScope(macPvt);
+        if (!job->error)
+            job->done++;
+    }
+    macDeleteHandle(macPvt);
+}
 
-            for (i = 0; i < NELEMENTS(cmdNames); i++) {
-                if (strstr(command, cmdNames[i])) {
-                    cmdind = (int)i;
-                }
-            }
-            if (cmdind < 0) goto endcmd;
-            p = command + strlen(cmdNames[cmdind]);
-            /*skip whitespace after command*/
-            while (*p && (isspace((int) *p))) ++p;
-            /*Next character must be quote*/
-            if ((*p == 0) || (*p != '"')) goto endcmd;
-            pstart = ++p;
-            /*Look for end quote*/
-            while (*p && (*p != '"')) {
-                /*allow escape for embeded quote*/
-                if ((p[0] == '\\') && p[1] == '"') {
-                    p += 2;
-                    continue;
-                }
-                else {
-                    if (*p == '"') break;
-                }
-                ++p;
-            }
-            pend = p;
-            if (*p == 0) goto endcmd;
-            /*skip quote and any trailing blanks*/
-            while (*++p == ' ') ;
-            if (*p != '\n' && *p != 0) goto endcmd;
-            std::string copy = std::string(pstart, pend);
+/* Expand the substitution sets of a file block, each in its own scope
+ * and starting from the global definitions.  Large blocks are split
+ * between the threads of a pool, the output is written in order.
+ */
+static void makeSubstitutionSets(inputData * const inputPvt,
+                                 const char * const templateName,
+                                 const std::vector<std::string>& globals,
+                                 const std::vector<std::string>& sets)
+{
+    size_t nsets = sets.size();
+    size_t njobs;
 
-            switch(cmdind) {
-            case cmdInclude:
-                inputNewIncludeFile(inputPvt, copy.c_str());
-                break;
+    ENTER;
+    if (nsets == 0)
+        return;
 
-            case cmdSubstitute:
-                addMacroReplacements(macPvt, copy.c_str());
-                break;
+    const templateData& tmpl = templateGet(inputPvt, templateName);
 
-            default:
-                fprintf(stderr, "msi: Logic error in makeSubstitutions\n");
-                inputErrPrint(inputPvt);
-                abortExit(1);
-            }
-            expand = 0;
-        }
+    if (!pool && nsets >= MIN_PARALLEL_SETS) {
+        epicsThreadPoolConfig conf;
 
-endcmd:
-        if (expand && !opt_D) {
-            STEP("Expanding to output stream");
-            n = macExpandString(macPvt, input, buffer, MAX_BUFFER_SIZE - 1);
-            fputs(buffer, stdout);
-            if (opt_V == 1 && n < 0) {
-                fprintf(stderr, "msi: Error - undefined macros present\n");
-                opt_V++;
-            }
+        epicsThreadPoolConfigDefaults(&conf);
+        if (conf.maxThreads > 1) {
+            pool = epicsThreadPoolCreate(&conf);
+            poolThreads = conf.maxThreads;
+        }
+    }
+    njobs = 1;
+    if (pool && nsets >= MIN_PARALLEL_SETS)
+        njobs = poolThreads * 4;    /* a few per thread to balance the load */
+    if (njobs > nsets)
+        njobs = nsets;
+
+    std::vector<std::string> outputs(nsets);
+    std::vector<expandJob> jobs(njobs);
+    size_t first = 0;
+
+    for (size_t i = 0; i < njobs; i++) {
+        expandJob& job = jobs[i];
+        size_t last = nsets * (i + 1) / njobs;
+
+        job.tmpl = &tmpl;
+        job.globals = &globals;
+        job.sets = &sets[first];
+        job.outputs = &outputs[first];
+        job.count = last - first;
+        job.done = 0;
+        job.error = 0;
+        job.pjob = njobs > 1 ? epicsJobCreate(pool, expandJobRun, &job) : 0;
+        first = last;
+
+        if (job.pjob && !epicsJobQueue(job.pjob))
+            continue;
+        expandJobRun(&job, epicsJobModeRun);
+    }
+    if (njobs > 1)
+        epicsThreadPoolWait(pool, -1.0);
+
+    for (size_t i = 0; i < njobs; i++) {
+        expandJob& job = jobs[i];
+
+        if (job.pjob)
+            epicsJobDestroy(job.pjob);
+        for (size_t j = 0; j < job.done; j++)
+            fputs(job.outputs[j].c_str(), stdout);
+        if (job.error) {
+            fprintf(stderr, "%s\n", job.error);
+            usageExit(1);
         }
     }
     EXIT;
 }
-
+
 typedef struct inputFile {
     std::string filename;
     FILE        *fp;
@@ -374,6 +523,7 @@ typedef struct inputFile {
 struct inputData {
     std::list<inputFile> inputFileList;
     std::list<std::string> pathList;
+    std::map<std::string, templateData> templates;
     char        inputBuffer[MAX_BUFFER_SIZE];
     inputData() { memset(inputBuffer, 0, sizeof(inputBuffer) * sizeof(inputBuffer[0])); };
 };
@@ -390,6 +540,7 @@ static void inputConstruct(inputData **ppvt)
 static void inputDestruct(inputData * const pinputData)
 {
     inputCloseAllFiles(pinputData);
+    templateFreeAll(pinputData);
     delete(pinputData);
 }
 
@@ -593,6 +744,133 @@ static void inputCloseAllFiles(inputData *pinputData)
     EXIT;
 }
 
+typedef enum {cmdInclude,cmdSubstitute} cmdType;
+static const char *cmdNames[] = {"include","substitute"};
+
+/* Returns the template, reading it the first time it is used.  Include
+ * files are read in place, so the template is a flat list of lines.
+ */
+static const templateData& templateGet(inputData * const pinputData,
+                                       const char * const templateName)
+{
+    std::string key = templateName ? templateName : "";
+    std::map<std::string, templateData>::iterator tmplIt =
+        pinputData->templates.find(key);
+    char *input;
+
+    ENTER;
+    if (tmplIt != pinputData->templates.end()) {
+        EXIT;
+        return tmplIt->second;
+    }
+
+    templateData& tmpl = pinputData->templates[key];
+
+    inputBegin(pinputData, templateName);
+    while ((input = inputNextLine(pinputData))) {
+        templateLine line;
+        char    *p;
+        char    *command = 0;
+
+        line.text = input;
+        line.compiled = 0;
+        line.isSubstitute = false;
+
+        p = input;
+        /*skip whitespace at beginning of line*/
+        while (*p && (isspace((int) *p))) ++p;
+
+        /*Look for i or s */
+        if (*p && (*p=='i' || *p=='s'))
+            command = p;
+
+        if (command) {
+            char *pstart;
+            char *pend;
+            int  cmdind=-1;
+            size_t  i;
+
+            for (i = 0; i < NELEMENTS(cmdNames); i++) {
+                if (strstr(command, cmdNames[i])) {
+                    cmdind = (int)i;
+                }
+            }
+            if (cmdind < 0) goto endcmd;
+            p = command + strlen(cmdNames[cmdind]);
+            /*skip whitespace after command*/
+            while (*p && (isspace((int) *p))) ++p;
+            /*Next character must be quote*/
+            if ((*p == 0) || (*p != '"')) goto endcmd;
+            pstart = ++p;
+            /*Look for end quote*/
+            while (*p && (*p != '"')) {
+                /*allow escape for embeded quote*/
+                if ((p[0] == '\\') && p[1] == '"') {
+                    p += 2;
+                    continue;
+                }
+                else {
+                    if (*p == '"') break;
+                }
+                ++p;
+            }
+            pend = p;
+            if (*p == 0) goto endcmd;
+            /*skip quote and any trailing blanks*/
+            while (*++p == ' ') ;
+            if (*p != '\n' && *p != 0) goto endcmd;
+            std::string copy = std::string(pstart, pend);
+
+            switch(cmdind) {
+            case cmdInclude:
+                inputNewIncludeFile(pinputData, copy.c_str());
+                break;
+
+            case cmdSubstitute:
+                line.text = copy;
+                line.isSubstitute = true;
+                tmpl.push_back(line);
+                break;
+
+            default:
+                fprintf(stderr, "msi: Logic error in templateGet\n");
+                inputErrPrint(pinputData);
+                abortExit(1);
+            }
+            continue;
+        }
+
+endcmd:
+        if (strchr(input, '$')) {
+            line.compiled = macCompileTemplate(input);
+            if (!line.compiled) {
+                fprintf(stderr, "msi: Can't compile template line\n");
+                inputErrPrint(pinputData);
+                abortExit(1);
+            }
+        }
+        tmpl.push_back(line);
+    }
+    EXIT;
+    return tmpl;
+}
+
+static void templateFreeAll(inputData * const pinputData)
+{
+    std::map<std::string, templateData>::iterator tmplIt;
+
+    ENTER;
+    for (tmplIt = pinputData->templates.begin();
+         tmplIt != pinputData->templates.end(); ++tmplIt) {
+        templateData& tmpl = tmplIt->second;
+
+        for (templateData::iterator it = tmpl.begin(); it != tmpl.end(); ++it)
+            macDeleteTemplate(it->compiled);
+    }
+    pinputData->templates.clear();
+    EXIT;
+}
+
 /*start of code that handles substitution file*/
 typedef enum {
     tokenLBrace, tokenRBrace, tokenSeparator, tokenString, tokenEOF
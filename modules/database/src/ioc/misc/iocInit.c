@@ -125,6 +125,7 @@ static int iocBuild_1(void)
     }
 
     errlogPrintf("Starting iocInit\n");
+    dbLoadRecordsWait();
     if (checkDatabase(pdbbase)) {
         errlogPrintf("iocBuild: Aborting, bad database definition (DBD)!\n");
         return -1;
@@ -49,6 +49,15 @@ static long init_record(dbCommon *pcommon)
 
 static long read_histogram(histogramRecord *prec)
 {
+    if (prec->nsmp > 0 && prec->sptr) {
+        long nRequest = prec->nsmp;
+
+        if (dbGetLink(&prec->svl, DBR_DOUBLE, prec->sptr, 0, &nRequest))
+            nRequest = 0;
+        prec->nsrd = nRequest;
+        return 0; /*add counts*/
+    }
+
     dbGetLink(&prec->svl, DBR_DOUBLE, &prec->sgnl, 0, 0);
     return 0; /*add count*/
 }
@@ -12,6 +12,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "chfPlugin.h"
 #include "dbAccessDefs.h"
@@ -30,7 +31,18 @@ typedef struct myStruct {
     long no_elements;
 } myStruct;
 
+/* A slice of an array which another filter already copied, kept in
+ * that copy rather than being copied again.  Holds what is needed to
+ * free the copy when the field_log is deleted.
+ */
+typedef struct arrView {
+    dbfl_freeFunc *dtor;
+    void *pvt;
+    void *field;
+} arrView;
+
 static void *myStructFreeList;
+static void *viewFreeList;
 
 static const chfPluginArgDef opts[] = {
     chfInt32 (myStruct, start, "s", 0, 1),
@@ -70,7 +82,24 @@ static int parse_ok(void *pvt)
 static void freeArray(db_field_log *pfl)
 {
     if (pfl->type == dbfl_type_ref) {
-        freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+        if (pfl->u.r.pvt)
+            freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+        else
+            free(pfl->u.r.field);
+    }
+}
+
+static void freeView(db_field_log *pfl)
+{
+    if (pfl->type == dbfl_type_ref) {
+        arrView *view = (arrView *) pfl->u.r.pvt;
+
+        pfl->u.r.dtor = view->dtor;
+        pfl->u.r.pvt = view->pvt;
+        pfl->u.r.field = view->field;
+        freeListFree(viewFreeList, view);
+        if (pfl->u.r.dtor)
+            pfl->u.r.dtor(pfl);
     }
 }
 
@@ -99,6 +128,7 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
     long end = my->end;
     long nTarget;
     void *pTarget;
+    arrView *view;
     long offset = 0;
     long nSource = pfl->no_elements;
     void *pSource = pfl->u.r.field;
@@ -115,18 +145,38 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
             dbChannelGetArrayInfo(chan, &pSource, &nSource, &offset);
         }
         nTarget = wrapArrayIndices(&start, my->incr, &end, nSource);
-        if (nTarget > 0) {
-            /* copy the data */
-            pTarget = freeListCalloc(my->arrayFreeList);
-            if (!pTarget) break;
-            /* must do the wrap-around with the original no_elements */
-            offset = (offset + start) % pfl->no_elements;
-            dbExtractArray(pSource, pTarget, pfl->field_size,
-                nTarget, pfl->no_elements, offset, my->incr);
-            if (pfl->u.r.dtor) pfl->u.r.dtor(pfl);
-            pfl->u.r.field = pTarget;
-            pfl->u.r.dtor = freeArray;
-            pfl->u.r.pvt = my->arrayFreeList;
+        if (nTarget > 0 && !must_lock && my->incr == 1 &&
+            offset + start + nTarget <= pfl->no_elements &&
+            (view = freeListMalloc(viewFreeList))) {
+            /* contiguous slice of a private copy, just point into it */
+            view->dtor = pfl->u.r.dtor;
+            view->pvt = pfl->u.r.pvt;
+            view->field = pfl->u.r.field;
+            pfl->u.r.field = (char *) pSource +
+                (offset + start) * pfl->field_size;
+            pfl->u.r.dtor = freeView;
+            pfl->u.r.pvt = view;
+        }
+        else if (nTarget > 0) {
+            /* copy the data, every element gets overwritten */
+            if (nTarget == my->no_elements) {
+                pTarget = freeListMalloc(my->arrayFreeList);
+            } else {
+                pTarget = malloc(nTarget * pfl->field_size);
+            }
+            if (pTarget) {
+                /* must do the wrap-around with the original no_elements */
+                offset = (offset + start) % pfl->no_elements;
+                dbExtractArray(pSource, pTarget, pfl->field_size,
+                    nTarget, pfl->no_elements, offset, my->incr);
+                if (pfl->u.r.dtor) pfl->u.r.dtor(pfl);
+                pfl->u.r.field = pTarget;
+                pfl->u.r.dtor = freeArray;
+                pfl->u.r.pvt = nTarget == my->no_elements ?
+                    my->arrayFreeList : NULL;
+            } else {
+                nTarget = 0;
+            }
         }
         /* adjust no_elements (even if zero elements remain) */
         pfl->no_elements = nTarget;
@@ -185,12 +235,17 @@ static void arrShutdown(void* ignore)
     if(myStructFreeList)
         freeListCleanup(myStructFreeList);
     myStructFreeList = NULL;
+    if(viewFreeList)
+        freeListCleanup(viewFreeList);
+    viewFreeList = NULL;
 }
 
 static void arrInitialize(void)
 {
     if (!myStructFreeList)
         freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+    if (!viewFreeList)
+        freeListInitPvt(&viewFreeList, sizeof(arrView), 64);
 
     chfPluginRegister("arr", &pif, opts);
     epicsAtExit(arrShutdown, NULL);
@@ -0,0 +1,394 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Binning filter: reduces a numeric array to n points, each one the mean,
+ * min/max envelope or a representative sample (largest triangle three
+ * buckets) of a bin of consecutive elements.  The result is DBF_DOUBLE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "chfPlugin.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbLock.h"
+#include "epicsExit.h"
+#include "epicsMath.h"
+#include "epicsTypes.h"
+#include "freeList.h"
+#include "epicsExport.h"
+
+typedef enum {
+    binMean,
+    binMinMax,
+    binLttb
+} binMode;
+
+typedef struct myStruct {
+    epicsInt32 n;
+    int mode;
+    void *arrayFreeList;
+    long no_elements;
+} myStruct;
+
+static void *myStructFreeList;
+
+static const
+chfPluginEnumType modeEnum[] = {
+    {"mean", binMean}, {"minmax", binMinMax}, {"lttb", binLttb}, {NULL, 0}
+};
+
+static const chfPluginArgDef opts[] = {
+    chfInt32 (myStruct, n, "n", 1, 1),
+    chfEnum  (myStruct, mode, "m", 0, 1, modeEnum),
+    chfPluginArgEnd
+};
+
+/* Accumulated over the elements of one bin */
+typedef struct binAcc {
+    double sum;
+    double min;
+    double max;
+} binAcc;
+
+typedef void (accFunc)(const void *pdata, long count, binAcc *acc);
+typedef double (getFunc)(const void *pdata, long index);
+
+/* Kernels over contiguous elements of each type.  The loops are kept
+ * simple, with separate accumulators and no calls, so that compilers can
+ * vectorize them.
+ */
+#define BIN_KERNELS(TYPE) \
+static void acc_##TYPE(const void *pdata, long count, binAcc *acc) \
+{ \
+    const TYPE *p = (const TYPE *) pdata; \
+    double sum = 0, min = acc->min, max = acc->max; \
+    long i; \
+ \
+    for (i = 0; i < count; i++) { \
+        double v = p[i]; \
+        sum += v; \
+        min = v < min ? v : min; \
+        max = v > max ? v : max; \
+    } \
+    acc->sum += sum; \
+    acc->min = min; \
+    acc->max = max; \
+} \
+static double get_##TYPE(const void *pdata, long index) \
+{ \
+    return ((const TYPE *) pdata)[index]; \
+}
+
+BIN_KERNELS(epicsInt8)
+BIN_KERNELS(epicsUInt8)
+BIN_KERNELS(epicsInt16)
+BIN_KERNELS(epicsUInt16)
+BIN_KERNELS(epicsInt32)
+BIN_KERNELS(epicsUInt32)
+BIN_KERNELS(epicsInt64)
+BIN_KERNELS(epicsUInt64)
+BIN_KERNELS(epicsFloat32)
+BIN_KERNELS(epicsFloat64)
+
+static int findKernels(short field_type, accFunc **pacc, getFunc **pget)
+{
+    switch (field_type) {
+#define CASE(DBF, TYPE) \
+    case DBF: *pacc = acc_##TYPE; *pget = get_##TYPE; return 0;
+    CASE(DBF_CHAR, epicsInt8)
+    CASE(DBF_UCHAR, epicsUInt8)
+    CASE(DBF_SHORT, epicsInt16)
+    CASE(DBF_USHORT, epicsUInt16)
+    CASE(DBF_ENUM, epicsUInt16)
+    CASE(DBF_LONG, epicsInt32)
+    CASE(DBF_ULONG, epicsUInt32)
+    CASE(DBF_INT64, epicsInt64)
+    CASE(DBF_UINT64, epicsUInt64)
+    CASE(DBF_FLOAT, epicsFloat32)
+    CASE(DBF_DOUBLE, epicsFloat64)
+#undef CASE
+    default:
+        return -1;
+    }
+}
+
+/* The source array, which may wrap around the end of its buffer */
+typedef struct binSource {
+    const char *base;
+    long capacity;      /* elements in the buffer */
+    long offset;        /* physical index of logical element 0 */
+    short size;
+    accFunc *acc;
+    getFunc *get;
+} binSource;
+
+/* Accumulate logical elements [first, last) */
+static void accumulate(const binSource *src, long first, long last,
+    binAcc *acc)
+{
+    long start = (src->offset + first) % src->capacity;
+    long count = last - first;
+    long upper = src->capacity - start;
+
+    acc->sum = 0;
+    acc->min = epicsINF;
+    acc->max = -epicsINF;
+    if (count <= upper) {
+        src->acc(src->base + start * src->size, count, acc);
+    } else {
+        src->acc(src->base + start * src->size, upper, acc);
+        src->acc(src->base, count - upper, acc);
+    }
+}
+
+static double valueAt(const binSource *src, long index)
+{
+    return src->get(src->base,
+        (src->offset + index) % src->capacity);
+}
+
+/* Element where bin i of nbins starts, distributing any remainder */
+#define BIN_START(i, nelem, nbins) \
+    ((long) ((epicsInt64) (i) * (nelem) / (nbins)))
+
+static void binMeanOrEnvelope(const binSource *src, long nelem, long nbins,
+    int minmax, double *pout)
+{
+    long i;
+
+    for (i = 0; i < nbins; i++) {
+        long first = BIN_START(i, nelem, nbins);
+        long last = BIN_START(i + 1, nelem, nbins);
+        binAcc acc;
+
+        accumulate(src, first, last, &acc);
+        if (minmax) {
+            *pout++ = acc.min;
+            *pout++ = acc.max;
+        } else {
+            *pout++ = acc.sum / (last - first);
+        }
+    }
+}
+
+/* Largest triangle three buckets: keep the first and last elements, and
+ * from each of the bins between them the element that makes the largest
+ * triangle with the element kept from the previous bin and the mean of
+ * the next bin.
+ */
+static void binLargestTriangle(const binSource *src, long nelem, long nbins,
+    double *pout)
+{
+    long prev = 0;
+    long i;
+
+    if (nbins < 3 || nelem <= nbins) {
+        binMeanOrEnvelope(src, nelem, nbins, 0, pout);
+        return;
+    }
+
+    pout[0] = valueAt(src, 0);
+    for (i = 1; i < nbins - 1; i++) {
+        /* the inner bins share out elements 1 .. nelem-2 */
+        long first = 1 + BIN_START(i - 1, nelem - 2, nbins - 2);
+        long last = 1 + BIN_START(i, nelem - 2, nbins - 2);
+        long nextLast = i == nbins - 2 ? nelem :
+            1 + BIN_START(i + 1, nelem - 2, nbins - 2);
+        double prevVal = valueAt(src, prev);
+        double avgX = (last + nextLast - 1) / 2.0;
+        double avgY, maxArea = -1;
+        long best = first;
+        long j;
+        binAcc acc;
+
+        accumulate(src, last, nextLast, &acc);
+        avgY = acc.sum / (nextLast - last);
+
+        for (j = first; j < last; j++) {
+            double area = fabs((prev - avgX) * (valueAt(src, j) - prevVal) -
+                (prev - j) * (avgY - prevVal));
+
+            if (area > maxArea) {
+                maxArea = area;
+                best = j;
+            }
+        }
+        pout[i] = valueAt(src, best);
+        prev = best;
+    }
+    pout[nbins - 1] = valueAt(src, nelem - 1);
+}
+
+static void * allocPvt(void)
+{
+    myStruct *my = (myStruct*) freeListCalloc(myStructFreeList);
+    if (!my) return NULL;
+
+    my->mode = binMean;
+    return (void *) my;
+}
+
+static void freePvt(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->arrayFreeList) freeListCleanup(my->arrayFreeList);
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->n < 1)
+        return -1;
+    return 0;
+}
+
+static void freeArray(db_field_log *pfl)
+{
+    if (pfl->type == dbfl_type_ref) {
+        freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+    }
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    int must_lock;
+    binSource src;
+    long nSource = pfl->no_elements;
+    void *pSource = pfl->u.r.field;
+    long offset = 0;
+    long nbins = 0;
+    double *pTarget;
+
+    if (pfl->type != dbfl_type_ref)
+        return pfl;
+
+    if (findKernels(pfl->field_type, &src.acc, &src.get)) {
+        /* Not a type we can bin; pass on nothing rather than mistyped data */
+        if (pfl->u.r.dtor) pfl->u.r.dtor(pfl);
+        pfl->u.r.dtor = NULL;
+        pfl->no_elements = 0;
+        pfl->field_type = DBF_DOUBLE;
+        pfl->field_size = sizeof(epicsFloat64);
+        return pfl;
+    }
+
+    must_lock = !pfl->u.r.dtor;
+    if (must_lock) {
+        dbScanLock(dbChannelRecord(chan));
+        dbChannelGetArrayInfo(chan, &pSource, &nSource, &offset);
+    }
+    if (nSource > pfl->no_elements)
+        nSource = pfl->no_elements;
+
+    nbins = nSource < my->n ? nSource : my->n;
+    pTarget = nbins > 0 ? freeListMalloc(my->arrayFreeList) : NULL;
+    if (pTarget) {
+        src.base = (const char *) pSource;
+        src.capacity = pfl->no_elements;
+        src.offset = offset % pfl->no_elements;
+        src.size = pfl->field_size;
+
+        if (my->mode == binLttb)
+            binLargestTriangle(&src, nSource, nbins, pTarget);
+        else
+            binMeanOrEnvelope(&src, nSource, nbins,
+                my->mode == binMinMax, pTarget);
+    }
+    else {
+        nbins = 0;
+    }
+    if (must_lock)
+        dbScanUnlock(dbChannelRecord(chan));
+
+    if (pfl->u.r.dtor) pfl->u.r.dtor(pfl);
+    pfl->field_type = DBF_DOUBLE;
+    pfl->field_size = sizeof(epicsFloat64);
+    if (pTarget) {
+        pfl->u.r.field = pTarget;
+        pfl->u.r.dtor = freeArray;
+        pfl->u.r.pvt = my->arrayFreeList;
+    }
+    else {
+        pfl->u.r.dtor = NULL;
+    }
+    pfl->no_elements = my->mode == binMinMax ? 2 * nbins : nbins;
+    return pfl;
+}
+
+static void channelRegisterPost(dbChannel *chan, void *pvt,
+    chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    myStruct *my = (myStruct*) pvt;
+    accFunc *acc;
+    getFunc *get;
+    long max;
+
+    if (probe->no_elements <= 1) return;    /* array data only */
+    if (findKernels(probe->field_type, &acc, &get)) return;
+
+    max = probe->no_elements < my->n ? probe->no_elements : my->n;
+    if (my->mode == binMinMax)
+        max *= 2;
+    if (!my->arrayFreeList)
+        freeListInitPvt(&my->arrayFreeList, max * sizeof(epicsFloat64), 2);
+    if (!my->arrayFreeList) return;
+
+    probe->field_type = DBF_DOUBLE;
+    probe->field_size = sizeof(epicsFloat64);
+    probe->no_elements = my->no_elements = max;
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level,
+    const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+    printf("%*sBinning (bin): n=%d, m=%s\n", indent, "",
+           my->n, chfPluginEnumString(modeEnum, my->mode, "n/a"));
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    NULL, /* channel_open, */
+    NULL, /* channelRegisterPre, */
+    channelRegisterPost,
+    channel_report,
+    NULL /* channel_close */
+};
+
+static void binShutdown(void* ignore)
+{
+    if(myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void binInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+
+    chfPluginRegister("bin", &pif, opts);
+    epicsAtExit(binShutdown, NULL);
+}
+
+epicsExportRegistrar(binInitialize);
@@ -13,11 +13,15 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include <epicsMath.h>
 #include <freeList.h>
 #include <dbConvertFast.h>
 #include <chfPlugin.h>
+#include <dbLock.h>
 #include <recGbl.h>
 #include <epicsExit.h>
 #include <db_field_log.h>
@@ -28,6 +32,10 @@ typedef struct myStruct {
     double cval;
     double hyst;
     double last;
+    /* The last array sent */
+    void  *lastArray;
+    long   lastCount;
+    long   lastSize;   /* bytes allocated */
 } myStruct;
 
 static void *myStructFreeList;
@@ -44,6 +52,69 @@ chfPluginArgDef opts[] = {
     chfPluginArgEnd
 };
 
+/* Element-wise deadband kernels: is any element of pnew outside the
+ * deadband around the same element of plast?  The inner loop over a block
+ * has no early exit so that compilers can vectorize it.  Elements that are
+ * NaN in both arrays are unchanged.
+ */
+#define DBND_BLOCK 256
+
+#define DBND_KERNEL(TYPE) \
+static int changed_##TYPE(const void *pnew, const void *plast, long count, \
+    double abs, double rel) \
+{ \
+    const TYPE *a = (const TYPE *) pnew; \
+    const TYPE *b = (const TYPE *) plast; \
+    long i, j; \
+ \
+    for (i = 0; i < count; i += DBND_BLOCK) { \
+        long end = i + DBND_BLOCK < count ? i + DBND_BLOCK : count; \
+        int any = 0; \
+ \
+        for (j = i; j < end; j++) { \
+            double x = a[j], y = b[j]; \
+ \
+            any |= x != y && !(fabs(x - y) <= abs + rel * fabs(y)) && \
+                (x == x || y == y); \
+        } \
+        if (any) \
+            return 1; \
+    } \
+    return 0; \
+}
+
+typedef int (changedFunc)(const void *pnew, const void *plast, long count,
+    double abs, double rel);
+
+DBND_KERNEL(epicsInt8)
+DBND_KERNEL(epicsUInt8)
+DBND_KERNEL(epicsInt16)
+DBND_KERNEL(epicsUInt16)
+DBND_KERNEL(epicsInt32)
+DBND_KERNEL(epicsUInt32)
+DBND_KERNEL(epicsInt64)
+DBND_KERNEL(epicsUInt64)
+DBND_KERNEL(epicsFloat32)
+DBND_KERNEL(epicsFloat64)
+
+static changedFunc * findKernel(short field_type)
+{
+    switch (field_type) {
+    case DBF_CHAR:      return changed_epicsInt8;
+    case DBF_UCHAR:     return changed_epicsUInt8;
+    case DBF_SHORT:     return changed_epicsInt16;
+    case DBF_USHORT:
+    case DBF_ENUM:      return changed_epicsUInt16;
+    case DBF_LONG:      return changed_epicsInt32;
+    case DBF_ULONG:     return changed_epicsUInt32;
+    case DBF_INT64:     return changed_epicsInt64;
+    case DBF_UINT64:    return changed_epicsUInt64;
+    case DBF_FLOAT:     return changed_epicsFloat32;
+    case DBF_DOUBLE:    return changed_epicsFloat64;
+    default:            return NULL;
+    }
+}
+
 static void * allocPvt(void)
 {
     return freeListCalloc(myStructFreeList);
@@ -51,6 +122,9 @@ static void * allocPvt(void)
 
 static void freePvt(void *pvt)
 {
+    myStruct *my = (myStruct*) pvt;
+
+    free(my->lastArray);
     freeListFree(myStructFreeList, pvt);
 }
 
@@ -59,9 +133,86 @@ static int parse_ok(void *pvt)
     myStruct *my = (myStruct*) pvt;
     my->hyst = my->cval;
     my->last = epicsNAN;
+    my->lastCount = -1;
     return 0;
 }
 
+/* Compare an array update with the last one sent, and remember it if it
+ * is to be sent.  The array starts at element offset of a buffer holding
+ * capacity elements and may wrap around its end.
+ */
+static unsigned arrayChanged(myStruct *my, const db_field_log *pfl,
+    const char *pbase, long capacity, long offset, long count)
+{
+    changedFunc *changed = NULL;
+    long size = pfl->field_size;
+    long first = capacity - offset < count ? capacity - offset : count;
+    const char *pfirst = pbase + offset * size;
+    const char *plast = (const char *) my->lastArray;
+
+    if (my->cval > 0 && pfl->field_type != DBF_STRING)
+        changed = findKernel(pfl->field_type);
+
+    if (count == my->lastCount) {
+        int send;
+
+        if (changed) {
+            double abs = my->mode == 1 ? 0 : my->cval;
+            double rel = my->mode == 1 ? my->cval / 100. : 0;
+
+            send = changed(pfirst, plast, first, abs, rel) ||
+                changed(pbase, plast + first * size, count - first, abs, rel);
+        }
+        else {
+            send = memcmp(pfirst, plast, first * size) ||
+                memcmp(pbase, plast + first * size, (count - first) * size);
+        }
+        if (!send)
+            return 0;
+    }
+
+    if (count * size > my->lastSize) {
+        void *ptr = realloc(my->lastArray, count * size);
+
+        if (!ptr) {
+            /* Can't compare the next update, so send that too */
+            my->lastCount = -1;
+            return 1;
+        }
+        my->lastArray = ptr;
+        my->lastSize = count * size;
+    }
+    memcpy(my->lastArray, pfirst, first * size);
+    memcpy((char *) my->lastArray + first * size, pbase, (count - first) * size);
+    my->lastCount = count;
+    return 1;
+}
+
+static unsigned filterArray(myStruct *my, dbChannel *chan,
+    const db_field_log *pfl)
+{
+    void *pbase = pfl->u.r.field;
+    long capacity = pfl->no_elements;
+    long count = pfl->no_elements;
+    long offset = 0;
+    unsigned send;
+
+    if (my->cval < 0 || capacity <= 0)
+        return 1;
+
+    if (pfl->u.r.dtor)
+        return arrayChanged(my, pfl, pbase, capacity, offset, count);
+
+    /* The data is still owned by the record */
+    dbScanLock(dbChannelRecord(chan));
+    dbChannelGetArrayInfo(chan, &pbase, &count, &offset);
+    if (count > capacity)
+        count = capacity;
+    send = arrayChanged(my, pfl, pbase, capacity, offset % capacity, count);
+    dbScanUnlock(dbChannelRecord(chan));
+    return send;
+}
+
 static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     myStruct *my = (myStruct*) pvt;
     long status;
@@ -69,10 +220,15 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     unsigned send = 1;
 
     /*
-     * Only scalar values supported - strings, arrays, and conversion errors
-     * are just passed on
+     * Arrays are sent if any element is outside the deadband around the
+     * last array sent.  Scalar strings and conversion errors are just
+     * passed on, as are reads of arrays.
      */
-    if (pfl->type == dbfl_type_val) {
+    if (pfl->type == dbfl_type_ref) {
+        if (pfl->ctx == dbfl_context_event)
+            send = filterArray(my, chan, pfl);
+    }
+    else if (pfl->type == dbfl_type_val) {
         DBADDR localAddr = chan->addr; /* Structure copy */
         localAddr.field_type = pfl->field_type;
         localAddr.field_size = pfl->field_size;
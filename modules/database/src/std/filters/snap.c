@@ -0,0 +1,477 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Snapshot filter: holds back the updates of every channel that names the
+ * same group until all of them have an update with the same time stamp,
+ * then releases that set of updates together.  Sets that can't be
+ * completed are dropped, so clients see only whole snapshots.  Only
+ * channels with a monitor count, get-only channels never post updates.
+ * A channel with several monitors runs its updates through here once for
+ * each of them, but holds only one; the released update is sent to all
+ * the monitors that select its events.  The filters after this one in the
+ * pre-event-queue chain are run when an update is released.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "callback.h"
+#include "chfPlugin.h"
+#include "dbAccessDefs.h"
+#include "dbChannel.h"
+#include "dbDefs.h"
+#include "db_field_log.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "dbState.h"
+#include "ellLib.h"
+#include "epicsAtomic.h"
+#include "epicsExit.h"
+#include "epicsMutex.h"
+#include "epicsTime.h"
+#include "freeList.h"
+#include "epicsExport.h"
+
+#define GROUP_NAME_LENGTH 40
+#define STATE_NAME_LENGTH 20
+
+/* Time stamps that may be collecting updates at once, which allows for
+ * updates of the members arriving in different orders.
+ */
+#define SNAP_DEPTH 4
+
+typedef struct snapShot {
+    epicsTimeStamp time;
+    int nHeld;              /* 0 when the slot is free */
+} snapShot;
+
+typedef struct snapGroup {
+    ELLNODE node;
+    char name[GROUP_NAME_LENGTH];
+    epicsMutexId lock;          /* members' held updates and the shots */
+    epicsMutexId releaseLock;   /* membership, held while releasing */
+    ELLLIST members;
+    snapShot shot[SNAP_DEPTH];
+    epicsTimeStamp released;    /* time of the last released snapshot */
+    int haveReleased;
+    epicsCallback cb;
+    unsigned long nReleased;
+    unsigned long nDropped;
+} snapGroup;
+
+typedef struct myStruct {
+    ELLNODE node;           /* in pgroup->members */
+    char group[GROUP_NAME_LENGTH];
+    char state[STATE_NAME_LENGTH];
+    dbStateId id;
+    snapGroup *pgroup;
+    dbChannel *chan;
+    db_field_log *held[SNAP_DEPTH];     /* one for each shot */
+    db_field_log *ready;                /* waiting to be released */
+} myStruct;
+
+static void *myStructFreeList;
+static ELLLIST groups = ELLLIST_INIT;
+static epicsMutexId groupsLock;
+
+static const
+chfPluginArgDef opts[] = {
+    chfString (myStruct, group, "g", 1, 0),
+    chfString (myStruct, state, "s", 0, 0),
+    chfPluginArgEnd
+};
+
+static void releaseSnapshot(epicsCallback *pcb);
+
+/* Find or create a group.  Groups are kept until the IOC exits. */
+static snapGroup * findGroup(const char *name)
+{
+    snapGroup *pgroup;
+
+    epicsMutexMustLock(groupsLock);
+    for (pgroup = (snapGroup *) ellFirst(&groups); pgroup;
+         pgroup = (snapGroup *) ellNext(&pgroup->node)) {
+        if (strcmp(pgroup->name, name) == 0)
+            break;
+    }
+    if (!pgroup) {
+        pgroup = calloc(1, sizeof(snapGroup));
+        if (pgroup) {
+            strcpy(pgroup->name, name);
+            pgroup->lock = epicsMutexCreate();
+            pgroup->releaseLock = epicsMutexCreate();
+            if (!pgroup->lock || !pgroup->releaseLock) {
+                if (pgroup->lock) epicsMutexDestroy(pgroup->lock);
+                if (pgroup->releaseLock) epicsMutexDestroy(pgroup->releaseLock);
+                free(pgroup);
+                pgroup = NULL;
+            }
+            else {
+                callbackSetCallback(releaseSnapshot, &pgroup->cb);
+                callbackSetPriority(priorityHigh, &pgroup->cb);
+                callbackSetUser(pgroup, &pgroup->cb);
+                ellAdd(&groups, &pgroup->node);
+            }
+        }
+    }
+    epicsMutexUnlock(groupsLock);
+    return pgroup;
+}
+
+/* Drop the held updates of shot i.  Call with the group locked. */
+static void dropShot(snapGroup *pgroup, int i)
+{
+    myStruct *my;
+
+    for (my = (myStruct *) ellFirst(&pgroup->members); my;
+         my = (myStruct *) ellNext(&my->node)) {
+        if (my->held[i]) {
+            db_delete_field_log(my->held[i]);
+            my->held[i] = NULL;
+        }
+    }
+    pgroup->shot[i].nHeld = 0;
+    pgroup->nDropped++;
+}
+
+/* Members whose channel has a monitor.  Call with the group locked. */
+static int countMonitored(snapGroup *pgroup)
+{
+    myStruct *my;
+    int n = 0;
+
+    for (my = (myStruct *) ellFirst(&pgroup->members); my;
+         my = (myStruct *) ellNext(&my->node)) {
+        if (epicsAtomicGetIntT(&my->chan->monitors) > 0)
+            n++;
+    }
+    return n;
+}
+
+/* Run the filters which follow this one in the pre-event-queue chain */
+static db_field_log* runRestOfChain(myStruct *my, db_field_log *pfl)
+{
+    ELLNODE *node = ellFirst(&my->chan->pre_chain);
+
+    while (node && CONTAINER(node, chFilter, pre_node)->pre_arg != my)
+        node = ellNext(node);
+    if (node)
+        node = ellNext(node);
+    for (; node && pfl; node = ellNext(node)) {
+        chFilter *filter = CONTAINER(node, chFilter, pre_node);
+
+        pfl = filter->pre_func(filter->pre_arg, my->chan, pfl);
+    }
+    return pfl;
+}
+
+/* Post each member's ready update, in the callback thread so that no
+ * record is locked here while another one's monitor list is taken.
+ */
+static void releaseSnapshot(epicsCallback *pcb)
+{
+    void *pvt;
+    snapGroup *pgroup;
+    myStruct *my;
+
+    callbackGetUser(pvt, pcb);
+    pgroup = (snapGroup *) pvt;
+
+    epicsMutexMustLock(pgroup->releaseLock);
+    for (my = (myStruct *) ellFirst(&pgroup->members); my;
+         my = (myStruct *) ellNext(&my->node)) {
+        db_field_log *pfl;
+
+        epicsMutexMustLock(pgroup->lock);
+        pfl = my->ready;
+        my->ready = NULL;
+        epicsMutexUnlock(pgroup->lock);
+
+        if (pfl)
+            pfl = runRestOfChain(my, pfl);
+        if (pfl)
+            db_post_channel_log(my->chan, pfl);
+    }
+    epicsMutexUnlock(pgroup->releaseLock);
+}
+
+static void freeCopy(db_field_log *pfl)
+{
+    free(pfl->u.r.field);
+}
+
+/* Make pfl own its array data, which may still be changed by the record
+ * while the update is held.
+ */
+static int copyArray(dbChannel *chan, db_field_log *pfl)
+{
+    void *pSource;
+    long nSource, offset = 0;
+    long capacity = pfl->no_elements;
+    char *pTarget;
+
+    dbScanLock(dbChannelRecord(chan));
+    pSource = pfl->u.r.field;
+    nSource = capacity;
+    dbChannelGetArrayInfo(chan, &pSource, &nSource, &offset);
+    if (nSource > capacity)
+        nSource = capacity;
+    pTarget = nSource > 0 ? malloc(nSource * pfl->field_size) : NULL;
+    if (pTarget) {
+        long start = offset % capacity;
+        long upper = capacity - start;
+
+        if (nSource <= upper) {
+            memcpy(pTarget, (char *) pSource + start * pfl->field_size,
+                nSource * pfl->field_size);
+        }
+        else {
+            memcpy(pTarget, (char *) pSource + start * pfl->field_size,
+                upper * pfl->field_size);
+            memcpy(pTarget + upper * pfl->field_size, pSource,
+                (nSource - upper) * pfl->field_size);
+        }
+    }
+    dbScanUnlock(dbChannelRecord(chan));
+
+    if (nSource > 0 && !pTarget)
+        return -1;
+    pfl->u.r.field = pTarget;
+    pfl->u.r.dtor = pTarget ? freeCopy : NULL;
+    pfl->u.r.pvt = NULL;
+    pfl->no_elements = nSource;
+    return 0;
+}
+
+static void * allocPvt(void)
+{
+    return freeListCalloc(myStructFreeList);
+}
+
+static void freePvt(void *pvt)
+{
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (!my->group[0])
+        return -1;
+    if (my->state[0] && !(my->id = dbStateFind(my->state)))
+        return -1;
+
+    return 0;
+}
+
+static long channel_open(dbChannel *chan, void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+    snapGroup *pgroup = findGroup(my->group);
+
+    if (!pgroup)
+        return -1;
+
+    my->pgroup = pgroup;
+    my->chan = chan;
+    epicsMutexMustLock(pgroup->releaseLock);
+    epicsMutexMustLock(pgroup->lock);
+    ellAdd(&pgroup->members, &my->node);
+    epicsMutexUnlock(pgroup->lock);
+    epicsMutexUnlock(pgroup->releaseLock);
+    return 0;
+}
+
+static void channel_close(dbChannel *chan, void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+    snapGroup *pgroup = my->pgroup;
+    int i;
+
+    if (!pgroup)
+        return;
+
+    epicsMutexMustLock(pgroup->releaseLock);
+    epicsMutexMustLock(pgroup->lock);
+    ellDelete(&pgroup->members, &my->node);
+    for (i = 0; i < SNAP_DEPTH; i++) {
+        if (my->held[i]) {
+            db_delete_field_log(my->held[i]);
+            my->held[i] = NULL;
+            pgroup->shot[i].nHeld--;
+        }
+    }
+    if (my->ready) {
+        db_delete_field_log(my->ready);
+        my->ready = NULL;
+    }
+    epicsMutexUnlock(pgroup->lock);
+    epicsMutexUnlock(pgroup->releaseLock);
+    my->pgroup = NULL;
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    snapGroup *pgroup = my->pgroup;
+    int i, slot = -1, oldest = -1;
+    int release = 0;
+
+    if (pfl->ctx == dbfl_context_read)
+        return pfl;
+
+    if (my->id && !dbStateGet(my->id)) {
+        db_delete_field_log(pfl);
+        return NULL;
+    }
+
+    if (pfl->type == dbfl_type_ref && !pfl->u.r.dtor &&
+        copyArray(chan, pfl)) {
+        db_delete_field_log(pfl);
+        return NULL;
+    }
+
+    epicsMutexMustLock(pgroup->lock);
+
+    if (pgroup->haveReleased &&
+        !epicsTimeGreaterThan(&pfl->time, &pgroup->released)) {
+        /* Too late, that snapshot has gone */
+        epicsMutexUnlock(pgroup->lock);
+        db_delete_field_log(pfl);
+        return NULL;
+    }
+
+    for (i = 0; i < SNAP_DEPTH; i++) {
+        snapShot *pshot = &pgroup->shot[i];
+
+        if (!pshot->nHeld) {
+            if (slot < 0)
+                slot = i;
+        }
+        else if (epicsTimeEqual(&pshot->time, &pfl->time)) {
+            slot = i;
+            break;
+        }
+        else if (oldest < 0 ||
+                 epicsTimeLessThan(&pshot->time, &pgroup->shot[oldest].time)) {
+            oldest = i;
+        }
+    }
+    if (slot < 0) {
+        /* All in use, give up on the oldest */
+        dropShot(pgroup, oldest);
+        slot = oldest;
+    }
+    if (!pgroup->shot[slot].nHeld)
+        pgroup->shot[slot].time = pfl->time;
+
+    if (my->held[slot]) {
+        /* Repeated update, e.g. run again for the channel's next monitor */
+        pfl->mask |= my->held[slot]->mask;
+        db_delete_field_log(my->held[slot]);
+    }
+    else
+        pgroup->shot[slot].nHeld++;
+    my->held[slot] = pfl;
+
+    if (pgroup->shot[slot].nHeld >= countMonitored(pgroup)) {
+        myStruct *member;
+
+        /* Complete, release it and drop any earlier ones */
+        for (member = (myStruct *) ellFirst(&pgroup->members); member;
+             member = (myStruct *) ellNext(&member->node)) {
+            if (!member->held[slot])
+                continue;
+            if (member->ready)
+                db_delete_field_log(member->ready);
+            member->ready = member->held[slot];
+            member->held[slot] = NULL;
+        }
+        pgroup->shot[slot].nHeld = 0;
+        pgroup->released = pfl->time;
+        pgroup->haveReleased = 1;
+        pgroup->nReleased++;
+        for (i = 0; i < SNAP_DEPTH; i++) {
+            if (pgroup->shot[i].nHeld &&
+                epicsTimeLessThan(&pgroup->shot[i].time, &pfl->time))
+                dropShot(pgroup, i);
+        }
+        release = 1;
+    }
+
+    epicsMutexUnlock(pgroup->lock);
+
+    if (release)
+        callbackRequest(&pgroup->cb);
+    return NULL;
+}
+
+static void channelRegisterPre(dbChannel *chan, void *pvt,
+                               chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level, const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+    snapGroup *pgroup = my->pgroup;
+
+    printf("%*sSnapshot (snap): group=%s", indent, "", my->group);
+    if (my->state[0])
+        printf(", state=%s", my->state);
+    if (pgroup) {
+        int nMembers, nMonitored;
+
+        epicsMutexMustLock(pgroup->lock);
+        nMembers = ellCount(&pgroup->members);
+        nMonitored = countMonitored(pgroup);
+        epicsMutexUnlock(pgroup->lock);
+        printf(", %d members, %d monitored, %lu released, %lu dropped",
+               nMembers, nMonitored, pgroup->nReleased, pgroup->nDropped);
+    }
+    printf("\n");
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    channel_open,
+    channelRegisterPre,
+    NULL, /* channelRegisterPost, */
+    channel_report,
+    channel_close
+};
+
+static void snapShutdown(void* ignore)
+{
+    if(myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void snapInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+    if (!groupsLock)
+        groupsLock = epicsMutexMustCreate();
+
+    chfPluginRegister("snap", &pif, opts);
+    epicsAtExit(snapShutdown, NULL);
+}
+
+epicsExportRegistrar(snapInitialize);
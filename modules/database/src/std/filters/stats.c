@@ -0,0 +1,239 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Statistics filter: collects scalar updates over a window of n updates
+ * and/or t seconds and sends one update per window, with the selected
+ * statistic of the values in that window as a DBF_DOUBLE.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include <epicsMath.h>
+#include <freeList.h>
+#include <dbConvertFast.h>
+#include <chfPlugin.h>
+#include <epicsExit.h>
+#include <db_field_log.h>
+#include <epicsExport.h>
+
+typedef enum {
+    statMean,
+    statMin,
+    statMax,
+    statStd,
+    statCount
+} statType;
+
+typedef struct myStruct {
+    epicsInt32 n;
+    double t;
+    int stat;
+    /* The current window */
+    epicsInt32 count;
+    double min, max;
+    double mean, m2;        /* Welford's running mean and variance */
+    epicsTimeStamp start;
+    epicsTimeStamp last;
+    unsigned short alarmStat;
+    unsigned short alarmSevr;
+} myStruct;
+
+static void *myStructFreeList;
+
+static const
+chfPluginEnumType statEnum[] = {
+    {"mean", statMean}, {"min", statMin}, {"max", statMax},
+    {"std", statStd}, {"n", statCount}, {NULL, 0}
+};
+
+static const
+chfPluginArgDef opts[] = {
+    chfInt32     (myStruct, n, "n", 0, 0),
+    chfDouble    (myStruct, t, "t", 0, 1),
+    chfEnum      (myStruct, stat, "s", 0, 1, statEnum),
+    chfPluginArgEnd
+};
+
+static void * allocPvt(void)
+{
+    return freeListCalloc(myStructFreeList);
+}
+
+static void freePvt(void *pvt)
+{
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->n < 0 || my->t < 0 || !(my->n > 0 || my->t > 0))
+        return -1;
+
+    return 0;
+}
+
+static void addValue(myStruct *my, double val, const db_field_log *pfl)
+{
+    double delta;
+
+    if (my->count++ == 0) {
+        my->min = my->max = my->mean = val;
+        my->m2 = 0;
+        my->start = pfl->time;
+        my->alarmStat = pfl->stat;
+        my->alarmSevr = pfl->sevr;
+    }
+    else {
+        if (val < my->min) my->min = val;
+        if (val > my->max) my->max = val;
+        delta = val - my->mean;
+        my->mean += delta / my->count;
+        my->m2 += delta * (val - my->mean);
+        if (pfl->sevr > my->alarmSevr) {
+            my->alarmStat = pfl->stat;
+            my->alarmSevr = pfl->sevr;
+        }
+    }
+    my->last = pfl->time;
+}
+
+static double result(const myStruct *my)
+{
+    switch (my->stat) {
+    case statMin:   return my->min;
+    case statMax:   return my->max;
+    case statStd:   return my->count ? sqrt(my->m2 / my->count) : epicsNAN;
+    case statCount: return my->count;
+    default:        return my->mean;
+    }
+}
+
+/* Turn pfl into the update for the window, and start a new window */
+static db_field_log* sendWindow(myStruct *my, db_field_log *pfl)
+{
+    pfl->time = my->last;
+    pfl->stat = my->alarmStat;
+    pfl->sevr = my->alarmSevr;
+    pfl->u.v.field.dbf_double = result(my);
+    my->count = 0;
+    return pfl;
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
+    myStruct *my = (myStruct*) pvt;
+    DBADDR localAddr = chan->addr; /* Structure copy */
+    double val;
+
+    localAddr.field_type = pfl->field_type;
+    localAddr.field_size = pfl->field_size;
+    localAddr.no_elements = pfl->no_elements;
+    localAddr.pfield = dbfl_pfield(pfl);
+    if (dbFastGetConvertRoutine[pfl->field_type][DBR_DOUBLE]
+            (localAddr.pfield, (void*) &val, &localAddr)) {
+        db_delete_field_log(pfl);
+        return NULL;
+    }
+
+    /* The value is now in val, make pfl hold a double */
+    if (pfl->type == dbfl_type_ref) {
+        if (pfl->u.r.dtor)
+            pfl->u.r.dtor(pfl);
+        pfl->type = dbfl_type_val;
+    }
+    pfl->field_type = DBF_DOUBLE;
+    pfl->field_size = sizeof(epicsFloat64);
+    pfl->no_elements = 1;
+
+    if (pfl->ctx == dbfl_context_read) {
+        /* Statistics of this value alone */
+        myStruct one = *my;
+
+        one.count = 0;
+        addValue(&one, val, pfl);
+        pfl->u.v.field.dbf_double = result(&one);
+        return pfl;
+    }
+
+    if (my->t > 0 && my->count &&
+        epicsTimeDiffInSeconds(&pfl->time, &my->start) >= my->t) {
+        /* This update starts the next window */
+        myStruct next = *my;
+
+        next.count = 0;
+        addValue(&next, val, pfl);
+        sendWindow(my, pfl);
+        *my = next;
+        return pfl;
+    }
+
+    addValue(my, val, pfl);
+    if (my->n > 0 && my->count >= my->n)
+        return sendWindow(my, pfl);
+
+    db_delete_field_log(pfl);
+    return NULL;
+}
+
+static void channelRegisterPre(dbChannel *chan, void *pvt,
+                               chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    /* Only numeric scalars, anything else is passed on unchanged */
+    if (probe->no_elements != 1 ||
+        probe->field_type < DBF_CHAR || probe->field_type > DBF_ENUM)
+        return;
+
+    probe->field_type = DBF_DOUBLE;
+    probe->field_size = sizeof(epicsFloat64);
+
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level, const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+    printf("%*sStatistics (stats): s=%s, n=%d, t=%g, %d in window\n",
+           indent, "", chfPluginEnumString(statEnum, my->stat, "n/a"),
+           my->n, my->t, my->count);
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    NULL, /* channel_open, */
+    channelRegisterPre,
+    NULL, /* channelRegisterPost, */
+    channel_report,
+    NULL /* channel_close */
+};
+
+static void statsShutdown(void* ignore)
+{
+    if(myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void statsInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+
+    chfPluginRegister("stats", &pif, opts);
+    epicsAtExit(statsShutdown, NULL);
+}
+
+epicsExportRegistrar(statsInitialize);
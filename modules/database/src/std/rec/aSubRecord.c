@@ -85,7 +85,10 @@ epicsExportAddress(rset, aSubRSET);
 
 static long initFields(epicsEnum16 *pft, epicsUInt32 *pno, epicsUInt32 *pne,
     epicsUInt32 *pon, const char **fldnames, void **pval, void **povl);
-static long fetch_values(aSubRecord *prec);
+static long fetch_values(aSubRecord *prec, void **pown, epicsUInt32 *pnown,
+    int *pnref);
+static void restore_inputs(aSubRecord *prec, void **pown,
+    const epicsUInt32 *pnown);
 static void monitor(aSubRecord *);
 static long do_sub(aSubRecord *);
 
@@ -210,11 +213,14 @@ static long process(struct dbCommon *pcommon)
 {
     struct aSubRecord *prec = (struct aSubRecord *)pcommon;
     int pact = prec->pact;
+    void *own[NUM_ARGS];
+    epicsUInt32 nown[NUM_ARGS];
+    int nref = 0;
     long status = 0;
 
     if (!pact) {
         prec->pact = TRUE;
-        status = fetch_values(prec);
+        status = fetch_values(prec, own, nown, &nref);
         prec->pact = FALSE;
     }
 
@@ -223,6 +229,9 @@ static long process(struct dbCommon *pcommon)
         prec->val = status;
     }
 
+    if (nref)
+        restore_inputs(prec, own, nown);
+
     if (!pact && prec->pact)
         return 0;
 
@@ -245,7 +254,8 @@ static long process(struct dbCommon *pcommon)
     return 0;
 }
 
-static long fetch_values(aSubRecord *prec)
+static long fetch_values(aSubRecord *prec, void **pown, epicsUInt32 *pnown,
+    int *pnref)
 {
     long status;
     int i;
@@ -273,6 +283,32 @@ static long fetch_values(aSubRecord *prec)
         }
     }
 
+    if (prec->iflg == aSubIFLG_REFERENCE) {
+        /* Save all of A..U first, restore_inputs() checks every one */
+        for (i = 0; i < NUM_ARGS; i++) {
+            pown[i] = (&prec->a)[i];
+            pnown[i] = (&prec->nea)[i];
+        }
+
+        /* Point A..U at same-typed input data instead of copying it */
+        for (i = 0; i < NUM_ARGS; i++) {
+            void **pval = &(&prec->a)[i];
+            long nRequest = (&prec->noa)[i];
+            void *pdata;
+
+            status = dbGetLinkRef(&(&prec->inpa)[i], (&prec->fta)[i], *pval,
+                &pdata, &nRequest);
+            if (pdata != *pval) {
+                *pval = pdata;
+                ++*pnref;
+            }
+            if (status)
+                return status;
+            (&prec->nea)[i] = nRequest;
+        }
+        return 0;
+    }
+
     /* Get the input link values */
     for (i = 0; i < NUM_ARGS; i++) {
         long nRequest = (&prec->noa)[i];
@@ -285,6 +321,20 @@ static long fetch_values(aSubRecord *prec)
     return 0;
 }
 
+/* Give back the input fields that were pointed at other records' data */
+static void restore_inputs(aSubRecord *prec, void **pown,
+    const epicsUInt32 *pnown)
+{
+    int i;
+
+    for (i = 0; i < NUM_ARGS; i++) {
+        if ((&prec->a)[i] != pown[i]) {
+            (&prec->a)[i] = pown[i];
+            (&prec->nea)[i] = pnown[i];
+        }
+    }
+}
+
 #define indexof(field) aSubRecord##field
 
 static long get_inlinkNumber(int fieldIndex) {
@@ -508,6 +558,7 @@ static long get_array_info(DBADDR *paddr, long *no_elements, long *offset)
 
     if (fieldIndex >= aSubRecordA &&
         fieldIndex <= aSubRecordU) {
+        paddr->pfield = (&prec->a)[fieldIndex - aSubRecordA];
         *no_elements = (&prec->nea)[fieldIndex - aSubRecordA];
     }
     else if (fieldIndex >= aSubRecordVALA &&
@@ -109,27 +109,52 @@ static void monitor(compressRecord *prec)
     db_post_events(prec, (void*)&prec->val, monitor_mask);
 }
 
+/* Copy n values into the ring buffer.  Only the last nsam of them can
+ * survive, so any before those are skipped rather than overwritten.
+ */
 static void put_value(compressRecord *prec, double *psource, int n)
 {
     int fifo = (prec->balg == bufferingALG_FIFO);
     epicsUInt32 offset = prec->off;
     epicsUInt32 nuse = prec->nuse;
     epicsUInt32 nsam = prec->nsam;
+    double *pdest = prec->bptr;
 
     nuse += n;
     if (nuse > nsam)
         nuse = nsam;
 
-    while (n--) {
-        /* for LIFO, pre-decrement modulo nsam */
-        if (!fifo)
-            offset = (offset + nsam - 1) % nsam;
+    if ((epicsUInt32) n > nsam) {
+        epicsUInt32 skip = (n - nsam) % nsam;
+
+        psource += n - nsam;
+        n = nsam;
+        /* the offset moves on as if the skipped values were written */
+        offset = fifo ? (offset + skip) % nsam
+                      : (offset + nsam - skip) % nsam;
+    }
 
-        prec->bptr[offset] = *psource++;
+    if (fifo) {
+        /* post-increment, in at most two contiguous blocks */
+        epicsUInt32 upper = nsam - offset;
 
-        /* for FIFO, post-increment modulo nsam */
-        if (fifo)
-            offset = (offset + 1) % nsam;
+        if ((epicsUInt32) n < upper) {
+            memcpy(pdest + offset, psource, n * sizeof(double));
+            offset += n;
+        }
+        else {
+            memcpy(pdest + offset, psource, upper * sizeof(double));
+            memcpy(pdest, psource + upper, (n - upper) * sizeof(double));
+            offset = n - upper;
+        }
+    }
+    else {
+        /* pre-decrement, filling downwards */
+        while (n--) {
+            if (offset == 0)
+                offset = nsam;
+            pdest[--offset] = *psource++;
+        }
     }
 
     prec->off = offset;
@@ -137,7 +162,46 @@ static void put_value(compressRecord *prec, double *psource, int n)
 }
 
 
-/* qsort comparison function (for median calculation) */
+/* Reductions over one block of n values.  These are kept as plain loops
+ * over independent accumulators so that compilers can vectorize them.
+ */
+static double block_low(const double *psource, epicsInt32 n)
+{
+    double value = psource[0];
+    epicsInt32 j;
+
+    for (j = 1; j < n; j++)
+        value = psource[j] < value ? psource[j] : value;
+    return value;
+}
+
+static double block_high(const double *psource, epicsInt32 n)
+{
+    double value = psource[0];
+    epicsInt32 j;
+
+    for (j = 1; j < n; j++)
+        value = psource[j] > value ? psource[j] : value;
+    return value;
+}
+
+static double block_sum(const double *psource, epicsInt32 n)
+{
+    double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    epicsInt32 j;
+
+    for (j = 0; j + 4 <= n; j += 4) {
+        sum0 += psource[j];
+        sum1 += psource[j + 1];
+        sum2 += psource[j + 2];
+        sum3 += psource[j + 3];
+    }
+    for (; j < n; j++)
+        sum0 += psource[j];
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+/* qsort comparison function (for the median fallback) */
 static int compare(const void *arg1, const void *arg2)
 {
     double a = *(double *)arg1;
@@ -148,13 +212,63 @@ static int compare(const void *arg1, const void *arg2)
     else               return  1;
 }
 
+/* Return the k'th smallest of n values, as qsort() would have placed it.
+ * Quickselect with a median-of-three pivot, reordering the values in place.
+ * Degenerate partitions fall back to sorting what remains, so the worst
+ * case stays O(n log n).
+ */
+static double block_select(double *pval, epicsInt32 n, epicsInt32 k)
+{
+    epicsInt32 lo = 0, hi = n - 1;
+    epicsInt32 m;
+    int budget = 2;
+
+    for (m = n; m > 1; m >>= 1)
+        budget++;
+
+    while (hi > lo) {
+        epicsInt32 mid = lo + (hi - lo) / 2;
+        epicsInt32 i = lo, j = hi;
+        double pivot, a = pval[lo], b = pval[mid], c = pval[hi];
+
+        if (--budget < 0) {
+            qsort(pval + lo, hi - lo + 1, sizeof(double), compare);
+            break;
+        }
+
+        /* median of three */
+        if (a < b)
+            pivot = b < c ? b : (a < c ? c : a);
+        else
+            pivot = a < c ? a : (b < c ? c : b);
+
+        /* Hoare partition */
+        while (i <= j) {
+            while (pval[i] < pivot) i++;
+            while (pval[j] > pivot) j--;
+            if (i <= j) {
+                double tmp = pval[i];
+                pval[i++] = pval[j];
+                pval[j--] = tmp;
+            }
+        }
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;  /* pval[k] equals the pivot */
+    }
+    return pval[k];
+}
+
 static int compress_array(compressRecord *prec,
     double *psource, int no_elements)
 {
-    epicsInt32 i,j;
+    epicsInt32 i;
     epicsInt32 n, nnew;
     epicsInt32 nsam = prec->nsam;
-    double value;
+    double *pdest;
 
     /* skip out of limit data */
     if (prec->ilil < prec->ihil) {
@@ -169,57 +283,40 @@ static int compress_array(compressRecord *prec,
     n = prec->n;
     if (no_elements < n)
         return 1; /*dont do anything*/
+    pdest = psource;
 
     /* determine number of samples to take */
     if (no_elements < nsam * n)
         nnew = (no_elements / n);
     else nnew = nsam;
 
-    /* compress according to specified algorithm */
+    /* Compress according to specified algorithm.  Each block of n values
+     * is reduced to one, which is stored back into the work buffer over
+     * blocks already consumed; the results then go into the ring buffer
+     * with a single put_value().
+     */
     switch (prec->alg){
     case compressALG_N_to_1_Low_Value:
-        /* compress N to 1 keeping the lowest value */
-        for (i = 0; i < nnew; i++) {
-            value = *psource++;
-            for (j = 1; j < n; j++, psource++) {
-                if (value > *psource)
-                    value = *psource;
-            }
-            put_value(prec, &value, 1);
-        }
+        for (i = 0; i < nnew; i++, psource += n)
+            pdest[i] = block_low(psource, n);
         break;
     case compressALG_N_to_1_High_Value:
-        /* compress N to 1 keeping the highest value */
-        for (i = 0; i < nnew; i++){
-            value = *psource++;
-            for (j = 1; j < n; j++, psource++) {
-                if (value < *psource)
-                    value = *psource;
-            }
-            put_value(prec, &value, 1);
-        }
+        for (i = 0; i < nnew; i++, psource += n)
+            pdest[i] = block_high(psource, n);
         break;
     case compressALG_N_to_1_Average:
-        /* compress N to 1 keeping the average value */
-        for (i = 0; i < nnew; i++) {
-            value = 0;
-            for (j = 0; j < n; j++, psource++)
-                value += *psource;
-            value /= n;
-            put_value(prec, &value, 1);
-        }
+        for (i = 0; i < nnew; i++, psource += n)
+            pdest[i] = block_sum(psource, n) / n;
         break;
-
     case compressALG_N_to_1_Median:
-        /* compress N to 1 keeping the median value */
-        /* note: sorts source array (OK; it's a work pointer) */
-        for (i = 0; i < nnew; i++, psource += nnew) {
-            qsort(psource, n, sizeof(double), compare);
-            value = psource[n / 2];
-            put_value(prec, &value, 1);
-        }
+        /* note: reorders source array (OK; it's a work pointer) */
+        for (i = 0; i < nnew; i++, psource += n)
+            pdest[i] = block_select(psource, n, n / 2);
         break;
+    default:
+        return 1;
     }
+    put_value(prec, pdest, nnew);
     return 0;
 }
 
@@ -44,6 +44,9 @@
 
 #define indexof(field) histogramRecord##field
 
+/* NSRD before device support has read an array of samples */
+#define NSRD_UNSET ((epicsUInt32) -1)
+
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
 #define initialize NULL
@@ -95,6 +98,8 @@ typedef struct myCallback {
 } myCallback;
 
 static long add_count(histogramRecord *);
+static long add_samples(histogramRecord *, const double *, epicsUInt32);
+static void decay_counts(histogramRecord *);
 static long clear_histogram(histogramRecord *);
 static void monitor(histogramRecord *);
 static long readValue(histogramRecord *);
@@ -160,6 +165,10 @@ static long init_record(struct dbCommon *pcommon, int pass)
             prec->bptr = calloc(prec->nelm, sizeof(epicsUInt32));
         }
 
+        /* and for the samples when reading arrays */
+        if (prec->nsmp > 0 && !prec->sptr)
+            prec->sptr = calloc(prec->nsmp, sizeof(double));
+
         /* calulate width of array element */
         prec->wdth = (prec->ulim - prec->llim) / prec->nelm;
         return 0;
@@ -206,6 +215,10 @@ static long process(struct dbCommon *pcommon)
         return S_dev_missingSup;
     }
 
+    /* Device support that reads an array of samples sets NSRD */
+    if (!pact)
+        prec->nsrd = NSRD_UNSET;
+
     status = readValue(prec); /* read the new value */
 
     /* check if device support set pact */
@@ -215,11 +228,24 @@ static long process(struct dbCommon *pcommon)
 
     recGblGetTimeStampSimm(prec, prec->simm, &prec->siol);
 
-    if (status == 0)
-        add_count(prec);
+    if (status == 0) {
+        decay_counts(prec);
+        if (prec->nsrd != NSRD_UNSET && prec->nsmp > 0 && prec->sptr) {
+            if (prec->nsrd > prec->nsmp)
+                prec->nsrd = prec->nsmp;
+            if (prec->nsrd > 0)
+                prec->sgnl = prec->sptr[prec->nsrd - 1];
+            add_samples(prec, prec->sptr, prec->nsrd);
+        }
+        else
+            add_count(prec);
+    }
     else if (status == 2)
         status = 0;
 
+    if (prec->nsrd == NSRD_UNSET)
+        prec->nsrd = 0;
+
     monitor(prec);
     recGblFwdLink(prec);
 
@@ -317,12 +343,41 @@ static long get_array_info(DBADDR *paddr, long *no_elements, long *offset)
     return 0;
 }
 
-static long add_count(histogramRecord *prec)
+/* Index of the array element that counts value v, or -1 if it's out of
+ * range.  An element counts values above its lower bound up to and
+ * including its upper bound, except that the first also counts LLIM.
+ */
+static int bin_index(const histogramRecord *prec, double v)
 {
     double temp;
-    epicsUInt32 *pdest;
+    int nelm = prec->nelm;
     int i;
 
+    if (!(v >= prec->llim && v < prec->ulim))
+        return -1;  /* also for NaN */
+
+    temp = v - prec->llim;
+    i = (int) ceil(temp / prec->wdth);
+    if (i < 1)
+        i = 1;
+    else if (i > nelm)
+        i = nelm;
+    /* correct for any rounding, against the same bounds as always */
+    while (i > 1 && temp <= (double) (i - 1) * prec->wdth)
+        i--;
+    while (i < nelm && temp > (double) i * prec->wdth)
+        i++;
+    return i - 1;
+}
+
+/* Count n values into the histogram array */
+static long add_samples(histogramRecord *prec, const double *psamp,
+    epicsUInt32 n)
+{
+    epicsUInt32 *pcount = prec->bptr;
+    double *pweight = prec->wptr;
+    epicsUInt32 i, added = 0;
+
     if (prec->csta == FALSE)
         return 0;
 
@@ -333,30 +388,81 @@ static long add_count(histogramRecord *prec)
             return -1;
         }
     }
-    if (prec->sgnl < prec->llim ||
-        prec->sgnl >= prec->ulim)
-        return 0;
 
-    temp = prec->sgnl - prec->llim;
-    for (i = 1; i <= prec->nelm; i++){
-        if (temp <= (double) i * prec->wdth)
-            break;
+    for (i = 0; i < n; i++) {
+        int j = bin_index(prec, psamp[i]);
+
+        if (j < 0)
+            continue;
+        if (pweight) {
+            pweight[j] += 1.0;
+            pcount[j] = pweight[j] + 0.5 < (double) UINT_MAX ?
+                (epicsUInt32) (pweight[j] + 0.5) : (epicsUInt32) UINT_MAX;
+        }
+        else {
+            if (pcount[j] == (epicsUInt32) UINT_MAX)
+                pcount[j] = 0;
+            pcount[j]++;
+        }
+        added++;
     }
-    pdest = prec->bptr + i - 1;
-    if (*pdest == (epicsUInt32) UINT_MAX)
-        *pdest = 0;
-    (*pdest)++;
-    prec->mcnt++;
+
+    if (added > (epicsUInt32) (SHRT_MAX - prec->mcnt))
+        prec->mcnt = SHRT_MAX;
+    else
+        prec->mcnt += added;
 
     return 0;
 }
 
+static long add_count(histogramRecord *prec)
+{
+    return add_samples(prec, &prec->sgnl, 1);
+}
+
+/* Apply DCAY to the counts, keeping the fractions in WPTR */
+static void decay_counts(histogramRecord *prec)
+{
+    double keep = 1.0 - prec->dcay;
+    int i;
+
+    if (!(prec->dcay > 0.0 && prec->dcay < 1.0)) {
+        if (prec->wptr) {
+            free(prec->wptr);
+            prec->wptr = NULL;
+        }
+        return;
+    }
+
+    if (prec->csta == FALSE)
+        return;
+
+    if (!prec->wptr) {
+        prec->wptr = calloc(prec->nelm, sizeof(double));
+        if (!prec->wptr)
+            return;
+        for (i = 0; i < prec->nelm; i++)
+            prec->wptr[i] = prec->bptr[i];
+    }
+
+    for (i = 0; i < prec->nelm; i++) {
+        double w = prec->wptr[i] * keep;
+
+        prec->wptr[i] = w;
+        prec->bptr[i] = (epicsUInt32) (w + 0.5);
+    }
+}
+
 static long clear_histogram(histogramRecord *prec)
 {
     int i;
 
     for (i = 0; i < prec->nelm; i++)
         prec->bptr[i] = 0;
+    if (prec->wptr) {
+        for (i = 0; i < prec->nelm; i++)
+            prec->wptr[i] = 0.0;
+    }
     prec->mcnt = prec->mdel + 1;
     prec->udf = FALSE;
 
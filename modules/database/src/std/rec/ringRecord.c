@@ -0,0 +1,344 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* ringRecord.c - Record Support Routines for Ring Buffer records
+ *
+ * The values are kept in a circular buffer that is never reordered.
+ * get_array_info reports where the oldest value is, and the database
+ * array routines and filters handle the wrap around the end of the buffer.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "alarm.h"
+#include "cantProceed.h"
+#include "dbAccess.h"
+#include "dbEvent.h"
+#include "dbFldTypes.h"
+#include "errMdef.h"
+#include "recSup.h"
+#include "recGbl.h"
+#include "special.h"
+
+#define GEN_SIZE_OFFSET
+#include "ringRecord.h"
+#undef  GEN_SIZE_OFFSET
+#include "epicsExport.h"
+
+/* Create RSET - Record Support Entry Table*/
+#define report NULL
+#define initialize NULL
+static long init_record(struct dbCommon *, int);
+static long process(struct dbCommon *);
+static long special(DBADDR *, int);
+#define get_value NULL
+static long cvt_dbaddr(DBADDR *);
+static long get_array_info(DBADDR *, long *, long *);
+static long put_array_info(DBADDR *, long);
+static long get_units(DBADDR *, char *);
+static long get_precision(const DBADDR *, long *);
+#define get_enum_str NULL
+#define get_enum_strs NULL
+#define put_enum_str NULL
+static long get_graphic_double(DBADDR *, struct dbr_grDouble *);
+static long get_control_double(DBADDR *, struct dbr_ctrlDouble *);
+#define get_alarm_double NULL
+
+rset ringRSET={
+    RSETNUMBER,
+    report,
+    initialize,
+    init_record,
+    process,
+    special,
+    get_value,
+    cvt_dbaddr,
+    get_array_info,
+    put_array_info,
+    get_units,
+    get_precision,
+    get_enum_str,
+    get_enum_strs,
+    put_enum_str,
+    get_graphic_double,
+    get_control_double,
+    get_alarm_double
+};
+epicsExportAddress(rset,ringRSET);
+
+#define indexof(field) ringRecord##field
+
+/* Index of the oldest value */
+static epicsUInt32 tail(const ringRecord *prec)
+{
+    return (prec->head + prec->nelm - prec->nuse) % prec->nelm;
+}
+
+/* Account for n values that have been stored from HEAD onwards */
+static void appended(ringRecord *prec, epicsUInt32 n)
+{
+    prec->head = (prec->head + n) % prec->nelm;
+    prec->nuse += n;
+    if (prec->nuse > prec->nelm)
+        prec->nuse = prec->nelm;
+}
+
+static void reset(ringRecord *prec)
+{
+    prec->head = 0;
+    prec->nuse = 0;
+    prec->res = 0;
+}
+
+static long init_record(struct dbCommon *pcommon, int pass)
+{
+    ringRecord *prec = (ringRecord *) pcommon;
+
+    if (pass == 0) {
+        if (prec->nelm <= 0)
+            prec->nelm = 1;
+        if (prec->ftvl > DBF_ENUM)
+            prec->ftvl = DBF_DOUBLE;
+        prec->bptr = callocMustSucceed(prec->nelm, dbValueSize(prec->ftvl),
+            "ring calloc failed");
+        reset(prec);
+        return 0;
+    }
+
+    if (dbLinkIsConstant(&prec->inp)) {
+        long nRequest = prec->nelm;
+
+        if (!dbLoadLinkArray(&prec->inp, prec->ftvl, prec->bptr, &nRequest) &&
+            nRequest > 0) {
+            appended(prec, nRequest);
+            prec->udf = FALSE;
+        }
+    }
+    return 0;
+}
+
+/* Append the values INP refers to.  A batch that fits before the end of
+ * the buffer is read in place, anything else goes through WPTR.
+ */
+static long readValues(ringRecord *prec)
+{
+    epicsUInt32 size = dbValueSize(prec->ftvl);
+    epicsUInt32 space = prec->nelm - prec->head;
+    char *pdest = (char *) prec->bptr + prec->head * size;
+    long nRequest;
+    long status;
+
+    status = dbGetNelements(&prec->inp, &nRequest);
+    if (status)
+        return status;
+    if (nRequest > (long) prec->nelm)
+        nRequest = prec->nelm;
+    if (nRequest <= 0)
+        return 0;
+
+    if ((epicsUInt32) nRequest <= space) {
+        status = dbGetLink(&prec->inp, prec->ftvl, pdest, 0, &nRequest);
+        if (!status && nRequest > 0)
+            appended(prec, nRequest);
+        return status;
+    }
+
+    if (!prec->wptr)
+        prec->wptr = callocMustSucceed(prec->nelm, size,
+            "ring calloc failed");
+    status = dbGetLink(&prec->inp, prec->ftvl, prec->wptr, 0, &nRequest);
+    if (status || nRequest <= 0)
+        return status;
+
+    if ((epicsUInt32) nRequest <= space) {
+        memcpy(pdest, prec->wptr, nRequest * size);
+    }
+    else {
+        memcpy(pdest, prec->wptr, space * size);
+        memcpy(prec->bptr, (char *) prec->wptr + space * size,
+            (nRequest - space) * size);
+    }
+    appended(prec, nRequest);
+    return 0;
+}
+
+static void monitor(ringRecord *prec, epicsUInt32 nuse)
+{
+    unsigned short monitor_mask = recGblResetAlarms(prec);
+
+    monitor_mask |= DBE_VALUE | DBE_LOG;
+    db_post_events(prec, &prec->val, monitor_mask);
+    if (nuse != prec->nuse)
+        db_post_events(prec, &prec->nuse, DBE_VALUE | DBE_LOG);
+}
+
+static long process(struct dbCommon *pcommon)
+{
+    ringRecord *prec = (ringRecord *) pcommon;
+    epicsUInt32 nuse = prec->nuse;
+    long status = 0;
+
+    prec->pact = TRUE;
+    if (!dbLinkIsConstant(&prec->inp)) {
+        status = readValues(prec);
+        if (status)
+            recGblSetSevr(prec, LINK_ALARM, INVALID_ALARM);
+    }
+
+    prec->udf = FALSE;
+    recGblGetTimeStamp(prec);
+
+    monitor(prec, nuse);
+
+    /* process the forward scan link record */
+    recGblFwdLink(prec);
+
+    prec->pact = FALSE;
+    return status;
+}
+
+static long special(DBADDR *paddr, int after)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    if (!after)
+        return 0;
+
+    if (paddr->special == SPC_RESET) {
+        epicsUInt32 nuse = prec->nuse;
+
+        reset(prec);
+        if (nuse)
+            db_post_events(prec, &prec->nuse, DBE_VALUE | DBE_LOG);
+        return 0;
+    }
+
+    recGblDbaddrError(S_db_badChoice, paddr, "ring: special");
+    return S_db_badChoice;
+}
+
+static long cvt_dbaddr(DBADDR *paddr)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    paddr->pfield = prec->bptr;
+    paddr->no_elements = prec->nelm;
+    paddr->field_type = prec->ftvl;
+    paddr->field_size = dbValueSize(prec->ftvl);
+    paddr->dbr_field_type = prec->ftvl;
+    return 0;
+}
+
+static long get_array_info(DBADDR *paddr, long *no_elements, long *offset)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    paddr->pfield = prec->bptr;
+    if (dbGetFieldIndex(paddr) == indexof(APND)) {
+        /* Values put to APND are stored from HEAD onwards */
+        *no_elements = 0;
+        *offset = prec->head;
+    }
+    else {
+        *no_elements = prec->nuse;
+        *offset = tail(prec);
+    }
+    return 0;
+}
+
+static long put_array_info(DBADDR *paddr, long nNew)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+    epicsUInt32 nuse = prec->nuse;
+
+    if (dbGetFieldIndex(paddr) == indexof(VAL)) {
+        /* The new values were stored over the oldest ones and replace
+         * the contents of the buffer.
+         */
+        prec->head = tail(prec);
+        prec->nuse = 0;
+    }
+    appended(prec, nNew);
+
+    if (nuse != prec->nuse)
+        db_post_events(prec, &prec->nuse, DBE_VALUE | DBE_LOG);
+    return 0;
+}
+
+static long get_units(DBADDR *paddr, char *units)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    switch (dbGetFieldIndex(paddr)) {
+        case indexof(VAL):
+        case indexof(APND):
+            if (prec->ftvl == DBF_STRING || prec->ftvl == DBF_ENUM)
+                break;
+        case indexof(HOPR):
+        case indexof(LOPR):
+            strncpy(units, prec->egu, DB_UNITS_SIZE);
+    }
+    return 0;
+}
+
+static long get_precision(const DBADDR *paddr, long *precision)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+    int fieldIndex = dbGetFieldIndex(paddr);
+
+    *precision = prec->prec;
+    if (fieldIndex != indexof(VAL) && fieldIndex != indexof(APND))
+        recGblGetPrec(paddr, precision);
+    return 0;
+}
+
+static long get_graphic_double(DBADDR *paddr, struct dbr_grDouble *pgd)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    switch (dbGetFieldIndex(paddr)) {
+        case indexof(VAL):
+        case indexof(APND):
+            pgd->upper_disp_limit = prec->hopr;
+            pgd->lower_disp_limit = prec->lopr;
+            break;
+        case indexof(NUSE):
+        case indexof(HEAD):
+            pgd->upper_disp_limit = prec->nelm;
+            pgd->lower_disp_limit = 0;
+            break;
+        default:
+            recGblGetGraphicDouble(paddr, pgd);
+    }
+    return 0;
+}
+
+static long get_control_double(DBADDR *paddr, struct dbr_ctrlDouble *pcd)
+{
+    ringRecord *prec = (ringRecord *) paddr->precord;
+
+    switch (dbGetFieldIndex(paddr)) {
+        case indexof(VAL):
+        case indexof(APND):
+            pcd->upper_ctrl_limit = prec->hopr;
+            pcd->lower_ctrl_limit = prec->lopr;
+            break;
+        case indexof(NUSE):
+        case indexof(HEAD):
+            pcd->upper_ctrl_limit = prec->nelm;
+            pcd->lower_ctrl_limit = 0;
+            break;
+        default:
+            recGblGetControlDouble(paddr, pcd);
+    }
+    return 0;
+}
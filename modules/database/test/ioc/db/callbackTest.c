@@ -82,6 +82,53 @@ static void finalCallback(epicsCallback *pCallback)
     epicsEventSignal(finished);
 }
 
+static void signalCallback(epicsCallback *pCallback)
+{
+    epicsEventSignal(finished);
+}
+
+static void checkLatencyStats(void)
+{
+    callbackLatencyStats stats;
+    epicsCallback cb;
+    size_t run = 0, binned = 0, late = 0;
+    int i, j;
+
+    testDiag("Queue latency statistics");
+    testOk(callbackLatencyStatus(1, &stats) == 0, "callbackLatencyStatus()");
+    for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
+        run += stats.numRun[i];
+        for (j = 0; j < NUM_CALLBACK_LATENCY_BINS; j++)
+            binned += stats.histogram[i][j];
+        testDiag("Priority %d: %lu callbacks, max latency %f", i,
+            (unsigned long) stats.numRun[i], stats.maxLatency[i]);
+    }
+    testOk(run == 2 * NCALLBACKS, "%lu callbacks run, expected %d",
+        (unsigned long) run, 2 * NCALLBACKS);
+    testOk(binned == run, "%lu callbacks in latency histogram",
+        (unsigned long) binned);
+
+    callbackLatencyStatus(0, &stats);
+    run = 0;
+    for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++)
+        run += stats.numRun[i];
+    testOk(run == 0, "statistics were reset");
+
+    /* Every callback takes longer than this */
+    callbackLatencyBudget(1e-9, NULL);
+    memset(&cb, 0, sizeof(cb));
+    callbackSetCallback(signalCallback, &cb);
+    callbackSetPriority(priorityMedium, &cb);
+    callbackRequest(&cb);
+    epicsEventWait(finished);
+    callbackLatencyStatus(0, &stats);
+    callbackLatencyBudget(0, NULL);
+    for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++)
+        late += stats.numLate[i];
+    testOk(late == 1 && stats.budget[priorityMedium] == 1e-9,
+        "%lu late callbacks", (unsigned long) late);
+}
+
 static void updateStats(double *stats, double val)
 {
     if (stats[0] > val) stats[0] = val;
@@ -111,7 +158,7 @@ MAIN(callbackTest)
         for (j = 0; j < 5; j++)
             setupError[i][j] = timeError[i][j] = defaultError[j];
 
-    testPlan(2);
+    testPlan(7);
 
     callbackInit();
     epicsThreadSleep(1.0);
@@ -196,6 +243,8 @@ MAIN(callbackTest)
     printStats(timeError[1], "MID");
     printStats(timeError[2], "HIGH");
 
+    checkLatencyStats();
+
     for (i = 0; i < NCALLBACKS ; i++) {
         free(pcbt[i]);
     }
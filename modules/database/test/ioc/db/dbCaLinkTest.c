@@ -19,6 +19,7 @@
 #include "epicsString.h"
 #include "dbUnitTest.h"
 #include "epicsThread.h"
+#include "epicsTime.h"
 #include "cantProceed.h"
 #include "epicsEvent.h"
 #include "iocInit.h"
@@ -188,6 +189,206 @@ static void testNativeLink(void)
     testdbCleanup();
 }
 
+static void testScalarReadRate(void)
+{
+    xRecord *psrc, *ptarg;
+    DBLINK *psrclnk;
+    caLink *pca;
+    epicsInt32 temp;
+    double dtemp;
+    epicsTimeStamp start, stop;
+    unsigned long i, nread = 1000000, nFast;
+    double elapsed;
+    long status = 0;
+
+    testDiag("Scalar CA link read rate");
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("dbCaLinkTest1.db", NULL, "TARGET=target CA");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    psrc = (xRecord*)testdbRecordPtr("source");
+    ptarg= (xRecord*)testdbRecordPtr("target");
+    psrclnk = &psrc->lnk;
+
+    waitForUpdateN(psrclnk, 1);
+
+    dbScanLock((dbCommon*)ptarg);
+    ptarg->val = 17;
+    db_post_events(ptarg, &ptarg->val, DBE_VALUE|DBE_ALARM|DBE_ARCHIVE);
+    dbScanUnlock((dbCommon*)ptarg);
+
+    waitForUpdateN(psrclnk, 2);
+
+    dbScanLock((dbCommon*)psrc);
+    testOk1(dbGetLink(psrclnk, DBR_LONG, &temp, NULL, NULL)==0);
+    testOp("%d",temp,==,17);
+    /* cached converter must follow a change of requested type */
+    testOk1(dbGetLink(psrclnk, DBR_DOUBLE, &dtemp, NULL, NULL)==0);
+    testOp("%f",dtemp,==,17.0);
+
+    pca = (caLink*)psrclnk->value.pv_link.pvt;
+    nFast = pca->nFastGet;
+    epicsTimeGetCurrent(&start);
+    for (i = 0; i < nread && !status; i++)
+        status = dbGetLink(psrclnk, DBR_LONG, &temp, NULL, NULL);
+    epicsTimeGetCurrent(&stop);
+    nFast = pca->nFastGet - nFast;
+    dbScanUnlock((dbCommon*)psrc);
+
+    testOk(status==0, "%lu reads ok", nread);
+    testOk(nFast==nread, "%lu of %lu reads without locking", nFast, nread);
+    elapsed = epicsTimeDiffInSeconds(&stop, &start);
+    testDiag("%lu reads in %f sec, %.0f links read/sec",
+        nread, elapsed, elapsed > 0 ? nread / elapsed : 0.0);
+
+    dbScanLock((dbCommon*)ptarg);
+    ptarg->val = 18;
+    db_post_events(ptarg, &ptarg->val, DBE_VALUE|DBE_ALARM|DBE_ARCHIVE);
+    dbScanUnlock((dbCommon*)ptarg);
+
+    waitForUpdateN(psrclnk, 3);
+
+    dbScanLock((dbCommon*)psrc);
+    testOk1(dbGetLink(psrclnk, DBR_LONG, &temp, NULL, NULL)==0);
+    testOp("%d",temp,==,18);
+    dbScanUnlock((dbCommon*)psrc);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
+#define NSHARDED 8
+
+static void testShardedLinks(void)
+{
+    xRecord *psrc, *ptarg;
+    DBLINK *psrclnk;
+    caLink *pca;
+    epicsInt32 temp;
+    unsigned long nPut, nNoWrite;
+    DBLINK *plinks[NSHARDED];
+    caLink *pcas[NSHARDED];
+    int expect[NSHARDED];
+    int nExpect[3] = {0, 0, 0};
+    int i, nUsed = 0;
+
+    testDiag("CA links served by several dbCaLink threads");
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("dbCaLinkTest1.db", NULL, "TARGET=target CA");
+    for (i = 0; i < NSHARDED; i++) {
+        char macros[8];
+
+        sprintf(macros, "N=%d", i);
+        testdbReadDatabase("dbCaLinkTest4.db", NULL, macros);
+    }
+
+    dbCaLinkThreads = 3;
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testOp("%d",dbCaNShards,==,3);
+
+    psrc = (xRecord*)testdbRecordPtr("source");
+    ptarg= (xRecord*)testdbRecordPtr("target");
+    psrclnk = &psrc->lnk;
+    pca = (caLink*)psrclnk->value.pv_link.pvt;
+
+    testOk1(pca->shard >= dbCaShards && pca->shard < dbCaShards + dbCaNShards);
+
+    waitForUpdateN(psrclnk, 1);
+
+    temp = 1234;
+    putLink(psrclnk, DBR_LONG, (void*)&temp, 1);
+
+    dbScanLock((dbCommon*)ptarg);
+    testOp("%d",ptarg->val,==,1234);
+    dbScanUnlock((dbCommon*)ptarg);
+
+    testDiag("Links to different targets are spread over the shards");
+    for (i = 0; i < NSHARDED; i++) {
+        char name[20];
+        xRecord *pshsrc;
+
+        sprintf(name, "target%d", i);
+        expect[i] = epicsMemHash(name, strlen(name), 0) % dbCaNShards;
+        nExpect[expect[i]]++;
+        sprintf(name, "source%d", i);
+        pshsrc = (xRecord*)testdbRecordPtr(name);
+        plinks[i] = &pshsrc->lnk;
+        pcas[i] = (caLink*)plinks[i]->value.pv_link.pvt;
+        testOk(pcas[i]->shard == &dbCaShards[expect[i]],
+            "target%d served by shard %d", i, expect[i]);
+        waitForUpdateN(plinks[i], 1);
+    }
+    /* source -> target from dbCaLinkTest1.db */
+    nExpect[pca->shard - dbCaShards]++;
+    for (i = 0; i < dbCaNShards; i++) {
+        testOp("%d",dbCaShards[i].nLinks,==,nExpect[i]);
+        nUsed += nExpect[i] > 0;
+    }
+    testOk(nUsed == dbCaNShards, "%d of %d shards have links",
+        nUsed, dbCaNShards);
+
+    testDiag("Each shard's thread sends the puts of its own links");
+    for (i = 0; i < NSHARDED; i++) {
+        unsigned long before[3];
+        int j, others = 0;
+
+        for (j = 0; j < dbCaNShards; j++)
+            before[j] = dbCaShards[j].nPut;
+        dbScanLock(plinks[i]->precord);
+        temp = i;
+        dbPutLink(plinks[i], DBR_LONG, &temp, 1);
+        dbScanUnlock(plinks[i]->precord);
+        dbCaSync();
+        for (j = 0; j < dbCaNShards; j++) {
+            if (j != expect[i])
+                others += dbCaShards[j].nPut != before[j];
+        }
+        testOk(dbCaShards[expect[i]].nPut == before[expect[i]] + 1 &&
+            !others, "put to target%d sent by shard %d only", i, expect[i]);
+    }
+
+    testDiag("Puts queued while paused are coalesced");
+    nPut = pca->shard->nPut;
+    nNoWrite = pca->nNoWrite;
+    dbCaPause();
+    dbScanLock((dbCommon*)psrc);
+    temp = 1;
+    testOk1(dbPutLink(psrclnk, DBR_LONG, &temp, 1)==0);
+    temp = 2;
+    testOk1(dbPutLink(psrclnk, DBR_LONG, &temp, 1)==0);
+    dbScanUnlock((dbCommon*)psrc);
+    dbCaRun();
+    dbCaSync();
+
+    testOp("%lu",pca->shard->nPut,==,nPut+1);
+    testOp("%lu",pca->nNoWrite,==,nNoWrite+1);
+    dbScanLock((dbCommon*)ptarg);
+    testOp("%d",ptarg->val,==,2);
+    dbScanUnlock((dbCommon*)ptarg);
+
+    testIocShutdownOk();
+    dbCaLinkThreads = 1;
+
+    testdbCleanup();
+}
+
 static void testStringLink(void)
 {
     xRecord *psrc, *ptarg;
@@ -618,8 +819,10 @@ static void testCAC(void)
 
 MAIN(dbCaLinkTest)
 {
-    testPlan(101);
+    testPlan(138);
     testNativeLink();
+    testScalarReadRate();
+    testShardedLinks();
     testStringLink();
     testCP();
     testArrayLink(1,1);
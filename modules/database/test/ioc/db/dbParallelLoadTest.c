@@ -0,0 +1,169 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <errlog.h>
+#include <epicsTime.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <testMain.h>
+
+#define NFILES 200
+#define NRECORDS 20
+
+static const char *dbFile = "dbParallelLoadTest.db";
+static const char *incFile = "dbParallelLoadInc.db";
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static void writeFiles(void)
+{
+    FILE *fp = fopen(dbFile, "w");
+    int i;
+
+    if (!fp)
+        testAbort("Can't create %s", dbFile);
+    for (i = 0; i < NRECORDS; i++) {
+        fprintf(fp, "record(x, \"$(P)rec%d\") {\n", i);
+        fprintf(fp, "    field(DESC, \"$(P) record %d\")\n", i);
+        fprintf(fp, "    field(VAL, \"$(N=0)\")\n");
+        fprintf(fp, "    field(LNK, \"$(P)rec%d.VAL\")\n", (i + 1) % NRECORDS);
+        fprintf(fp, "}\n");
+    }
+    fprintf(fp, "include \"%s\"\n", incFile);
+    fclose(fp);
+
+    fp = fopen(incFile, "w");
+    if (!fp)
+        testAbort("Can't create %s", incFile);
+    fprintf(fp, "record(x, \"$(P)inc\") {\n");
+    fprintf(fp, "    field(DESC, \"Included by $(P)\")\n");
+    fprintf(fp, "}\n");
+    fclose(fp);
+}
+
+static void loadDbd(void)
+{
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+}
+
+static void checkField(const char *pv, const char *expect)
+{
+    DBENTRY entry;
+
+    dbInitEntry(pdbbase, &entry);
+    if (dbFindRecord(&entry, pv)) {
+        testFail("%s not found", pv);
+    } else {
+        const char *val = dbGetString(&entry);
+
+        testOk(val && strcmp(val, expect) == 0,
+            "%s == \"%s\" (\"%s\")", pv, val ? val : "(null)", expect);
+    }
+    dbFinishEntry(&entry);
+}
+
+static double loadAll(int parallel)
+{
+    epicsTimeStamp start, done;
+    char subs[64];
+    int i;
+
+    epicsTimeGetCurrent(&start);
+    for (i = 0; i < NFILES; i++) {
+        sprintf(subs, "P=dev%d:,N=%d", i, i);
+        if (parallel)
+            dbLoadRecordsParallel(dbFile, subs);
+        else
+            dbLoadRecords(dbFile, subs);
+    }
+    if (parallel)
+        testOk1(dbLoadRecordsWait() == 0);
+    epicsTimeGetCurrent(&done);
+    return epicsTimeDiffInSeconds(&done, &start);
+}
+
+static void testOrder(void)
+{
+    DBENTRY entry;
+    char name[64];
+    int i, inOrder = 1;
+
+    dbInitEntry(pdbbase, &entry);
+    testOk1(dbFindRecordType(&entry, "x") == 0);
+    testOk(dbGetNRecords(&entry) == NFILES * (NRECORDS + 1),
+        "%d records loaded", dbGetNRecords(&entry));
+
+    /* Records appear in the order the files were queued */
+    dbFirstRecord(&entry);
+    for (i = 0; i < NFILES && inOrder; i++) {
+        int j;
+
+        for (j = 0; j < NRECORDS && inOrder; j++) {
+            sprintf(name, "dev%d:rec%d", i, j);
+            inOrder = strcmp(dbGetRecordName(&entry), name) == 0;
+            dbNextRecord(&entry);
+        }
+        sprintf(name, "dev%d:inc", i);
+        inOrder = inOrder && strcmp(dbGetRecordName(&entry), name) == 0;
+        dbNextRecord(&entry);
+    }
+    testOk(inOrder, "Records created in queued order");
+    dbFinishEntry(&entry);
+}
+
+MAIN(dbParallelLoadTest)
+{
+    double seqTime, parTime;
+
+    testPlan(17);
+
+    writeFiles();
+
+    testDiag("Sequential dbLoadRecords of %d files", NFILES);
+    loadDbd();
+    seqTime = loadAll(0);
+    testOrder();
+    testdbCleanup();
+
+    testDiag("dbLoadRecordsParallel of %d files", NFILES);
+    loadDbd();
+    parTime = loadAll(1);
+    testOrder();
+
+    checkField("dev7:rec3.DESC", "dev7: record 3");
+    checkField("dev7:rec3.VAL", "7");
+    checkField("dev7:rec19.LNK", "dev7:rec0.VAL");
+    checkField("dev199:inc.DESC", "Included by dev199:");
+
+    testDiag("Sequential %.3f ms, parallel %.3f ms",
+        seqTime * 1e3, parTime * 1e3);
+
+    testDiag("Missing file is reported, later files still load");
+    eltc(0);
+    testOk1(dbLoadRecordsParallel("no-such-file.db", NULL) == 0);
+    testOk1(dbLoadRecordsParallel(dbFile, "P=late:") == 0);
+    testOk1(dbLoadRecordsWait() != 0);
+    eltc(1);
+    checkField("late:rec0.VAL", "0");
+
+    testDiag("Queued files are loaded by iocInit");
+    testOk1(dbLoadRecordsParallel(dbFile, "P=init:,N=42") == 0);
+    testIocInitOk();
+    testdbGetFieldEqual("init:rec5.VAL", DBR_LONG, 42);
+    testIocShutdownOk();
+
+    testdbCleanup();
+    remove(dbFile);
+    remove(incFile);
+
+    return testDone();
+}
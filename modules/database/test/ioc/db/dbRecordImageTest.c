@@ -0,0 +1,191 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <errlog.h>
+#include <epicsTime.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+#define NRECORDS 2000
+
+static const char *dbFile = "dbRecordImageTest.db";
+static const char *imageFile = "dbRecordImageTest.dbi";
+static const char *badFile = "dbRecordImageBad.dbi";
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static void writeDb(void)
+{
+    FILE *fp = fopen(dbFile, "w");
+    int i;
+
+    if (!fp)
+        testAbort("Can't create %s", dbFile);
+    for (i = 0; i < NRECORDS; i++) {
+        fprintf(fp, "record(x, \"img%d\") {\n", i);
+        fprintf(fp, "    field(DESC, \"Record number %d\")\n", i);
+        fprintf(fp, "    field(VAL, %d)\n", i);
+        fprintf(fp, "    field(F64, %d.5)\n", i);
+        fprintf(fp, "    field(PINI, YES)\n");
+        if (i > 0)
+            fprintf(fp, "    field(LNK, \"img%d.VAL CP\")\n", i - 1);
+        fprintf(fp, "    info(autosaveFields, \"VAL F64\")\n");
+        fprintf(fp, "}\n");
+    }
+    fprintf(fp, "alias(\"img0\", \"imgfirst\")\n");
+    fclose(fp);
+}
+
+static void loadDbd(void)
+{
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+}
+
+static void checkField(const char *pv, const char *expect)
+{
+    DBENTRY entry;
+
+    dbInitEntry(pdbbase, &entry);
+    if (dbFindRecord(&entry, pv)) {
+        testFail("%s not found", pv);
+    } else {
+        const char *val = dbGetString(&entry);
+
+        testOk(val && strcmp(val, expect) == 0,
+            "%s == \"%s\" (\"%s\")", pv, val ? val : "(null)", expect);
+    }
+    dbFinishEntry(&entry);
+}
+
+static void checkRecords(void)
+{
+    DBENTRY entry;
+
+    dbInitEntry(pdbbase, &entry);
+    testOk1(dbFindRecordType(&entry, "x") == 0);
+    testOk(dbGetNRecords(&entry) == NRECORDS + 1,
+        "%d records and aliases loaded", dbGetNRecords(&entry));
+    testOk1(dbFindRecord(&entry, "img7") == 0);
+    testOk(dbFindInfo(&entry, "autosaveFields") == 0 &&
+        strcmp(dbGetInfoString(&entry), "VAL F64") == 0,
+        "Info item is set");
+    testOk1(dbFindRecord(&entry, "imgfirst") == 0 && dbIsAlias(&entry));
+    dbFinishEntry(&entry);
+
+    checkField("img7.DESC", "Record number 7");
+    checkField("img7.VAL", "7");
+    checkField("img7.F64", "7.5");
+    checkField("img7.PINI", "YES");
+    checkField("img7.LNK", "img6.VAL CP");
+    checkField("img7.SCAN", "Passive");
+    checkField("imgfirst.VAL", "0");
+}
+
+static void testBadImages(void)
+{
+    FILE *in, *out;
+    char buf[256];
+    size_t n;
+
+    testDiag("Bad image files");
+
+    eltc(0);
+    testOk1(dbReadRecordImage(pdbbase, "no-such-file.dbi") != 0);
+    eltc(1);
+
+    /* Image truncated in the middle of the first record */
+    in = fopen(imageFile, "rb");
+    out = fopen(badFile, "wb");
+    if (!in || !out)
+        testAbort("Can't copy %s", imageFile);
+    n = fread(buf, 1, sizeof(buf), in);
+    fwrite(buf, 1, n / 2, out);
+    fclose(in);
+    fclose(out);
+    eltc(0);
+    testOk1(dbReadRecordImage(pdbbase, badFile) == S_dbLib_badImage);
+    eltc(1);
+
+    /* Image made with different database definitions */
+    in = fopen(imageFile, "rb");
+    out = fopen(badFile, "wb");
+    if (!in || !out)
+        testAbort("Can't copy %s", imageFile);
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        fwrite(buf, 1, n, out);
+    fclose(in);
+    fseek(out, 16, SEEK_SET); /* DBD hash */
+    fwrite("\xde\xad\xbe\xef", 1, 4, out);
+    fclose(out);
+    eltc(0);
+    testOk1(dbReadRecordImage(pdbbase, badFile) == S_dbLib_badImage);
+    eltc(1);
+    remove(badFile);
+}
+
+MAIN(dbRecordImageTest)
+{
+    epicsTimeStamp start, done;
+    double textTime, imageTime;
+
+    testPlan(44);
+
+    writeDb();
+
+    testDiag("Load %d records from %s", NRECORDS, dbFile);
+    loadDbd();
+    epicsTimeGetCurrent(&start);
+    testdbReadDatabase(dbFile, NULL, NULL);
+    epicsTimeGetCurrent(&done);
+    textTime = epicsTimeDiffInSeconds(&done, &start);
+    checkRecords();
+
+    testOk1(dbWriteRecordImage(pdbbase, imageFile) == 0);
+    testdbCleanup();
+
+    testDiag("Load %d records from %s", NRECORDS, imageFile);
+    loadDbd();
+    epicsTimeGetCurrent(&start);
+    testOk1(dbReadRecordImage(pdbbase, imageFile) == 0);
+    epicsTimeGetCurrent(&done);
+    imageTime = epicsTimeDiffInSeconds(&done, &start);
+    checkRecords();
+
+    testDiag("Text load %.3f ms, image load %.3f ms",
+        textTime * 1e3, imageTime * 1e3);
+    testdbCleanup();
+
+    testDiag("Load %s with dbRecordsOnceOnly set", imageFile);
+    loadDbd();
+    iocshCmd("var dbRecordsOnceOnly 1");
+    testOk1(dbReadRecordImage(pdbbase, imageFile) == 0);
+    checkRecords();
+    iocshCmd("var dbRecordsOnceOnly 0");
+
+    testBadImages();
+
+    testIocInitOk();
+    eltc(0);
+    testOk(dbReadRecordImage(pdbbase, imageFile) == -2,
+        "No image loading after iocInit");
+    eltc(1);
+    testdbGetFieldEqual("img10.VAL", DBR_LONG, 10);
+    testIocShutdownOk();
+
+    testdbCleanup();
+    remove(imageFile);
+    remove(dbFile);
+
+    return testDone();
+}
@@ -14,6 +14,7 @@
 
 #include "dbScan.h"
 #include "epicsEvent.h"
+#include "epicsThread.h"
 
 #include "dbUnitTest.h"
 #include "testMain.h"
@@ -66,9 +67,56 @@ static void testOnce(void)
     epicsEventDestroy(waiter);
 }
 
+static void testPeriodic(int nThreads)
+{
+    scanPeriodicStats fast, slow;
+    dbCommon *pfast, *pslow;
+
+    testDiag("periodic scans with dbScanPeriodicThreads = %d", nThreads);
+    dbScanPeriodicThreads = nThreads;
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbLockTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    pfast = testdbRecordPtr("reca");
+    pslow = testdbRecordPtr("recc");
+    testdbPutFieldOk("reca.SCAN", DBF_STRING, ".1 second");
+    testdbPutFieldOk("recc.SCAN", DBF_STRING, ".5 second");
+    scanPeriodicStatus(pfast->scan, 1, NULL);
+    scanPeriodicStatus(pslow->scan, 1, NULL);
+
+    epicsThreadSleep(1.05);
+
+    testOk1(scanPeriodicStatus(pfast->scan, 0, &fast) == 0 &&
+        scanPeriodicStatus(pslow->scan, 0, &slow) == 0);
+    testOk1(fast.numRecords == 1 && slow.numRecords == 1);
+    testDiag("%lu fast scans, %.3f ms late on average (%.3f .. %.3f)",
+        fast.numScans, fast.jitterMean * 1e3, fast.jitterMin * 1e3,
+        fast.jitterMax * 1e3);
+    testOk(fast.numScans >= 5, "fast list scanned %lu times", fast.numScans);
+    testOk(slow.numScans >= 1 && slow.numScans < fast.numScans,
+        "slow list scanned %lu times", slow.numScans);
+    testOk1(fast.jitterMin <= fast.jitterMean &&
+        fast.jitterMean <= fast.jitterMax);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    dbScanPeriodicThreads = 0;
+}
+
 MAIN(dbScanTest)
 {
-    testPlan(3);
+    testPlan(17);
     testOnce();
+    testPeriodic(0);
+    testPeriodic(2);
     return testDone();
 }
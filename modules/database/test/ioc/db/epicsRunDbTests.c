@@ -29,6 +29,7 @@ int scanIoTest(void);
 int dbLockTest(void);
 int dbPutLinkTest(void);
 int dbStaticTest(void);
+int dbRecordImageTest(void);
 int dbCaLinkTest(void);
 int testDbChannel(void);
 int chfPluginTest(void);
@@ -51,6 +52,7 @@ void epicsRunDbTests(void)
     runTest(dbLockTest);
     runTest(dbPutLinkTest);
     runTest(dbStaticTest);
+    runTest(dbRecordImageTest);
     runTest(dbCaLinkTest);
     runTest(testDbChannel);
     runTest(arrShorthandTest);
@@ -11,6 +11,8 @@
  * It calls dbLoadTemplate() to parse the substitution file, but replaces
  * dbLoadRecords() with its own version that reads the template file,
  * expands any macros in the text and prints the result to stdout.
+ * dbLoadTemplate() queues its loads with dbLoadRecordsParallel(), so
+ * that and dbLoadRecordsWait() are replaced too.
  *
  * This technique won't work on Windows, dbLoadRecords() has to be
  * epicsShare... decorated and loaded from a shared library.
@@ -78,6 +80,16 @@ int dbLoadRecords(const char *file, const char *macros)
     return 0;
 }
 
+int dbLoadRecordsParallel(const char *file, const char *macros)
+{
+    return dbLoadRecords(file, macros);
+}
+
+int dbLoadRecordsWait(void)
+{
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     input_buffer = malloc(BUFFER_SIZE);
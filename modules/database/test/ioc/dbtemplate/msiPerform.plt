@@ -0,0 +1,88 @@
+#!/usr/bin/perl
+#*************************************************************************
+# Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+#     National Laboratory.
+# SPDX-License-Identifier: EPICS
+# EPICS BASE is distributed subject to a Software License Agreement found
+# in file LICENSE that is included with this distribution.
+#*************************************************************************
+
+# Time msi expanding a large substitutions file.  Without -V the sets
+# of a file block are expanded in parallel, with -V one at a time; both
+# must give the same output.
+
+use strict;
+use Test;
+use Time::HiRes qw(time);
+
+BEGIN {plan tests => 2}
+
+my $rows = 5000;
+
+spew('perf-include.txt', <<'EOF');
+record(calc, "$(P)$(S=$(N)):sum") {
+    field(DESC, "Sum of $(N)")
+    field(INPA, "$(P)$(N):a")
+    field(INPB, "$(P)$(N):b")
+    field(CALC, "A+B")
+}
+EOF
+
+spew('perf-template.txt', <<'EOF');
+# Template for $(P)$(N)
+record(ai, "$(P)$(N):a") {
+    field(DESC, "$(DESC=Input A)")
+    field(SCAN, "$(SCAN=1 second)")
+    field(EGU, "$(EGU)")
+    field(PREC, "3")
+}
+record(ai, "$(P)$(N):b") {
+    field(DESC, "Input B of $(N)")
+    field(SCAN, "$(SCAN=1 second)")
+    field(EGU, "$(EGU)")
+}
+include "perf-include.txt"
+substitute "S=$(N)x"
+include "perf-include.txt"
+EOF
+
+my $subs = "global { P=perf: }\nfile perf-template.txt {\n" .
+    "pattern { N, EGU, DESC }\n";
+$subs .= "    { n$_, mm, \"Row $_\" }\n" foreach 1 .. $rows;
+$subs .= "}\n";
+spew('perf-substitute.txt', $subs);
+
+my ($parallel, $tp) = timed('-I. -S perf-substitute.txt');
+my ($sequential, $ts) = timed('-V -I. -S perf-substitute.txt');
+
+printf "# %d sets: %.3f s in parallel, %.3f s one at a time\n",
+    $rows, $tp, $ts;
+ok(scalar(() = $parallel =~ /^record\(calc, "perf:n\d+x?:sum"\)/mg), 2 * $rows);
+ok($parallel, $sequential);
+
+unlink 'perf-include.txt', 'perf-template.txt', 'perf-substitute.txt';
+
+# Test support routines
+
+sub spew {
+    my ($file, $contents) = @_;
+    open my $out, '>', $file
+        or die "Can't create file $file: $!\n";
+    print $out $contents;
+    close $out;
+}
+
+sub timed {
+    my ($args) = @_;
+    my $start = time;
+    my $output = msi($args);
+    return ($output, time - $start);
+}
+
+sub msi {
+    my ($args) = @_;
+    my $nul = $^O eq 'MSWin32' ? 'NUL' : '/dev/null';
+    my $msi = '@TOP@/bin/@ARCH@/msi';
+    $msi =~ tr(/)(\\) if $^O eq 'MSWin32';
+    return `$msi $args 2>$nul`;
+}
@@ -293,13 +293,59 @@ static void check(short dbr_type) {
     TEST5B(3, -8, -4, "both sides from-end");
 }
 
+static void *freedField;
+
+static void freeCopy(db_field_log *pfl)
+{
+    freedField = pfl->u.r.field;
+    free(pfl->u.r.field);
+}
+
+/* A contiguous slice of an array that is already a private copy
+ * should be a view into that copy, not another copy.
+ */
+static void checkView(void)
+{
+    dbChannel *pch;
+    db_field_log *pfl;
+    epicsInt32 *copy;
+    epicsInt32 ar5_0_1[5] = {12,13,14,15,16};
+    int i;
+
+    testHead("Contiguous slice of a private copy");
+    createAndOpen("x.VAL", "{arr:{s:2,e:6}}", "(2:1:6)", &pch, 1);
+
+    copy = (epicsInt32 *) malloc(10 * sizeof(epicsInt32));
+    for (i = 0; i < 10; i++)
+        copy[i] = 10 + i;
+    pfl = db_create_read_log(pch);
+    pfl->type = dbfl_type_ref;
+    pfl->field_type = DBF_LONG;
+    pfl->field_size = sizeof(epicsInt32);
+    pfl->no_elements = 10;
+    pfl->u.r.field = copy;
+    pfl->u.r.dtor = freeCopy;
+    pfl->u.r.pvt = NULL;
+
+    testOk(dbChannelRunPostChain(pch, pfl) == pfl,
+        "call does not drop or replace field_log");
+    testOk(pfl->u.r.field == copy + 2 && pfl->no_elements == 5,
+        "filtered field log points into the copy");
+    testOk(fl_equals_array(DBR_LONG, pfl, ar5_0_1), "array data correct");
+    freedField = NULL;
+    db_delete_field_log(pfl);
+    testOk(freedField == copy, "original copy freed with the field log");
+
+    dbChannelDelete(pch);
+}
+
 MAIN(arrTest)
 {
     dbEventCtx evtctx;
     const chFilterPlugin *plug;
     char arr[] = "arr";
 
-    testPlan(1402);
+    testPlan(1411);
 
     /* Prepare the IOC */
 
@@ -326,6 +372,7 @@ MAIN(arrTest)
     check(DBR_LONG);
     check(DBR_DOUBLE);
     check(DBR_STRING);
+    checkView();
 
     db_close_events(evtctx);
 
@@ -0,0 +1,154 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+
+#include "dbStaticLib.h"
+#include "dbAccess.h"
+#include "db_field_log.h"
+#include "dbChannel.h"
+#include "chfPlugin.h"
+#include "errlog.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static void putArray(const char *pv, const epicsFloat64 *values, long n,
+    epicsInt32 off)
+{
+    dbAddr addr;
+    char name[40];
+    epicsInt32 zero = 0;
+
+    /* the record writes at its current offset */
+    strcpy(name, pv);
+    strcat(name, ".OFF");
+    if (dbNameToAddr(name, &addr) ||
+        dbPutField(&addr, DBR_LONG, &zero, 1))
+        testAbort("Can't put to %s", name);
+    strcpy(name, pv);
+    strcat(name, ".VAL");
+    if (dbNameToAddr(name, &addr) ||
+        dbPutField(&addr, DBR_DOUBLE, values, n))
+        testAbort("Can't put to %s", name);
+    strcpy(name, pv);
+    strcat(name, ".OFF");
+    if (dbNameToAddr(name, &addr) ||
+        dbPutField(&addr, DBR_LONG, &off, 1))
+        testAbort("Can't put to %s", name);
+}
+
+static void check(const char *name, const epicsFloat64 *expect, long n)
+{
+    dbChannel *pch = dbChannelCreate(name);
+    db_field_log *pfl;
+    int ok;
+    long i;
+
+    testDiag("Channel %s", name);
+    if (!pch || dbChannelOpen(pch)) {
+        testFail("Can't open %s", name);
+        testSkip(2, "No channel");
+        if (pch) dbChannelDelete(pch);
+        return;
+    }
+    testOk(dbChannelFinalFieldType(pch) == DBF_DOUBLE,
+        "final type DBF_DOUBLE (%d)", dbChannelFinalFieldType(pch));
+
+    pfl = db_create_read_log(pch);
+    pfl = dbChannelRunPostChain(pch, pfl);
+    ok = pfl && pfl->field_type == DBF_DOUBLE && pfl->no_elements == n;
+    for (i = 0; ok && i < n; i++) {
+        epicsFloat64 got = ((epicsFloat64 *) pfl->u.r.field)[i];
+
+        if (got != expect[i]) {
+            testDiag("element %ld is %g, expected %g", i, got, expect[i]);
+            ok = 0;
+        }
+    }
+    testOk(ok, "%ld elements binned correctly (got %ld)", n,
+        pfl ? pfl->no_elements : -1);
+    db_delete_field_log(pfl);
+    testOk1(dbChannelFinalElements(pch) >= n);
+    dbChannelDelete(pch);
+}
+
+MAIN(binTest)
+{
+    const chFilterPlugin *plug;
+    char myname[] = "bin";
+    dbChannel *pch;
+    dbEventCtx evtctx;
+    epicsFloat64 ramp[10] = {10,11,12,13,14,15,16,17,18,19};
+    epicsFloat64 spike[10] = {0,0,0,9,0,0,0,0,-5,0};
+    epicsFloat64 mean5[5] = {10.5,12.5,14.5,16.5,18.5};
+    epicsFloat64 minmax2[4] = {10,14,15,19};
+    epicsFloat64 mean3[3] = {11,14,17.5}; /* bins of 3, 3 and 4 */
+    epicsFloat64 wrapped5[5] = {14.5,16.5,18.5,10.5,12.5};
+    epicsFloat64 lttb4[4] = {0,9,-5,0};
+
+    testPlan(26);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("arrTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+
+    testOk(!!(plug = dbFindFilter(myname, strlen(myname))),
+        "plugin '%s' registered correctly", myname);
+
+    testOk(!(pch = dbChannelCreate("x.VAL{bin:{}}")),
+           "dbChannel with bin (no n) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{bin:{n:0}}")),
+           "dbChannel with bin (n=0) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{bin:{n:2,m:\"median\"}}")),
+           "dbChannel with bin (m=median) failed");
+
+    putArray("x", ramp, 10, 0);
+    check("x.VAL{bin:{n:5}}", mean5, 5);
+    check("x.VAL{bin:{n:3}}", mean3, 3);
+    check("x.VAL{bin:{n:2,m:\"minmax\"}}", minmax2, 4);
+    check("x.VAL{bin:{n:20}}", ramp, 10);
+
+    testDiag("Wrapped array");
+    putArray("x", ramp, 10, 4);
+    check("x.VAL{bin:{n:5}}", wrapped5, 5);
+
+    testDiag("Largest triangle three buckets");
+    putArray("y", spike, 10, 0);
+    check("y.VAL{bin:{n:4,m:\"lttb\"}}", lttb4, 4);
+
+    testDiag("Binning after arr filter");
+    putArray("x", ramp, 10, 0);
+    check("x.VAL{arr:{s:0,e:3},bin:{n:2}}", mean5, 2);
+
+    pch = dbChannelCreate("z.VAL{bin:{n:2}}");
+    testOk(pch && !dbChannelOpen(pch) &&
+        dbChannelFinalFieldType(pch) == DBF_STRING,
+        "string array is not binned");
+    if (pch) dbChannelDelete(pch);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
@@ -26,6 +26,10 @@
 #include "dbmf.h"
 #include "testMain.h"
 #include "osiFileName.h"
+#include "dbLock.h"
+#include "epicsMath.h"
+
+#include "arrRecord.h"
 
 #define PATTERN 0x55
 
@@ -116,6 +120,117 @@ static void testHead (char* title) {
     testDiag("--------------------------------------------------------");
 }
 
+/* Set elements of an arr record, stored from element off onwards */
+static void setArray(const char *name, const double *values, long n,
+    long off)
+{
+    arrRecord *prec = (arrRecord *) testdbRecordPtr(name);
+    long i;
+
+    dbScanLock((dbCommon *) prec);
+    for (i = 0; i < n; i++) {
+        long j = (off + i) % prec->nelm;
+
+        if (prec->ftvl == DBF_LONG)
+            ((epicsInt32 *) prec->bptr)[j] = (epicsInt32) values[i];
+        else
+            ((epicsFloat64 *) prec->bptr)[j] = values[i];
+    }
+    prec->nord = n;
+    prec->off = off;
+    dbScanUnlock((dbCommon *) prec);
+}
+
+static void checkArray(dbChannel *pch, int pass, const char *what)
+{
+    db_field_log *pfl = db_create_read_log(pch);
+    db_field_log *pfl2;
+
+    if (!pfl) {
+        testFail("No field log for %s", what);
+        return;
+    }
+    pfl->ctx = dbfl_context_event;
+    pfl2 = dbChannelRunPreChain(pch, pfl);
+    if (pass)
+        testOk(pfl2 == pfl, "%s passes", what);
+    else
+        testOk(pfl2 == NULL, "%s dropped", what);
+    if (pfl2)
+        db_delete_field_log(pfl2);
+}
+
+static void testArrays(void)
+{
+    double ramp[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    double hundreds[3] = {100, 200, 300};
+    double nans[3];
+    dbChannel *pch;
+    db_field_log *pfl;
+
+    testHead("Arrays, delta = 0: pass any change");
+    pch = dbChannelCreate("a.VAL{dbnd:{}}");
+    testOk(pch && !dbChannelOpen(pch), "channel a with dbnd opened");
+    if (!pch)
+        testAbort("Can't continue without a channel");
+
+    setArray("a", ramp, 10, 0);
+    checkArray(pch, 1, "first array");
+    checkArray(pch, 0, "unchanged array");
+    ramp[9] = 10;
+    setArray("a", ramp, 10, 0);
+    checkArray(pch, 1, "change to last element");
+    setArray("a", ramp, 10, 4);
+    checkArray(pch, 0, "same array stored at an offset");
+    setArray("a", ramp, 9, 0);
+    checkArray(pch, 1, "shorter array");
+
+    pfl = db_create_read_log(pch);
+    testOk(dbChannelRunPreChain(pch, pfl) == pfl, "reads are not filtered");
+    db_delete_field_log(pfl);
+    dbChannelDelete(pch);
+
+    testHead("Arrays, delta = absolute");
+    pch = dbChannelCreate("b.VAL{dbnd:{abs:2}}");
+    testOk(pch && !dbChannelOpen(pch), "channel b with dbnd (abs=2) opened");
+    if (!pch)
+        testAbort("Can't continue without a channel");
+
+    setArray("b", hundreds, 3, 0);
+    checkArray(pch, 1, "first array");
+    hundreds[1] = 201;
+    setArray("b", hundreds, 3, 7);
+    checkArray(pch, 0, "change of 1");
+    hundreds[1] = 202.5;
+    setArray("b", hundreds, 3, 7);
+    checkArray(pch, 1, "change of 2.5");
+
+    nans[0] = nans[1] = nans[2] = epicsNAN;
+    setArray("b", nans, 3, 0);
+    checkArray(pch, 1, "change to NaN");
+    checkArray(pch, 0, "NaN unchanged");
+    dbChannelDelete(pch);
+
+    testHead("Arrays, delta = relative");
+    pch = dbChannelCreate("b.VAL{dbnd:{rel:10}}");
+    testOk(pch && !dbChannelOpen(pch), "channel b with dbnd (rel=10) opened");
+    if (!pch)
+        testAbort("Can't continue without a channel");
+
+    hundreds[0] = 100;
+    hundreds[1] = 200;
+    hundreds[2] = 300;
+    setArray("b", hundreds, 3, 0);
+    checkArray(pch, 1, "first array");
+    hundreds[2] = 320;
+    setArray("b", hundreds, 3, 0);
+    checkArray(pch, 0, "change of 6.7%");
+    hundreds[0] = 111;
+    setArray("b", hundreds, 3, 0);
+    checkArray(pch, 1, "change of 11%");
+    dbChannelDelete(pch);
+}
+
 MAIN(dbndTest)
 {
     dbChannel *pch;
@@ -130,7 +245,7 @@ MAIN(dbndTest)
     dbEventCtx evtctx;
     int logsFree, logsFinal;
 
-    testPlan(72);
+    testPlan(89);
 
     testdbPrepare();
 
@@ -139,6 +254,7 @@ MAIN(dbndTest)
     filterTest_registerRecordDeviceDriver(pdbbase);
 
     testdbReadDatabase("xRecord.db", NULL, NULL);
+    testdbReadDatabase("dbndTest.db", NULL, NULL);
 
     eltc(0);
     testIocInitOk();
@@ -299,6 +415,8 @@ MAIN(dbndTest)
 
     dbChannelDelete(pch);
 
+    testArrays();
+
     logsFinal = db_available_logs();
     testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
 
@@ -19,6 +19,9 @@ int dbndTest(void);
 int syncTest(void);
 int arrTest(void);
 int decTest(void);
+int statsTest(void);
+int binTest(void);
+int snapTest(void);
 
 void epicsRunFilterTests(void)
 {
@@ -29,6 +32,9 @@ void epicsRunFilterTests(void)
     runTest(syncTest);
     runTest(arrTest);
     runTest(decTest);
+    runTest(statsTest);
+    runTest(binTest);
+    runTest(snapTest);
 
     dbmfFreeChunks();
 
@@ -0,0 +1,324 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbChannel.h"
+#include "db_field_log.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "dbState.h"
+#include "chfPlugin.h"
+#include "errlog.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+#include "arrRecord.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static dbEventCtx evtctx;
+
+typedef struct snapMon {
+    const char *name;
+    dbChannel *chan;
+    dbEventSubscription sub;
+    epicsMutexId lock;
+    epicsEventId event;
+    unsigned count;
+    double value;
+    epicsUInt32 secs;
+    int shared;     /* chan belongs to another snapMon */
+} snapMon;
+
+static void monUpdate(void *user_arg, dbChannel *chan,
+    int eventsRemaining, db_field_log *pfl)
+{
+    snapMon *mon = (snapMon *) user_arg;
+    void *pfield = dbfl_pfield(pfl);
+
+    epicsMutexMustLock(mon->lock);
+    mon->count++;
+    mon->secs = pfl->time.secPastEpoch - 1000;
+    if (pfl->no_elements < 1)
+        mon->value = -1;
+    else if (pfl->field_type == DBF_LONG)
+        mon->value = *(epicsInt32 *) pfield;
+    else
+        mon->value = *(epicsFloat64 *) pfield;
+    epicsMutexUnlock(mon->lock);
+    epicsEventMustTrigger(mon->event);
+}
+
+static void monSubscribe(snapMon *mon, unsigned select)
+{
+    mon->sub = db_add_event(evtctx, mon->chan, monUpdate, mon, select);
+    if (!mon->sub)
+        testAbort("Can't monitor %s", mon->name);
+    db_event_enable(mon->sub);
+}
+
+static void monCreate(snapMon *mon, const char *name, unsigned select)
+{
+    memset(mon, 0, sizeof(*mon));
+    mon->name = name;
+    mon->lock = epicsMutexMustCreate();
+    mon->event = epicsEventMustCreate(epicsEventEmpty);
+    mon->chan = dbChannelCreate(name);
+    testOk(mon->chan && !dbChannelOpen(mon->chan), "opened %s", name);
+    if (!mon->chan)
+        testAbort("Can't continue without %s", name);
+    monSubscribe(mon, select);
+}
+
+/* Another monitor on the channel of other */
+static void monShare(snapMon *mon, snapMon *other, const char *name,
+    unsigned select)
+{
+    memset(mon, 0, sizeof(*mon));
+    mon->name = name;
+    mon->lock = epicsMutexMustCreate();
+    mon->event = epicsEventMustCreate(epicsEventEmpty);
+    mon->chan = other->chan;
+    mon->shared = 1;
+    monSubscribe(mon, select);
+}
+
+static void monDestroy(snapMon *mon)
+{
+    db_event_disable(mon->sub);
+    db_cancel_event(mon->sub);
+    if (!mon->shared)
+        dbChannelDelete(mon->chan);
+    epicsEventDestroy(mon->event);
+    epicsMutexDestroy(mon->lock);
+}
+
+/* Expect exactly one update with this value and time */
+static void expectUpdate(snapMon *mon, double value, epicsUInt32 secs)
+{
+    unsigned count;
+
+    for (;;) {
+        epicsMutexMustLock(mon->lock);
+        if (mon->count)
+            break;
+        epicsMutexUnlock(mon->lock);
+        if (epicsEventWaitWithTimeout(mon->event, 5.0) != epicsEventOK) {
+            epicsMutexMustLock(mon->lock);
+            break;
+        }
+    }
+    count = mon->count;
+    testOk(count == 1 && mon->value == value && mon->secs == secs,
+        "%s sent %g at %u (%u updates, expected %g at %u)", mon->name,
+        mon->value, mon->secs, count, value, secs);
+    mon->count = 0;
+    epicsMutexUnlock(mon->lock);
+}
+
+/* Expect no updates from any of these */
+static void expectNothing(const char *what, snapMon *a, snapMon *b)
+{
+    unsigned count;
+
+    epicsThreadSleep(0.2);
+    epicsMutexMustLock(a->lock);
+    count = a->count;
+    a->count = 0;
+    epicsMutexUnlock(a->lock);
+    epicsMutexMustLock(b->lock);
+    count += b->count;
+    b->count = 0;
+    epicsMutexUnlock(b->lock);
+    testOk(count == 0, "nothing sent (%s)", what);
+}
+
+/* Post a new value of element 0 of an arr record with a given time */
+static void postMask(const char *rec, double value, epicsUInt32 secs,
+    unsigned mask)
+{
+    arrRecord *prec = (arrRecord *) testdbRecordPtr(rec);
+
+    dbScanLock((dbCommon *) prec);
+    prec->time.secPastEpoch = 1000 + secs;
+    prec->time.nsec = 0;
+    if (prec->ftvl == DBF_LONG)
+        *(epicsInt32 *) prec->bptr = (epicsInt32) value;
+    else
+        *(epicsFloat64 *) prec->bptr = value;
+    prec->nord = 1;
+    prec->off = 0;
+    db_post_events(prec, NULL, mask);
+    dbScanUnlock((dbCommon *) prec);
+}
+
+static void post(const char *rec, double value, epicsUInt32 secs)
+{
+    postMask(rec, value, secs, DBE_VALUE);
+}
+
+MAIN(snapTest)
+{
+    const chFilterPlugin *plug;
+    char myname[] = "snap";
+    snapMon mx, my, gx, gy, cx, cy, vx, ax, vy;
+    dbStateId gate;
+    dbChannel *pch, *pget;
+    arrRecord *px;
+
+    testPlan(44);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("arrTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+    if (db_start_events(evtctx, "snapTest", NULL, NULL,
+            epicsThreadPriorityLow) != DB_EVENT_OK)
+        testAbort("Can't start event task");
+
+    testOk(!!(plug = dbFindFilter(myname, strlen(myname))),
+        "plugin '%s' registered correctly", myname);
+
+    testOk(!(pch = dbChannelCreate("x.VAL{snap:{}}")),
+           "dbChannel with snap (no group) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{snap:{g:\"shot\",s:\"nowhere\"}}")),
+           "dbChannel with snap (unknown state) failed");
+
+    monCreate(&mx, "x.VAL{snap:{g:\"shot\"}}", DBE_VALUE);
+    monCreate(&my, "y.VAL{snap:{g:\"shot\"}}", DBE_VALUE);
+    /* a member without a monitor doesn't hold back the group */
+    pget = dbChannelCreate("y.VAL{snap:{g:\"shot\"}}");
+    testOk(pget && !dbChannelOpen(pget), "opened get-only channel");
+
+    testDiag("Updates are sent once the group has them all");
+    post("x", 1, 1);
+    expectNothing("x only", &mx, &my);
+    post("y", 1.5, 1);
+    expectUpdate(&mx, 1, 1);
+    expectUpdate(&my, 1.5, 1);
+
+    testDiag("Held arrays are copies");
+    post("x", 10, 2);
+    px = (arrRecord *) testdbRecordPtr("x");
+    dbScanLock((dbCommon *) px);
+    *(epicsInt32 *) px->bptr = 99;
+    dbScanUnlock((dbCommon *) px);
+    post("y", 20.5, 2);
+    expectUpdate(&mx, 10, 2);
+    expectUpdate(&my, 20.5, 2);
+
+    testDiag("Updates may arrive in any order");
+    post("x", 3, 3);
+    post("x", 4, 4);
+    post("y", 3.5, 3);
+    expectUpdate(&mx, 3, 3);
+    expectUpdate(&my, 3.5, 3);
+    post("y", 4.5, 4);
+    expectUpdate(&mx, 4, 4);
+    expectUpdate(&my, 4.5, 4);
+
+    testDiag("Late updates are discarded");
+    post("y", 3.5, 3);
+    post("x", 3, 3);
+    expectNothing("already sent", &mx, &my);
+
+    testDiag("Incomplete snapshots are dropped");
+    post("x", 5, 5);
+    post("y", 6.5, 6);
+    post("x", 6, 6);
+    expectUpdate(&mx, 6, 6);
+    expectUpdate(&my, 6.5, 6);
+    post("y", 5.5, 5);
+    expectNothing("dropped", &mx, &my);
+
+    testDiag("Collecting while a state is true");
+    gate = dbStateCreate("gate");
+    monCreate(&gx, "x.VAL{snap:{g:\"gated\",s:\"gate\"}}", DBE_VALUE);
+    monCreate(&gy, "y.VAL{snap:{g:\"gated\",s:\"gate\"}}", DBE_VALUE);
+    /* these also complete the "shot" group */
+    post("x", 7, 7);
+    post("y", 7.5, 7);
+    expectUpdate(&mx, 7, 7);
+    expectUpdate(&my, 7.5, 7);
+    expectNothing("state false", &gx, &gy);
+    dbStateSet(gate);
+    post("x", 8, 8);
+    post("y", 8.5, 8);
+    expectUpdate(&gx, 8, 8);
+    expectUpdate(&gy, 8.5, 8);
+    expectUpdate(&mx, 8, 8);
+    expectUpdate(&my, 8.5, 8);
+
+    testDiag("A closed channel leaves its group");
+    monDestroy(&my);
+    post("x", 9, 9);
+    expectUpdate(&mx, 9, 9);
+
+    monDestroy(&mx);
+    dbChannelDelete(pget);
+
+    testDiag("Filters after snap see the released updates");
+    monCreate(&cx, "x.VAL{snap:{g:\"chain\"},dbnd:{d:5}}", DBE_VALUE);
+    monCreate(&cy, "y.VAL{snap:{g:\"chain\"}}", DBE_VALUE);
+    post("x", 10, 10);
+    post("y", 10.5, 10);
+    expectUpdate(&cx, 10, 10);
+    expectUpdate(&cy, 10.5, 10);
+    post("x", 11, 11);
+    post("y", 11.5, 11);
+    expectUpdate(&cy, 11.5, 11);
+    expectNothing("within deadband", &cx, &cy);
+
+    monDestroy(&cx);
+    monDestroy(&cy);
+    monDestroy(&gx);
+    monDestroy(&gy);
+
+    testDiag("Every monitor of a channel gets the snapshot");
+    monCreate(&vx, "x.VAL{snap:{g:\"multi\"}}", DBE_VALUE);
+    monShare(&ax, &vx, "x alarm", DBE_ALARM);
+    monCreate(&vy, "y.VAL{snap:{g:\"multi\"}}", DBE_VALUE);
+    postMask("x", 12, 12, DBE_VALUE | DBE_ALARM);
+    expectNothing("x only", &vx, &ax);
+    post("y", 12.5, 12);
+    expectUpdate(&vx, 12, 12);
+    expectUpdate(&ax, 12, 12);
+    expectUpdate(&vy, 12.5, 12);
+    post("x", 13, 13);
+    post("y", 13.5, 13);
+    expectUpdate(&vx, 13, 13);
+    expectUpdate(&vy, 13.5, 13);
+    expectNothing("no alarm event", &ax, &ax);
+
+    monDestroy(&ax);
+    monDestroy(&vx);
+    monDestroy(&vy);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
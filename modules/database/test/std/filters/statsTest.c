@@ -0,0 +1,206 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string.h>
+#include <math.h>
+
+#include "dbStaticLib.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbCommon.h"
+#include "dbChannel.h"
+#include "registry.h"
+#include "chfPlugin.h"
+#include "errlog.h"
+#include "dbmf.h"
+#include "alarm.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "epicsTime.h"
+#include "testMain.h"
+#include "osiFileName.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static db_field_log * fl_create(dbChannel *chan, long val, double t,
+    unsigned short sevr)
+{
+    db_field_log *pfl = db_create_read_log(chan);
+
+    memset(pfl, 0, sizeof(db_field_log));
+    pfl->ctx  = dbfl_context_event;
+    pfl->type = dbfl_type_val;
+    pfl->stat = sevr ? HIGH_ALARM : NO_ALARM;
+    pfl->sevr = sevr;
+    pfl->time.secPastEpoch = 1000 + (epicsUInt32) t;
+    pfl->time.nsec = (epicsUInt32) ((t - floor(t)) * 1e9);
+    pfl->field_type  = DBF_LONG;
+    pfl->field_size  = sizeof(epicsInt32);
+    pfl->no_elements = 1;
+    pfl->u.v.field.dbf_long = val;
+    return pfl;
+}
+
+static void testHead (char* title) {
+    testDiag("--------------------------------------------------------");
+    testDiag("%s", title);
+    testDiag("--------------------------------------------------------");
+}
+
+static void mustDrop(dbChannel *pch, db_field_log *pfl, const char* m) {
+    int oldFree = db_available_logs();
+    db_field_log *pfl2 = dbChannelRunPreChain(pch, pfl);
+    int newFree = db_available_logs();
+
+    testOk(NULL == pfl2, "filter drops field_log (%s)", m);
+    testOk(newFree == oldFree + 1, "field_log was freed - %d+1 => %d",
+        oldFree, newFree);
+
+    db_delete_field_log(pfl2);
+}
+
+static void mustSend(dbChannel *pch, db_field_log *pfl, const char* m,
+    double expect, epicsUInt32 secs, unsigned short sevr) {
+    db_field_log *pfl2 = dbChannelRunPreChain(pch, pfl);
+
+    testOk(pfl2 == pfl, "filter sends field_log (%s)", m);
+    if (pfl2) {
+        testOk(pfl2->field_type == DBF_DOUBLE &&
+            fabs(pfl2->u.v.field.dbf_double - expect) < 1e-9,
+            "value %g (%g)", pfl2->u.v.field.dbf_double, expect);
+        testOk(pfl2->time.secPastEpoch == 1000 + secs && pfl2->sevr == sevr,
+            "time %u (%u), sevr %u (%u)",
+            pfl2->time.secPastEpoch - 1000, secs, pfl2->sevr, sevr);
+    } else {
+        testSkip(2, "No field_log");
+    }
+
+    db_delete_field_log(pfl2);
+}
+
+static dbChannel * openChannel(const char *name)
+{
+    dbChannel *pch = dbChannelCreate(name);
+
+    testOk(pch && !dbChannelOpen(pch), "opened %s", name);
+    if (pch)
+        testOk(dbChannelFinalFieldType(pch) == DBF_DOUBLE &&
+            dbChannelFinalElements(pch) == 1,
+            "final type is scalar DBF_DOUBLE");
+    else
+        testSkip(1, "No channel");
+    return pch;
+}
+
+MAIN(statsTest)
+{
+    dbChannel *pch;
+    const chFilterPlugin *plug;
+    char myname[] = "stats";
+    db_field_log *pfl;
+    int logsFree, logsFinal;
+    dbEventCtx evtctx;
+
+    testPlan(65);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("xRecord.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+
+    testOk(!!(plug = dbFindFilter(myname, strlen(myname))),
+        "plugin '%s' registered correctly", myname);
+
+    /* Bad parms */
+    testOk(!(pch = dbChannelCreate("x.VAL{stats:{}}")),
+           "dbChannel with stats (no window) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{stats:{n:-1}}")),
+           "dbChannel with stats (n=-1) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{stats:{t:-1}}")),
+           "dbChannel with stats (t=-1) failed");
+    testOk(!(pch = dbChannelCreate("x.VAL{stats:{n:2,s:\"median\"}}")),
+           "dbChannel with stats (s=median) failed");
+
+    /* Start the free-list */
+    pch = dbChannelCreate("x.VAL");
+    db_delete_field_log(db_create_read_log(pch));
+    dbChannelDelete(pch);
+    logsFree = db_available_logs();
+    testDiag("%d field_logs on free-list", logsFree);
+
+    testHead("Mean of 4 updates");
+    pch = openChannel("x.VAL{stats:{n:4}}");
+    mustDrop(pch, fl_create(pch, 1, 0, NO_ALARM), "1");
+    mustDrop(pch, fl_create(pch, 2, 1, MINOR_ALARM), "2");
+    mustDrop(pch, fl_create(pch, 3, 2, NO_ALARM), "3");
+    mustSend(pch, fl_create(pch, 6, 3, NO_ALARM), "6", 3.0, 3, MINOR_ALARM);
+    mustDrop(pch, fl_create(pch, 10, 4, NO_ALARM), "10");
+    dbChannelDelete(pch);
+
+    testHead("Min, max and std of 3 updates");
+    pch = openChannel("x.VAL{stats:{n:3,s:\"min\"}}");
+    mustDrop(pch, fl_create(pch, 5, 0, NO_ALARM), "5");
+    mustDrop(pch, fl_create(pch, -2, 1, NO_ALARM), "-2");
+    mustSend(pch, fl_create(pch, 9, 2, NO_ALARM), "9", -2.0, 2, NO_ALARM);
+    dbChannelDelete(pch);
+
+    pch = openChannel("x.VAL{stats:{n:3,s:\"max\"}}");
+    mustDrop(pch, fl_create(pch, 5, 0, NO_ALARM), "5");
+    mustDrop(pch, fl_create(pch, -2, 1, NO_ALARM), "-2");
+    mustSend(pch, fl_create(pch, 9, 2, NO_ALARM), "9", 9.0, 2, NO_ALARM);
+    dbChannelDelete(pch);
+
+    pch = openChannel("x.VAL{stats:{n:3,s:\"std\"}}");
+    mustDrop(pch, fl_create(pch, 2, 0, NO_ALARM), "2");
+    mustDrop(pch, fl_create(pch, 4, 1, NO_ALARM), "4");
+    mustSend(pch, fl_create(pch, 6, 2, NO_ALARM), "6", sqrt(8.0 / 3), 2,
+        NO_ALARM);
+    dbChannelDelete(pch);
+
+    testHead("Count in 1 second windows");
+    pch = openChannel("x.VAL{stats:{t:1,s:\"n\"}}");
+    mustDrop(pch, fl_create(pch, 1, 0.0, NO_ALARM), "t=0.0");
+    mustDrop(pch, fl_create(pch, 1, 0.3, NO_ALARM), "t=0.3");
+    mustDrop(pch, fl_create(pch, 1, 0.6, NO_ALARM), "t=0.6");
+    mustSend(pch, fl_create(pch, 1, 1.2, NO_ALARM), "t=1.2", 3.0, 0,
+        NO_ALARM);
+    mustDrop(pch, fl_create(pch, 1, 1.5, NO_ALARM), "t=1.5");
+    mustSend(pch, fl_create(pch, 1, 2.4, NO_ALARM), "t=2.4", 2.0, 1,
+        NO_ALARM);
+    dbChannelDelete(pch);
+
+    testHead("Read through the filter");
+    pch = openChannel("x.VAL{stats:{n:100}}");
+    pfl = fl_create(pch, 42, 0, NO_ALARM);
+    pfl->ctx = dbfl_context_read;
+    pfl = dbChannelRunPreChain(pch, pfl);
+    testOk(pfl && pfl->field_type == DBF_DOUBLE &&
+        pfl->u.v.field.dbf_double == 42.0, "read returns the value");
+    db_delete_field_log(pfl);
+    dbChannelDelete(pch);
+
+    logsFinal = db_available_logs();
+    testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
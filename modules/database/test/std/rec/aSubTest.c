@@ -0,0 +1,208 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+#include "alarm.h"
+#include "dbLock.h"
+#include "errlog.h"
+#include "dbAccess.h"
+#include "epicsTime.h"
+#include "registryFunction.h"
+#include "menuFtype.h"
+
+#include "aSubRecord.h"
+#include "ringRecord.h"
+#include "waveformRecord.h"
+
+#define N 10000
+#define NUM_ARGS 21     /* A..U */
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+/* What the subroutine saw on its last call */
+static const void *lastA;
+static epicsUInt32 lastNEA;
+
+static
+long aSubTestSum(aSubRecord *prec)
+{
+    double sum = 0;
+    epicsUInt32 i;
+
+    lastA = prec->a;
+    lastNEA = prec->nea;
+    if (prec->fta == menuFtypeLONG) {
+        const epicsInt32 *a = (const epicsInt32 *) prec->a;
+
+        for (i = 0; i < prec->nea; i++)
+            sum += a[i];
+    }
+    else {
+        const epicsFloat64 *a = (const epicsFloat64 *) prec->a;
+
+        for (i = 0; i < prec->nea; i++)
+            sum += a[i];
+    }
+    *(epicsFloat64 *) prec->vala = sum;
+    return 0;
+}
+
+static
+void process(const char *pv)
+{
+    dbCommon *prec = testdbRecordPtr(pv);
+
+    dbScanLock(prec);
+    dbProcess(prec);
+    dbScanUnlock(prec);
+}
+
+static
+void testSum(const char *pv, double sum, epicsUInt32 nea, const void *pa)
+{
+    aSubRecord *prec = (aSubRecord *) testdbRecordPtr(pv);
+    const void *own = prec->a;
+    char name[40];
+
+    process(pv);
+    sprintf(name, "%s.VALA", pv);
+    testdbGetFieldEqual(name, DBF_DOUBLE, sum);
+    testOk(lastNEA == nea, "%s subroutine got %u elements (expected %u)",
+        pv, lastNEA, nea);
+    if (pa)
+        testOk(lastA == pa, "%s subroutine read the source data in place",
+            pv);
+    else
+        testOk(lastA == own, "%s subroutine read a copy", pv);
+    testOk(prec->a == own, "%s input pointer restored", pv);
+}
+
+static
+void testFailedInput(const char *pv)
+{
+    aSubRecord *prec = (aSubRecord *) testdbRecordPtr(pv);
+    void *own[NUM_ARGS];
+    epicsUInt32 nown[NUM_ARGS];
+    int i, restored = 1;
+
+    for (i = 0; i < NUM_ARGS; i++) {
+        own[i] = (&prec->a)[i];
+        nown[i] = (&prec->nea)[i];
+    }
+
+    lastA = NULL;
+    eltc(0);
+    process(pv);
+    eltc(1);
+
+    testOk(lastA == NULL, "%s subroutine not called", pv);
+    testOk(prec->sevr == INVALID_ALARM, "%s has an INVALID alarm (%d)",
+        pv, prec->sevr);
+    for (i = 0; i < NUM_ARGS; i++) {
+        if ((&prec->a)[i] != own[i] || (&prec->nea)[i] != nown[i]) {
+            testDiag("%s input %c changed", pv, 'A' + i);
+            restored = 0;
+        }
+    }
+    testOk(restored, "%s input pointers and counts restored", pv);
+}
+
+static
+void testTiming(const char *pv)
+{
+    epicsTimeStamp start, done;
+    int i;
+
+    epicsTimeGetCurrent(&start);
+    for (i = 0; i < 100; i++)
+        process(pv);
+    epicsTimeGetCurrent(&done);
+    testDiag("%s: %.3f ms per process", pv,
+        epicsTimeDiffInSeconds(&done, &start) * 10.0);
+}
+
+MAIN(aSubTest)
+{
+    epicsFloat64 *values = calloc(N, sizeof(epicsFloat64));
+    epicsFloat64 four[4] = {1, 2, 3, 4};
+    epicsFloat64 two[2] = {5, 6};
+    waveformRecord *pwf;
+    ringRecord *prg;
+    char macros[40];
+    int i;
+
+    testPlan(38);
+
+    if (!values)
+        testAbort("Out of memory");
+
+    testdbPrepare();
+
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    registryFunctionAdd("aSubTestSum", (REGISTRYFUNCTION) aSubTestSum);
+
+    sprintf(macros, "N=%d", N);
+    testdbReadDatabase("aSubTest.db", NULL, macros);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    pwf = (waveformRecord *) testdbRecordPtr("wf");
+    prg = (ringRecord *) testdbRecordPtr("rg");
+
+    for (i = 0; i < N; i++)
+        values[i] = i;
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, N, values);
+
+    testDiag("Inputs are copied by default");
+    testSum("copy", N * (N - 1.0) / 2, N, NULL);
+
+    testDiag("Same type inputs are referenced");
+    testSum("ref", N * (N - 1.0) / 2, N, pwf->bptr);
+
+    testDiag("Shorter source arrays");
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, 10, values);
+    testSum("ref", 45, 10, pwf->bptr);
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, N, values);
+
+    testDiag("Other types are converted");
+    testSum("conv", N * (N - 1.0) / 2, N, NULL);
+
+    testDiag("Filtered inputs are copied");
+    testSum("filt", 10, 5, NULL);
+
+    testDiag("A contiguous ring buffer is referenced");
+    testdbPutArrFieldOk("rg.APND", DBF_DOUBLE, 3, four);
+    testdbPutArrFieldOk("rg", DBF_DOUBLE, 2, two);
+    testSum("ring", 11, 2, prg->bptr);
+
+    testDiag("A wrapped ring buffer is copied");
+    testdbPutArrFieldOk("rg.APND", DBF_DOUBLE, 4, four);
+    testdbPutArrFieldOk("rg.APND", DBF_DOUBLE, 1, two);
+    testSum("ring", 14, 4, NULL);
+
+    testDiag("A failed input after a referenced one");
+    testFailedInput("fail");
+
+    testTiming("copy");
+    testTiming("ref");
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    free(values);
+
+    return testDone();
+}
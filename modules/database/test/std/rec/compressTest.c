@@ -5,12 +5,16 @@
 * in file LICENSE that is included with this distribution.
 \*************************************************************************/
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "dbUnitTest.h"
 #include "testMain.h"
 #include "dbLock.h"
 #include "errlog.h"
 #include "dbAccess.h"
 #include "epicsMath.h"
+#include "epicsTime.h"
 
 #include "aiRecord.h"
 #include "compressRecord.h"
@@ -346,10 +350,127 @@ void testLIFOCirc(void)
     testdbCleanup();
 }
 
+/* Large arrays through the N to 1 algorithms.  Block i of the input holds
+ * i*N + 0 .. i*N + N-1 in some order, so the low, high, average and median
+ * of each block are known.
+ */
+#define BENCH_NELM 100000
+#define BENCH_N    1000
+#define BENCH_NSAM (BENCH_NELM / BENCH_N)
+
+typedef enum {
+    benchPermuted,
+    benchDescending,
+    benchConstant
+} benchPattern;
+
+static
+void benchProcess(const char *pv, benchPattern pattern, double *expect)
+{
+    static const char * const patName[] = {"permuted", "descending", "constant"};
+    dbCommon *prec = testdbRecordPtr(pv);
+    epicsTimeStamp start, done;
+
+    dbScanLock(prec);
+    epicsTimeGetCurrent(&start);
+    dbProcess(prec);
+    epicsTimeGetCurrent(&done);
+    dbScanUnlock(prec);
+
+    testDiag("%s of %d x %d %s values: %.3f ms", pv, BENCH_NSAM, BENCH_N,
+        patName[pattern], epicsTimeDiffInSeconds(&done, &start) * 1e3);
+    testdbGetArrFieldEqual(pv, DBF_DOUBLE, BENCH_NSAM, BENCH_NSAM, expect);
+}
+
+static
+void benchRun(benchPattern pattern, double *input, double *expect)
+{
+    long i, j;
+
+    for (i = 0; i < BENCH_NSAM; i++) {
+        for (j = 0; j < BENCH_N; j++) {
+            double *pval = &input[i * BENCH_N + j];
+
+            switch (pattern) {
+            case benchPermuted:
+                /* 7919 is prime, so this visits each of 0 .. N-1 once */
+                *pval = i * BENCH_N + (j * 7919 + i * 13) % BENCH_N;
+                break;
+            case benchDescending:
+                *pval = i * BENCH_N + (BENCH_N - 1 - j);
+                break;
+            case benchConstant:
+                *pval = 42.0;
+                break;
+            }
+        }
+    }
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, BENCH_NELM, input);
+
+#define EXPECT(OFFSET) \
+    for (i = 0; i < BENCH_NSAM; i++) \
+        expect[i] = pattern == benchConstant ? 42.0 : i * BENCH_N + (OFFSET)
+
+    EXPECT(0);
+    benchProcess("low", pattern, expect);
+    EXPECT(BENCH_N - 1);
+    benchProcess("high", pattern, expect);
+    EXPECT((BENCH_N - 1) / 2.0);
+    benchProcess("avg", pattern, expect);
+    EXPECT(BENCH_N / 2);
+    benchProcess("med", pattern, expect);
+#undef EXPECT
+}
+
+static
+void testNto1Bench(void)
+{
+    double *input = calloc(BENCH_NELM, sizeof(double));
+    double expect[BENCH_NSAM];
+    char macros[80];
+
+    testDiag("Test N to 1 algorithms on large arrays");
+
+    if (!input)
+        testAbort("Out of memory");
+
+    testdbPrepare();
+
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    sprintf(macros, "NELM=%d,N=%d,NSAM=%d", BENCH_NELM, BENCH_N, BENCH_NSAM);
+    testdbReadDatabase("compressBench.db", NULL, macros);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    benchRun(benchPermuted, input, expect);
+    benchRun(benchDescending, input, expect);
+    benchRun(benchConstant, input, expect);
+
+    testDiag("Circular buffers keep the last values of a larger array");
+    benchRun(benchDescending, input, expect);
+    testdbPutFieldOk("fifo.PROC", DBF_LONG, 1);
+    testdbPutFieldOk("lifo.PROC", DBF_LONG, 1);
+    checkArrD("fifo", 4, input[BENCH_NELM - 4], input[BENCH_NELM - 3],
+        input[BENCH_NELM - 2], input[BENCH_NELM - 1]);
+    checkArrD("lifo", 4, input[BENCH_NELM - 1], input[BENCH_NELM - 2],
+        input[BENCH_NELM - 3], input[BENCH_NELM - 4]);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    free(input);
+}
+
 MAIN(compressTest)
 {
-    testPlan(116);
+    testPlan(140);
     testFIFOCirc();
     testLIFOCirc();
+    testNto1Bench();
     return testDone();
 }
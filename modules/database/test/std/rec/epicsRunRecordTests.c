@@ -14,7 +14,10 @@
 #include "epicsExit.h"
 
 int analogMonitorTest(void);
+int aSubTest(void);
 int compressTest(void);
+int histogramTest(void);
+int ringTest(void);
 int recMiscTest(void);
 int arrayOpTest(void);
 int asTest(void);
@@ -31,7 +34,10 @@ void epicsRunRecordTests(void)
 
     runTest(analogMonitorTest);
 
+    runTest(aSubTest);
     runTest(compressTest);
+    runTest(histogramTest);
+    runTest(ringTest);
 
     runTest(recMiscTest);
 
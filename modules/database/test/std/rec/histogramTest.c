@@ -0,0 +1,195 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+#include "dbLock.h"
+#include "errlog.h"
+#include "dbAccess.h"
+#include "epicsMath.h"
+#include "epicsTime.h"
+
+#include "histogramRecord.h"
+
+#define NSMP 10000
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void process(const char *pv)
+{
+    dbCommon *prec = testdbRecordPtr(pv);
+
+    dbScanLock(prec);
+    dbProcess(prec);
+    dbScanUnlock(prec);
+}
+
+static
+void checkCounts(const char *pv, const epicsUInt32 *expect)
+{
+    testdbGetArrFieldEqual(pv, DBF_ULONG, 10, 10, expect);
+}
+
+static
+void testScalar(void)
+{
+    epicsUInt32 expect[10] = {1, 1, 0, 0, 0, 0, 0, 0, 0, 1};
+
+    testDiag("One sample per process");
+
+    /* a value on a boundary is counted in the element below it */
+    testdbPutFieldOk("val", DBF_DOUBLE, 0.0);
+    process("scalar");
+    testdbPutFieldOk("val", DBF_DOUBLE, 2.0);
+    process("scalar");
+    testdbPutFieldOk("val", DBF_DOUBLE, 9.999);
+    process("scalar");
+    testdbPutFieldOk("val", DBF_DOUBLE, 10.0);
+    process("scalar");
+    testdbPutFieldOk("val", DBF_DOUBLE, -0.5);
+    process("scalar");
+    checkCounts("scalar", expect);
+}
+
+static
+void testBatch(double *samples)
+{
+    epicsUInt32 expect[10];
+    epicsTimeStamp start, done;
+    long i;
+
+    testDiag("Arrays of %d samples", NSMP);
+
+    /* every element gets NSMP/10 samples, and one more is out of range */
+    for (i = 0; i < NSMP; i++)
+        samples[i] = (i % 10) + 0.5;
+    samples[7] = 11.0;
+    samples[8] = epicsNAN;
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, NSMP, samples);
+
+    epicsTimeGetCurrent(&start);
+    process("batch");
+    epicsTimeGetCurrent(&done);
+    testDiag("Counted %d samples in %.3f ms", NSMP,
+        epicsTimeDiffInSeconds(&done, &start) * 1e3);
+
+    for (i = 0; i < 10; i++)
+        expect[i] = NSMP / 10;
+    expect[7]--;
+    expect[8]--;
+    checkCounts("batch", expect);
+    testdbGetFieldEqual("batch.NSRD", DBF_ULONG, NSMP);
+    testdbGetFieldEqual("batch.SGNL", DBF_DOUBLE, samples[NSMP - 1]);
+
+    process("batch");
+    for (i = 0; i < 10; i++)
+        expect[i] *= 2;
+    checkCounts("batch", expect);
+
+    testDiag("Shorter arrays");
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, 3, samples);
+    process("batch");
+    testdbGetFieldEqual("batch.NSRD", DBF_ULONG, 3);
+    expect[0]++;
+    expect[1]++;
+    expect[2]++;
+    checkCounts("batch", expect);
+
+    testDiag("Clear");
+    testdbPutFieldOk("batch.CMD", DBF_ULONG, histogramCMD_Clear);
+    for (i = 0; i < 10; i++)
+        expect[i] = 0;
+    checkCounts("batch", expect);
+}
+
+static
+void testDecay(double *samples)
+{
+    epicsUInt32 expect[10];
+    long i;
+
+    testDiag("Decaying counts");
+
+    for (i = 0; i < NSMP; i++)
+        samples[i] = (i % 10) + 0.5;
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, NSMP, samples);
+
+    process("decay");
+    for (i = 0; i < 10; i++)
+        expect[i] = NSMP / 10;
+    checkCounts("decay", expect);
+
+    process("decay");
+    for (i = 0; i < 10; i++)
+        expect[i] = NSMP / 10 + NSMP / 20;
+    checkCounts("decay", expect);
+
+    /* with no new samples the counts keep halving */
+    testdbPutArrFieldOk("wf", DBF_DOUBLE, 1, samples);
+    process("decay");
+    process("decay");
+    for (i = 0; i < 10; i++)
+        expect[i] = (NSMP / 10 + NSMP / 20) / 4;
+    expect[0] += 2;     /* 751, then 376.5 which rounds up */
+    checkCounts("decay", expect);
+}
+
+static
+void testSimulated(void)
+{
+    epicsUInt32 expect[10] = {0, 0, 0, 1, 0, 0, 0, 0, 0, 0};
+
+    testDiag("Scalar sample when no array was read");
+
+    /* simulation mode reads SIOL into SGNL, not an array into SPTR */
+    testdbPutFieldOk("val", DBF_DOUBLE, 3.5);
+    process("simulated");
+    checkCounts("simulated", expect);
+    testdbGetFieldEqual("simulated.NSRD", DBF_ULONG, 0);
+    testdbGetFieldEqual("simulated.SGNL", DBF_DOUBLE, 3.5);
+}
+
+MAIN(histogramTest)
+{
+    double *samples = calloc(NSMP, sizeof(double));
+    char macros[40];
+
+    testPlan(25);
+
+    if (!samples)
+        testAbort("Out of memory");
+
+    testdbPrepare();
+
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    sprintf(macros, "NSMP=%d", NSMP);
+    testdbReadDatabase("histogramTest.db", NULL, macros);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testScalar();
+    testBatch(samples);
+    testDecay(samples);
+    testSimulated();
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    free(samples);
+
+    return testDone();
+}
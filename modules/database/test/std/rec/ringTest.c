@@ -0,0 +1,193 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+#include "dbLock.h"
+#include "errlog.h"
+#include "dbAccess.h"
+#include "epicsTime.h"
+
+#include "ringRecord.h"
+
+#define BATCH 1000
+#define NBIG 100000
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void process(const char *pv)
+{
+    dbCommon *prec = testdbRecordPtr(pv);
+
+    dbScanLock(prec);
+    dbProcess(prec);
+    dbScanUnlock(prec);
+}
+
+static
+void testInput(void)
+{
+    static const epicsFloat64 first[3] = {1, 2, 3};
+    static const epicsFloat64 second[3] = {4, 5, 6};
+    static const epicsFloat64 oldest[5] = {2, 3, 4, 5, 6};
+    static const epicsFloat64 stored[5] = {6, 2, 3, 4, 5};
+    static const epicsFloat64 slice[2] = {3, 4};
+    static const epicsFloat64 many[8] = {11, 12, 13, 14, 15, 16, 17, 18};
+    ringRecord *prec = (ringRecord *) testdbRecordPtr("rg");
+
+    testDiag("Appending from INP");
+
+    testdbGetFieldEqual("rg.NUSE", DBF_ULONG, 0);
+    testdbGetArrFieldEqual("rg", DBF_DOUBLE, 5, 0, NULL);
+
+    testdbPutArrFieldOk("src", DBF_DOUBLE, 3, first);
+    process("rg");
+    testdbGetArrFieldEqual("rg", DBF_DOUBLE, 5, 3, first);
+
+    testdbPutArrFieldOk("src", DBF_DOUBLE, 3, second);
+    process("rg");
+    testdbGetFieldEqual("rg.NUSE", DBF_ULONG, 5);
+    testdbGetFieldEqual("rg.HEAD", DBF_ULONG, 1);
+    testdbGetArrFieldEqual("rg", DBF_DOUBLE, 5, 5, oldest);
+
+    dbScanLock((dbCommon *) prec);
+    testOk(memcmp(prec->bptr, stored, sizeof(stored)) == 0,
+        "Buffer is not reordered");
+    dbScanUnlock((dbCommon *) prec);
+
+    testDiag("Reading through the arr filter");
+    process("sub");
+    testdbGetArrFieldEqual("sub", DBF_DOUBLE, 5, 2, slice);
+
+    testDiag("More values than the buffer holds");
+    testdbPutArrFieldOk("src", DBF_DOUBLE, 8, many);
+    process("rg");
+    testdbGetArrFieldEqual("rg", DBF_DOUBLE, 5, 5, many);
+
+    testDiag("Reset");
+    testdbPutFieldOk("rg.RES", DBF_SHORT, 1);
+    testdbGetFieldEqual("rg.NUSE", DBF_ULONG, 0);
+    testdbGetArrFieldEqual("rg", DBF_DOUBLE, 5, 0, NULL);
+}
+
+static
+void testPut(void)
+{
+    static const epicsInt32 first[3] = {1, 2, 3};
+    static const epicsInt32 second[2] = {4, 5};
+    static const epicsInt32 both[4] = {2, 3, 4, 5};
+    static const epicsInt32 third[3] = {6, 7, 8};
+    static const epicsInt32 appended[4] = {5, 6, 7, 8};
+    static const epicsInt32 replaced[2] = {9, 10};
+    static const epicsInt32 mixed[4] = {10, 6, 7, 8};
+
+    testDiag("Appending with puts to APND");
+
+    testdbPutArrFieldOk("pr.APND", DBF_LONG, 3, first);
+    testdbGetArrFieldEqual("pr", DBF_LONG, 4, 3, first);
+    testdbPutArrFieldOk("pr.APND", DBF_LONG, 2, second);
+    testdbGetArrFieldEqual("pr", DBF_LONG, 4, 4, both);
+    testdbPutArrFieldOk("pr.APND", DBF_LONG, 3, third);
+    testdbGetArrFieldEqual("pr", DBF_LONG, 4, 4, appended);
+    testdbGetArrFieldEqual("pr.APND", DBF_LONG, 4, 0, NULL);
+
+    testDiag("Replacing with puts to VAL");
+    testdbPutArrFieldOk("pr", DBF_LONG, 2, replaced);
+    testdbGetFieldEqual("pr.NUSE", DBF_ULONG, 2);
+    testdbGetArrFieldEqual("pr", DBF_LONG, 4, 2, replaced);
+    testdbPutArrFieldOk("pr.APND", DBF_LONG, 3, third);
+    testdbGetArrFieldEqual("pr", DBF_LONG, 4, 4, mixed);
+
+    testDiag("Constant INP");
+    testdbGetArrFieldEqual("ci", DBF_LONG, 4, 3, first);
+}
+
+static
+void testBatch(epicsFloat64 *values)
+{
+    epicsTimeStamp start, done;
+    ringRecord *prec = (ringRecord *) testdbRecordPtr("big");
+    DBADDR addr;
+    int ok = 1;
+    long i, n;
+
+    testDiag("Appending %d batches of %d to a buffer of %d",
+        2 * NBIG / BATCH, BATCH, NBIG);
+
+    if (dbNameToAddr("batch", &addr))
+        testAbort("Missing PV batch");
+
+    epicsTimeGetCurrent(&start);
+    for (n = 0; n < 2 * NBIG / BATCH; n++) {
+        for (i = 0; i < BATCH; i++)
+            values[i] = n * BATCH + i;
+        dbScanLock(addr.precord);
+        dbPut(&addr, DBR_DOUBLE, values, BATCH);
+        dbScanUnlock(addr.precord);
+        process("big");
+    }
+    epicsTimeGetCurrent(&done);
+    testDiag("%.3f ms per batch",
+        epicsTimeDiffInSeconds(&done, &start) * 1e3 / n);
+
+    testdbGetFieldEqual("big.NUSE", DBF_ULONG, NBIG);
+
+    dbScanLock((dbCommon *) prec);
+    for (i = 0; ok && i < NBIG; i++) {
+        epicsFloat64 expect = NBIG + i;
+        epicsFloat64 got = ((epicsFloat64 *) prec->bptr)
+            [(prec->head + i) % NBIG];
+
+        if (got != expect) {
+            testDiag("element %ld is %g, expected %g", i, got, expect);
+            ok = 0;
+        }
+    }
+    dbScanUnlock((dbCommon *) prec);
+    testOk(ok, "Buffer holds the last %d values", NBIG);
+}
+
+MAIN(ringTest)
+{
+    epicsFloat64 *values = calloc(BATCH, sizeof(epicsFloat64));
+    char macros[40];
+
+    testPlan(30);
+
+    if (!values)
+        testAbort("Out of memory");
+
+    testdbPrepare();
+
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    sprintf(macros, "B=%d,N=%d", BATCH, NBIG);
+    testdbReadDatabase("ringTest.db", NULL, macros);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testInput();
+    testPut();
+    testBatch(values);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    free(values);
+
+    return testDone();
+}
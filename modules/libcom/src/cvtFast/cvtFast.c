@@ -15,20 +15,563 @@
  */
 
 #include <string.h>
+#include <stdlib.h>
 #include <limits.h>
 
 #include "cvtFast.h"
 #include "epicsMath.h"
 #include "epicsStdio.h"
+#include "epicsStdlib.h"
 
 /*
  * These routines convert numbers up to +/- 10,000,000.
- * They defer to sprintf() for numbers requiring more than
- * 8 places of precision.
+ * Larger numbers and those requiring more than 8 places of
+ * precision are formatted as sprintf() would, but faster.
  */
 static epicsInt32 frac_multiplier[] =
     {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
 
+/*
+ * Exact conversions for the numbers the routines below used to pass
+ * on to sprintf().  A double is f * 2^e; multiplying f by a 128-bit
+ * power of ten from the table and by a small exact one gives f * 10^s
+ * as a 224-bit product, from which the whole part and the top 64 bits
+ * of the fraction are taken.  The table is correctly rounded, so the
+ * fraction is good to within a couple of units in its last place.  If
+ * that isn't enough to decide the rounding, which in practice only
+ * happens for exact ties where C libraries disagree, these return -1
+ * and the caller falls back to sprintf().
+ */
+#define POW10_MIN (-40)     /* 1e-320 */
+#define POW10_MAX 43        /* 1e344 */
+#define POW10_EXACT_MAX 6   /* 1e48 fits in 128 bits */
+
+static const struct pow10Entry {
+    epicsUInt32 m[4];       /* most significant first */
+    short e;
+} pow10Cache[] = {
+    {{0xfd00b897, 0x478238d0, 0x8920b098, 0x955522b5}, -1191}, /* 1e-320 */
+    {{0xbc807527, 0xed3e12bc, 0xc6050837, 0x04f5ecf2}, -1164}, /* 1e-312 */
+    {{0x8c71dcd9, 0xba0b4925, 0x9ff0c08b, 0x7f1d0b15}, -1137}, /* 1e-304 */
+    {{0xd1476e2c, 0x07286faa, 0x1af5af66, 0x0db4aee2}, -1111}, /* 1e-296 */
+    {{0x9becce62, 0x836ac577, 0x4ee367f9, 0x430aec33}, -1084}, /* 1e-288 */
+    {{0xe858ad24, 0x8f5c22c9, 0xd1b3400f, 0x8f9cff69}, -1058}, /* 1e-280 */
+    {{0xad1c8eab, 0x5ee43b66, 0xda324365, 0x0005eecf}, -1031}, /* 1e-272 */
+    {{0x80fa687f, 0x881c7f8e, 0x7ce66634, 0xbc9d0b9a}, -1004}, /* 1e-264 */
+    {{0xc0314325, 0x637a1939, 0xfa911155, 0xfefb5309},  -978}, /* 1e-256 */
+    {{0x8f31cc09, 0x37ae58d2, 0xd1b2ecb8, 0xb0908811},  -951}, /* 1e-248 */
+    {{0xd5605fcd, 0xcf32e1d6, 0xfb1e4a9a, 0x90880a65},  -925}, /* 1e-240 */
+    {{0x9efa548d, 0x26e5a6e1, 0xc47bc501, 0x4a1a6db0},  -898}, /* 1e-232 */
+    {{0xece53cec, 0x4a314ebd, 0xa4f8bf56, 0x35246428},  -872}, /* 1e-224 */
+    {{0xb080392c, 0xc4349dec, 0xbd8d794d, 0x96aacfb4},  -845}, /* 1e-216 */
+    {{0x8380dea9, 0x3da4bc60, 0x4247cb9e, 0x59f71e6d},  -818}, /* 1e-208 */
+    {{0xc3f490aa, 0x77bd60fc, 0xbedbfc44, 0x11068a9d},  -792}, /* 1e-200 */
+    {{0x91ff8377, 0x5423cc06, 0x7b6306a3, 0x4627ddcf},  -765}, /* 1e-192 */
+    {{0xd98ddaee, 0x19068c76, 0x3badd624, 0xdd9b0957},  -739}, /* 1e-184 */
+    {{0xa21727db, 0x38cb002f, 0xb8ada00e, 0x5a506a7d},  -712}, /* 1e-176 */
+    {{0xf18899b1, 0xbc3f8ca1, 0xdc44e6c3, 0xcb279ac2},  -686}, /* 1e-168 */
+    {{0xb3f4e093, 0xdb73a093, 0x59ed2167, 0x65690f57},  -659}, /* 1e-160 */
+    {{0x8613fd01, 0x45877585, 0xbd06742c, 0xe95f5f37},  -632}, /* 1e-152 */
+    {{0xc7caba6e, 0x7c5382c8, 0xfe64a52e, 0xe96b8fc1},  -606}, /* 1e-144 */
+    {{0x94db4838, 0x40b717ef, 0xa8c2a44e, 0xb4571cdc},  -579}, /* 1e-136 */
+    {{0xddd0467c, 0x64bce4a0, 0xac7cb3f6, 0xd05ddbdf},  -553}, /* 1e-128 */
+    {{0xa54394fe, 0x1eedb8fe, 0xc2974eb4, 0xee658829},  -526}, /* 1e-120 */
+    {{0xf64335bc, 0xf065d37d, 0x4d4617b5, 0xff4a16d6},  -500}, /* 1e-112 */
+    {{0xb77ada06, 0x17e3bbcb, 0x09ce6ebb, 0x40173745},  -473}, /* 1e-104 */
+    {{0x88b402f7, 0xfd75539b, 0x11dbcb02, 0x18ebb414},  -446}, /* 1e-96 */
+    {{0xcbb41ef9, 0x79346bca, 0x4f2b40a0, 0x3ad2ffba},  -420}, /* 1e-88 */
+    {{0x97c560ba, 0x6b0919a5, 0xdccd879f, 0xc967d41a},  -393}, /* 1e-80 */
+    {{0xe2280b6c, 0x20dd5232, 0x25c6da63, 0xc38de1b0},  -367}, /* 1e-72 */
+    {{0xa87fea27, 0xa539e9a5, 0x3f2398d7, 0x47b36224},  -340}, /* 1e-64 */
+    {{0xfb158592, 0xbe068d2e, 0xeed6e2f0, 0xf0d56713},  -314}, /* 1e-56 */
+    {{0xbb127c53, 0xb17ec159, 0x5560c018, 0x580d5d52},  -287}, /* 1e-48 */
+    {{0x8b61313b, 0xbabce2c6, 0x2323ac4b, 0x3b3da015},  -260}, /* 1e-40 */
+    {{0xcfb11ead, 0x453994ba, 0x67de18ed, 0xa5814af2},  -234}, /* 1e-32 */
+    {{0x9abe14cd, 0x44753b52, 0xc4926a96, 0x72793543},  -207}, /* 1e-24 */
+    {{0xe69594be, 0xc44de15b, 0x4c2ebe68, 0x7989a9b4},  -181}, /* 1e-16 */
+    {{0xabcc7711, 0x8461cefc, 0xfdc20d2b, 0x36ba7c3d},  -154}, /* 1e-8 */
+    {{0x80000000, 0x00000000, 0x00000000, 0x00000000},  -127}, /* 1e0 */
+    {{0xbebc2000, 0x00000000, 0x00000000, 0x00000000},  -101}, /* 1e8 */
+    {{0x8e1bc9bf, 0x04000000, 0x00000000, 0x00000000},   -74}, /* 1e16 */
+    {{0xd3c21bce, 0xcceda100, 0x00000000, 0x00000000},   -48}, /* 1e24 */
+    {{0x9dc5ada8, 0x2b70b59d, 0xf0200000, 0x00000000},   -21}, /* 1e32 */
+    {{0xeb194f8e, 0x1ae525fd, 0x5dcfab08, 0x00000000},     5}, /* 1e40 */
+    {{0xaf298d05, 0x0e4395d6, 0x9670b12b, 0x7f410000},    32}, /* 1e48 */
+    {{0x82818f12, 0x81ed449f, 0xbff8f10e, 0x7a8921a4},    59}, /* 1e56 */
+    {{0xc2781f49, 0xffcfa6d5, 0x3cbf6b71, 0xc76b25fb},    85}, /* 1e64 */
+    {{0x90e40fbe, 0xea1d3a4a, 0xbc8955e9, 0x46fe31ce},   112}, /* 1e72 */
+    {{0xd7e77a8f, 0x87daf7fb, 0xdc33745e, 0xc97be906},   138}, /* 1e80 */
+    {{0xa0dc75f1, 0x778e39d6, 0x696361ae, 0x3db1c721},   165}, /* 1e88 */
+    {{0xefb3ab16, 0xc59b14a2, 0xc5cfe94e, 0xf3ea101e},   191}, /* 1e96 */
+    {{0xb2977ee3, 0x00c50fe7, 0x58edec91, 0xec2cb658},   218}, /* 1e104 */
+    {{0x850fadc0, 0x9923329e, 0x03e2cf6b, 0xc604ddb0},   245}, /* 1e112 */
+    {{0xc646d635, 0x01a1511d, 0xb281e1fd, 0x541501b9},   271}, /* 1e120 */
+    {{0x93ba47c9, 0x80e98cdf, 0xc66f336c, 0x36b10137},   298}, /* 1e128 */
+    {{0xdc21a117, 0x1d42645d, 0x76707543, 0xf4fa1f74},   324}, /* 1e136 */
+    {{0xa402b9c5, 0xa8d3a6e7, 0x5f16206c, 0x9c6209a6},   351}, /* 1e144 */
+    {{0xf46518c2, 0xef5b8cd1, 0x7eb25866, 0x5fc25d69},   377}, /* 1e152 */
+    {{0xb616a12b, 0x7fe617aa, 0x577b986b, 0x314d6009},   404}, /* 1e160 */
+    {{0x87aa9aff, 0x79042286, 0x90fb44d2, 0xf05d0843},   431}, /* 1e168 */
+    {{0xca28a291, 0x859bbf93, 0x7d7b8f75, 0x03cfdcff},   457}, /* 1e176 */
+    {{0x969eb7c4, 0x7859e743, 0x9f644ae5, 0xa4b1b325},   484}, /* 1e184 */
+    {{0xe070f78d, 0x3927556a, 0x85bbe253, 0xf47b1417},   510}, /* 1e192 */
+    {{0xa738c6be, 0xbb12d16c, 0xb428f8ac, 0x016561db},   537}, /* 1e200 */
+    {{0xf92e0c35, 0x37826145, 0xa7709a56, 0xccdf8a83},   563}, /* 1e208 */
+    {{0xb9a74a06, 0x37ce2ee1, 0x6d953e2b, 0xd7173693},   590}, /* 1e216 */
+    {{0x8a5296ff, 0xe33cc92f, 0x82bd6b70, 0xd99aaa70},   617}, /* 1e224 */
+    {{0xce1de406, 0x42e3f4b9, 0x36251260, 0xab9d668f},   643}, /* 1e232 */
+    {{0x9991a6f3, 0xd6bf1765, 0xacca6da1, 0xe0a8ef29},   670}, /* 1e240 */
+    {{0xe4d5e823, 0x92a40515, 0x0fabaf3f, 0xeaa5334a},   696}, /* 1e248 */
+    {{0xaa7eebfb, 0x9df9de8d, 0xddbb901b, 0x98feeab8},   723}, /* 1e256 */
+    {{0xfe0efb53, 0xd30dd4d7, 0xed238cd3, 0x83aa0111},   749}, /* 1e264 */
+    {{0xbd49d14a, 0xa79dbc82, 0x4b2d8644, 0xd8a74e19},   776}, /* 1e272 */
+    {{0x8d07e334, 0x55637eb2, 0xdb0b487b, 0x6423e1e8},   803}, /* 1e280 */
+    {{0xd226fc19, 0x5c6a2f8c, 0x73832eec, 0x6fff3112},   829}, /* 1e288 */
+    {{0x9c935e00, 0xd4b9d8d2, 0x6ed1bf9a, 0x569f33d3},   856}, /* 1e296 */
+    {{0xe950df20, 0x247c83fd, 0x47c6b82e, 0xf32a2069},   882}, /* 1e304 */
+    {{0xadd57a27, 0xd29339f6, 0x79c5db9a, 0xf1f9b563},   909}, /* 1e312 */
+    {{0x81842f29, 0xf2cce375, 0xe6a11583, 0x00d46640},   936}, /* 1e320 */
+    {{0xc0fe9088, 0x95cf3b44, 0x505f522e, 0x53053ff2},   962}, /* 1e328 */
+    {{0x8fcac257, 0x558ee4e6, 0x213a4f0a, 0xa5e8a7b2},   989}, /* 1e336 */
+    {{0xd6444e39, 0xc3db9b09, 0x848ce346, 0x79abb01c},  1015}, /* 1e344 */
+};
+
+static const epicsUInt64 pow10Int[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+/* A scaled number, with its fraction in units of 2^-64 known to
+ * within +/- slop units.
+ */
+typedef struct scaledNum {
+    epicsUInt64 whole;
+    epicsUInt64 frac;
+    epicsUInt64 slop;
+} scaledNum;
+
+#define HALF ((epicsUInt64) 1 << 63)
+
+/* Split |val| into f * 2^e, returns the sign */
+static int splitDouble(double val, epicsUInt64 *pf, int *pe)
+{
+    epicsUInt64 bits;
+    int be;
+
+    memcpy(&bits, &val, sizeof(bits));
+    be = (int) (bits >> 52) & 0x7ff;
+    *pf = bits & (((epicsUInt64) 1 << 52) - 1);
+    if (be) {
+        *pf |= (epicsUInt64) 1 << 52;
+        *pe = be - 1075;
+    }
+    else
+        *pe = -1074;
+    return (int) (bits >> 63);
+}
+
+static int splitFloat(float val, epicsUInt64 *pf, int *pe)
+{
+    epicsUInt32 bits;
+    int be;
+
+    memcpy(&bits, &val, sizeof(bits));
+    be = (int) (bits >> 23) & 0xff;
+    *pf = bits & 0x7fffff;
+    if (be) {
+        *pf |= 0x800000;
+        *pe = be - 150;
+    }
+    else
+        *pe = -149;
+    return (int) (bits >> 31);
+}
+
+/* Estimate floor(log10(f * 2^e)), this may be one too small */
+static int log10Estimate(epicsUInt64 f, int e)
+{
+    int p = e - 1;
+
+    while (f >> 8) {
+        f >>= 8;
+        p += 8;
+    }
+    while (f) {
+        f >>= 1;
+        p++;
+    }
+    /* floor(p * log10(2)) */
+    return p >= 0 ? (p * 78913) >> 18 : -((-p * 78913 + 262143) >> 18);
+}
+
+/* Bits pos to pos+31 of the 7-limb number p */
+static epicsUInt32 bitsAt(const epicsUInt32 *p, int pos)
+{
+    int i, shift;
+    epicsUInt32 lo, hi;
+
+    if (pos <= -32 || pos >= 7 * 32)
+        return 0;
+    i = (pos + 32) / 32 - 1;
+    shift = pos - 32 * i;
+    lo = i >= 0 ? p[i] : 0;
+    hi = i + 1 < 7 ? p[i + 1] : 0;
+    return shift ? lo >> shift | hi << (32 - shift) : lo;
+}
+
+/* Compute f * 2^e * 10^s, returns -1 if the whole part overflows */
+static int scaleNum(epicsUInt64 f, int e, int s, scaledNum *pnum)
+{
+    int j = s >= 0 ? s / 8 : -((7 - s) / 8);
+    int r = s - 8 * j;
+    const struct pow10Entry *pp;
+    epicsUInt32 a[3], p[7];
+    epicsUInt64 t;
+    int i, k, sh, sticky = 0;
+
+    if (j < POW10_MIN || j > POW10_MAX)
+        return -1;
+    pp = &pow10Cache[j - POW10_MIN];
+
+    t = (f & 0xffffffff) * pow10Int[r];
+    a[0] = (epicsUInt32) t;
+    t = (t >> 32) + (f >> 32) * pow10Int[r];
+    a[1] = (epicsUInt32) t;
+    a[2] = (epicsUInt32) (t >> 32);
+
+    memset(p, 0, sizeof(p));
+    for (i = 0; i < 3; i++) {
+        if (!a[i])
+            continue;
+        t = 0;
+        for (k = 0; k < 4; k++) {
+            t += (epicsUInt64) a[i] * pp->m[3 - k] + p[i + k];
+            p[i + k] = (epicsUInt32) t;
+            t >>= 32;
+        }
+        p[i + 4] = (epicsUInt32) t;
+    }
+
+    sh = -(e + pp->e);
+    for (i = sh + 64; i < 7 * 32; i += 32)
+        if (bitsAt(p, i))
+            return -1;
+    pnum->whole = (epicsUInt64) bitsAt(p, sh + 32) << 32 | bitsAt(p, sh);
+    pnum->frac = (epicsUInt64) bitsAt(p, sh - 32) << 32 | bitsAt(p, sh - 64);
+    for (i = sh - 96; i > -32; i -= 32)
+        sticky |= bitsAt(p, i) != 0;
+    pnum->slop = j >= 0 && j <= POW10_EXACT_MAX ? sticky : 2;
+    return 0;
+}
+
+/* Round to the nearest integer, returns -1 if too close to call */
+static int roundNum(const scaledNum *pnum, epicsUInt64 *pd)
+{
+    if (pnum->frac < HALF - pnum->slop)
+        *pd = pnum->whole;
+    else if (pnum->frac > HALF + pnum->slop)
+        *pd = pnum->whole + 1;
+    else
+        return -1;
+    return 0;
+}
+
+/* Returns the sign of a - b, or 0 if they are within slop */
+static int compareNum(const scaledNum *pa, const scaledNum *pb,
+    epicsUInt64 slop)
+{
+    epicsUInt64 diff;
+    int sign;
+
+    if (pa->whole == pb->whole) {
+        sign = pa->frac >= pb->frac ? 1 : -1;
+        diff = sign > 0 ? pa->frac - pb->frac : pb->frac - pa->frac;
+    }
+    else if (pa->whole == pb->whole + 1 && pa->frac < pb->frac) {
+        sign = 1;
+        diff = pa->frac - pb->frac;
+    }
+    else if (pb->whole == pa->whole + 1 && pb->frac < pa->frac) {
+        sign = -1;
+        diff = pb->frac - pa->frac;
+    }
+    else
+        return pa->whole > pb->whole ? 1 : -1;
+    return diff <= slop ? 0 : sign;
+}
+
+/* Write the n digits of d, returns the end */
+static char * putDigits(epicsUInt64 d, int n, char *pdest)
+{
+    int i;
+
+    for (i = n; i > 0; i--) {
+        pdest[i - 1] = (char) ('0' + d % 10);
+        d /= 10;
+    }
+    return pdest + n;
+}
+
+static char * putExponent(int k, char *pdest)
+{
+    *pdest++ = 'e';
+    *pdest++ = k < 0 ? '-' : '+';
+    if (k < 0)
+        k = -k;
+    return putDigits(k, k >= 100 ? 3 : 2, pdest);
+}
+
+/* The same as sprintf(pdest, "%*.*e", width, prec, val) */
+static int expString(double val, char *pdest, int prec, int width)
+{
+    epicsUInt64 f, d = 0;
+    int e, k = 0, n = prec + 1, len, tries;
+    int neg = splitDouble(val, &f, &e);
+    scaledNum num;
+    char *pnext;
+
+    if (isnan(val) || isinf(val) || n > 18)
+        return -1;
+    if (f) {
+        k = log10Estimate(f, e);
+        for (tries = 0; ; tries++) {
+            if (tries == 3 || scaleNum(f, e, n - 1 - k, &num) ||
+                roundNum(&num, &d))
+                return -1;
+            if (d >= pow10Int[n])
+                k++;
+            else if (d < pow10Int[n - 1])
+                k--;
+            else
+                break;
+        }
+    }
+
+    len = neg + n + (prec > 0) + ((k >= 100 || k <= -100) ? 5 : 4);
+    pnext = pdest;
+    while (len < width) {
+        *pnext++ = ' ';
+        width--;
+    }
+    if (neg)
+        *pnext++ = '-';
+    putDigits(d, n, pnext + 1);
+    pnext[0] = pnext[1];
+    pnext++;
+    if (prec > 0)
+        *pnext = '.';
+    pnext = putExponent(k, pnext + prec + (prec > 0));
+    *pnext = 0;
+    return (int) (pnext - pdest);
+}
+
+/* The same as sprintf(pdest, "%.*f", prec, val) */
+static int fixedString(double val, char *pdest, int prec)
+{
+    epicsUInt64 f, d = 0, whole;
+    int e, n;
+    int neg = splitDouble(val, &f, &e);
+    scaledNum num;
+    char *pnext = pdest;
+
+    if (isnan(val) || isinf(val))
+        return -1;
+    if (f && (scaleNum(f, e, prec, &num) || roundNum(&num, &d)))
+        return -1;
+
+    if (neg)
+        *pnext++ = '-';
+    whole = d / pow10Int[prec];
+    for (n = 1; n < 20 && whole >= pow10Int[n]; n++);
+    pnext = putDigits(whole, n, pnext);
+    if (prec > 0) {
+        *pnext++ = '.';
+        pnext = putDigits(d % pow10Int[prec], prec, pnext);
+    }
+    *pnext = 0;
+    return (int) (pnext - pdest);
+}
+
+/* Whether the nearest n of the maxDigits digits in num read back as
+ * the same value, given half the gaps to the next higher and lower
+ * values.  Returns 1 and sets *pd if they do, 0 if not, or -1 if that
+ * can't be decided.
+ */
+static int tryDigits(const scaledNum *pnum, const scaledNum *phigh,
+    const scaledNum *plow, int n, int maxDigits, epicsUInt64 *pd)
+{
+    epicsUInt64 m = pow10Int[maxDigits - n];
+    epicsUInt64 slop = pnum->slop + phigh->slop;
+    scaledNum dist, half;
+    int cmp;
+
+    *pd = pnum->whole / m;
+    dist.whole = pnum->whole % m;
+    dist.frac = pnum->frac;
+    half.whole = m / 2;
+    half.frac = m > 1 ? 0 : HALF;
+
+    cmp = compareNum(&dist, &half, pnum->slop);
+    if (cmp > 0) {
+        ++*pd;
+        dist.whole = m - dist.whole - (dist.frac != 0);
+        dist.frac = ~dist.frac + 1;
+        cmp = compareNum(&dist, phigh, slop);
+    }
+    else if (cmp < 0)
+        cmp = compareNum(&dist, plow, slop);
+    else if (compareNum(&half, phigh, slop) > 0 &&
+        compareNum(&half, plow, slop) > 0)
+        return 0;
+    else
+        return -1;
+    return cmp < 0 ? 1 : cmp > 0 ? 0 : -1;
+}
+
+/* The shortest n digits d with exponent k which read back as f * 2^e,
+ * for a type with at most maxDigits significant digits.  narrow is
+ * set when the gap to the next smaller value is half the usual, at
+ * powers of two.  Returns -1 if undecided.
+ */
+static int shortestDigits(epicsUInt64 f, int e, int narrow,
+    int maxDigits, epicsUInt64 *pd, int *pn, int *pk)
+{
+    scaledNum num, high, low;
+    epicsUInt64 d;
+    int k = log10Estimate(f, e), s = 0, lo = 1, hi = maxDigits, n, tries;
+
+    for (tries = 0; ; tries++) {
+        s = maxDigits - 1 - k;
+        if (tries == 3 || scaleNum(f, e, s, &num))
+            return -1;
+        if (num.whole >= pow10Int[maxDigits])
+            k++;
+        else if (num.whole < pow10Int[maxDigits - 1])
+            k--;
+        else
+            break;
+    }
+    /* Half the gap to the neighbouring values, at the same scale */
+    if (scaleNum(1, e - 1, s, &high) ||
+        scaleNum(1, e - 1 - narrow, s, &low))
+        return -1;
+
+    /* More digits are never further away, so search for the fewest.
+     * With unequal gaps that's only true for nearer digits, so then
+     * count up instead.
+     */
+    while (lo < hi) {
+        int ok;
+
+        n = narrow ? lo : (lo + hi) / 2;
+        ok = tryDigits(&num, &high, &low, n, maxDigits, &d);
+        if (ok < 0)
+            return -1;
+        if (ok)
+            hi = n;
+        else
+            lo = n + 1;
+    }
+    if (tryDigits(&num, &high, &low, lo, maxDigits, &d) != 1)
+        return -1;
+
+    if (d == pow10Int[lo]) {
+        d = pow10Int[lo - 1];
+        k++;
+    }
+    *pd = d;
+    *pn = lo;
+    *pk = k;
+    return 0;
+}
+
+/* Find the shortest digits using sprintf() and epicsStrtod() */
+static void shortestSlowly(double val, int isFloat, int maxDigits,
+    epicsUInt64 *pd, int *pn, int *pk)
+{
+    char buf[32], *pnext;
+    int n;
+
+    for (n = 1; n < maxDigits; n++) {
+        double back;
+
+        sprintf(buf, "%.*e", n - 1, val);
+        back = epicsStrtod(buf, NULL);
+        if (isFloat ? (float) back == (float) val : back == val)
+            break;
+    }
+    sprintf(buf, "%.*e", n - 1, val);
+    *pd = 0;
+    for (pnext = buf; *pnext != 'e'; pnext++)
+        if (*pnext >= '0' && *pnext <= '9')
+            *pd = *pd * 10 + (*pnext - '0');
+    *pn = n;
+    *pk = atoi(pnext + 1);
+}
+
+/* Layout as %.*g with precision maxDigits, but only the digits needed */
+static int shortestString(double val, int isFloat, char *pdest)
+{
+    epicsUInt64 f, d;
+    int e, n, k, i, narrow;
+    int maxDigits = isFloat ? 9 : 17;
+    int neg = isFloat ? splitFloat((float) val, &f, &e) :
+        splitDouble(val, &f, &e);
+    char digits[20], *pnext = pdest;
+
+    if (isnan(val) || isinf(val)) {
+        sprintf(pdest, "%.*g", maxDigits, val);
+        return (int) strlen(pdest);
+    }
+    if (neg)
+        *pnext++ = '-';
+    if (!f) {
+        strcpy(pnext, "0");
+        return neg + 1;
+    }
+
+    narrow = f == (isFloat ? 0x800000 : (epicsUInt64) 1 << 52) &&
+        e > (isFloat ? -149 : -1074);
+    if (shortestDigits(f, e, narrow, maxDigits, &d, &n, &k))
+        shortestSlowly(val, isFloat, maxDigits, &d, &n, &k);
+    while (n > 1 && d % 10 == 0) {
+        d /= 10;
+        n--;
+    }
+    putDigits(d, n, digits);
+
+    if (k < -4 || k >= maxDigits) {
+        *pnext++ = digits[0];
+        if (n > 1) {
+            *pnext++ = '.';
+            memcpy(pnext, digits + 1, n - 1);
+            pnext += n - 1;
+        }
+        pnext = putExponent(k, pnext);
+    }
+    else if (k < 0) {
+        *pnext++ = '0';
+        *pnext++ = '.';
+        for (i = -1; i > k; i--)
+            *pnext++ = '0';
+        memcpy(pnext, digits, n);
+        pnext += n;
+    }
+    else {
+        for (i = 0; i < n || i <= k; i++) {
+            if (i == k + 1)
+                *pnext++ = '.';
+            *pnext++ = i < n ? digits[i] : '0';
+        }
+    }
+    *pnext = 0;
+    return (int) (pnext - pdest);
+}
+
 int cvtFloatToString(float flt_value, char *pdest,
     epicsUInt16 precision)
 {
@@ -40,14 +583,20 @@ int cvtFloatToString(float flt_value, char *pdest,
     /* can this routine handle this conversion */
     if (isnan(flt_value) || precision > 8 ||
         flt_value > 10000000.0 || flt_value < -10000000.0) {
+        int len;
+
         if (precision > 8 || flt_value >= 1e8 || flt_value <= -1e8) {
             if (precision > 12) precision = 12; /* FIXME */
-            sprintf(pdest, "%*.*e", precision+6, precision, (double) flt_value);
+            len = expString(flt_value, pdest, precision, precision+6);
+            if (len < 0)
+                sprintf(pdest, "%*.*e", precision+6, precision, (double) flt_value);
         } else {
             if (precision > 3) precision = 3; /* FIXME */
-            sprintf(pdest, "%.*f", precision, (double) flt_value);
+            len = fixedString(flt_value, pdest, precision);
+            if (len < 0)
+                sprintf(pdest, "%.*f", precision, (double) flt_value);
         }
-        return((int)strlen(pdest));
+        return len < 0 ? (int)strlen(pdest) : len;
     }
     startAddr = pdest;
 
@@ -120,15 +669,21 @@ int cvtDoubleToString(
 
     /* can this routine handle this conversion */
     if (isnan(flt_value) || precision > 8 || flt_value > 10000000.0 || flt_value < -10000000.0) {
+        int len;
+
         if (precision > 8 || flt_value > 1e16 || flt_value < -1e16) {
             if(precision>17) precision=17;
-            sprintf(pdest,"%*.*e",precision+7,precision,
-            flt_value);
+            len = expString(flt_value, pdest, precision, precision+7);
+            if (len < 0)
+                sprintf(pdest,"%*.*e",precision+7,precision,
+                flt_value);
         } else {
             if(precision>3) precision=3;
-            sprintf(pdest,"%.*f",precision,flt_value);
+            len = fixedString(flt_value, pdest, precision);
+            if (len < 0)
+                sprintf(pdest,"%.*f",precision,flt_value);
         }
-        return((int)strlen(pdest));
+        return len < 0 ? (int)strlen(pdest) : len;
     }
     startAddr = pdest;
 
@@ -189,6 +744,20 @@ int cvtDoubleToString(
     return((int)(pdest - startAddr));
 }
 
+/*
+ * The shortest strings which read back as the same value, laid out
+ * like %.9g or %.17g but without any unnecessary digits.
+ */
+int cvtFloatToShortestString(float val, char *pdest)
+{
+    return shortestString(val, 1, pdest);
+}
+
+int cvtDoubleToShortestString(double val, char *pdest)
+{
+    return shortestString(val, 0, pdest);
+}
+
 /*
  * These routines are provided for backwards compatibility,
  * extensions such as MEDM, edm and histtool use them.
@@ -35,6 +35,15 @@ LIBCOM_API int
 LIBCOM_API int
     cvtDoubleToString(double val, char *pdest, epicsUInt16 prec);
 
+/*
+ * The shortest strings which convert back to the same value,
+ * 0.1 gives "0.1" not "0.10000000000000001"
+ */
+LIBCOM_API int
+    cvtFloatToShortestString(float val, char *pdest);
+LIBCOM_API int
+    cvtDoubleToShortestString(double val, char *pdest);
+
 LIBCOM_API int
     cvtFloatToExpString(float val, char *pdest, epicsUInt16 prec);
 LIBCOM_API int
@@ -33,15 +33,20 @@
 #include "errlog.h"
 #include "epicsStdio.h"
 #include "epicsExit.h"
+#include "epicsAtomic.h"
+#include "epicsTime.h"
 
 
 #define BUFFER_SIZE 1280
 #define MAX_MESSAGE_SIZE 256
+#define REPEAT_SITES 4
+#define REPEAT_TEXT 60
 
 /*Declare storage for errVerbose */
 int errVerbose = 0;
 
 static void errlogExitHandler(void *);
+static void flushThreadRepeats(int all);
 static void errlogThread(void);
 
 static char *msgbufGetFree(int noConsoleMessage);
@@ -63,6 +68,25 @@ typedef struct msgNode {
     int noConsoleMessage;
 } msgNode;
 
+/* The last message from one call site, for rate limiting */
+typedef struct repeatSite {
+    const char *format;     /* identifies the call site */
+    unsigned int hash;
+    epicsTimeStamp first;
+    unsigned int repeats;
+    int noConsoleMessage;
+    char text[REPEAT_TEXT];
+} repeatSite;
+
+/* Per-thread formatting buffer, followed by maxMsgSize chars */
+typedef struct threadPvt {
+    ELLNODE node;
+    epicsMutexId lock;      /* guards sites */
+    unsigned int nextSite;
+    repeatSite sites[REPEAT_SITES];
+    char buffer[1];
+} threadPvt;
+
 static struct {
     epicsEventId waitForWork; /*errlogThread waits for this*/
     epicsMutexId msgQueueLock;
@@ -84,8 +108,19 @@ static struct {
     FILE         *console;
     int          missedMessages;
     char         *pbuffer;
+    epicsThreadPrivateId threadPvtId;
+    epicsMutexId threadListLock;
+    ELLLIST      threadList;
+    double       rateLimit;   /*seconds, 0 for no rate limiting*/
+    size_t       nLogged;
+    size_t       nDiscarded;
+    size_t       nSuppressed;
+    int          maxQueued;
 } pvtData;
 
+/* Marks a thread whose threadPvt has been freed */
+static char threadExiting;
+
 
 /*
  * vsnprintf with truncation message
@@ -103,79 +138,260 @@ static int tvsnPrint(char *str, size_t size, const char *format, va_list ap)
     return nchar;
 }
 
-int errlogPrintf(const char *pFormat, ...)
+static unsigned int msgHash(const char *message)
 {
-    va_list pvar;
-    char *pbuffer;
+    unsigned int hash = 2166136261u;
+
+    while (*message)
+        hash = (hash ^ (unsigned char) *message++) * 16777619u;
+    return hash;
+}
+
+/* Queue a copy of a message, returns 0 if there was no room */
+static int msgbufSend(const char *message, int length, int noConsoleMessage)
+{
+    char *pbuffer = msgbufGetFree(noConsoleMessage);
+
+    if (!pbuffer)
+        return 0;
+    memcpy(pbuffer, message, length + 1);
+    msgbufSetSize(length);
+    return 1;
+}
+
+/* Caller holds ptp->lock */
+static void sendRepeats(repeatSite *psite)
+{
+    char message[REPEAT_TEXT + 64];
     int nchar;
-    int isOkToBlock;
 
-    if (epicsInterruptIsInterruptContext()) {
-        epicsInterruptContextMessage
-            ("errlogPrintf called from interrupt level\n");
+    nchar = sprintf(message, "errlog: \"%s\" repeated %u more times\n",
+        psite->text, psite->repeats);
+    msgbufSend(message, nchar, psite->noConsoleMessage);
+    psite->repeats = 0;
+}
+
+/*
+ * Returns non-zero if the message is a repeat from the same call site
+ * in this thread within the rate limit interval, so should not be sent.
+ */
+static int msgRepeated(threadPvt *ptp, const char *format,
+    const char *message, int noConsoleMessage)
+{
+    double interval = pvtData.rateLimit;
+    repeatSite *psite = NULL;
+    unsigned int hash;
+    epicsTimeStamp now;
+    size_t len;
+    int i;
+
+    if (interval <= 0.0)
         return 0;
+
+    hash = msgHash(message);
+    epicsTimeGetMonotonic(&now);
+
+    epicsMutexMustLock(ptp->lock);
+    for (i = 0; i < REPEAT_SITES; i++) {
+        if (ptp->sites[i].format == format) {
+            psite = &ptp->sites[i];
+            break;
+        }
+    }
+    if (psite && psite->hash == hash &&
+        epicsTimeDiffInSeconds(&now, &psite->first) < interval) {
+        psite->repeats++;
+        epicsMutexUnlock(ptp->lock);
+        epicsAtomicIncrSizeT(&pvtData.nSuppressed);
+        return 1;
     }
 
-    errlogInit(0);
-    isOkToBlock = epicsThreadIsOkToBlock();
+    if (!psite) {
+        psite = &ptp->sites[ptp->nextSite++ % REPEAT_SITES];
+    }
+    if (psite->repeats)
+        sendRepeats(psite);
+
+    psite->format = format;
+    psite->hash = hash;
+    psite->first = now;
+    psite->noConsoleMessage = noConsoleMessage;
+    len = strcspn(message, "\n");
+    if (len >= REPEAT_TEXT)
+        len = REPEAT_TEXT - 1;
+    memcpy(psite->text, message, len);
+    psite->text[len] = '\0';
+    epicsMutexUnlock(ptp->lock);
+    return 0;
+}
+
+/* Send summaries of repeats whose interval has passed, or all of them */
+static void flushRepeats(threadPvt *ptp, int all)
+{
+    epicsTimeStamp now;
+    int i;
+
+    epicsTimeGetMonotonic(&now);
+    epicsMutexMustLock(ptp->lock);
+    for (i = 0; i < REPEAT_SITES; i++) {
+        repeatSite *psite = &ptp->sites[i];
+
+        if (psite->format && (all ||
+            epicsTimeDiffInSeconds(&now, &psite->first) >= pvtData.rateLimit)) {
+            if (psite->repeats)
+                sendRepeats(psite);
+            psite->format = NULL;
+        }
+    }
+    epicsMutexUnlock(ptp->lock);
+}
 
-    if (pvtData.atExit || (isOkToBlock && pvtData.toConsole)) {
+static void threadPvtFree(void *arg)
+{
+    threadPvt *ptp = (threadPvt *) arg;
+
+    epicsMutexMustLock(pvtData.threadListLock);
+    ellDelete(&pvtData.threadList, &ptp->node);
+    epicsMutexUnlock(pvtData.threadListLock);
+
+    epicsThreadPrivateSet(pvtData.threadPvtId, &threadExiting);
+    flushRepeats(ptp, 1);
+    epicsMutexDestroy(ptp->lock);
+    free(ptp);
+}
+
+/* The calling thread's formatting buffer and repeat state */
+static threadPvt * getThreadPvt(void)
+{
+    threadPvt *ptp = epicsThreadPrivateGet(pvtData.threadPvtId);
+
+    if (ptp)
+        return ptp == (void *) &threadExiting ? NULL : ptp;
+
+    ptp = calloc(1, sizeof(threadPvt) + pvtData.maxMsgSize);
+    if (!ptp)
+        return NULL;
+    ptp->lock = epicsMutexCreate();
+    if (!ptp->lock) {
+        free(ptp);
+        return NULL;
+    }
+    epicsThreadPrivateSet(pvtData.threadPvtId, ptp);
+    epicsAtThreadExit(threadPvtFree, ptp);
+
+    epicsMutexMustLock(pvtData.threadListLock);
+    ellAdd(&pvtData.threadList, &ptp->node);
+    epicsMutexUnlock(pvtData.threadListLock);
+    return ptp;
+}
+
+/*
+ * Format a message and queue it for the errlog thread.
+ * The message is formatted into a buffer belonging to the calling thread,
+ * so the queue is only locked while the result is copied into it.
+ * Threads that may block (e.g. iocsh) also write it to the console
+ * themselves, so their output stays in order and is never discarded.
+ * A prefix is put in front of the message, and the newline argument
+ * adds a newline at the end if missing (1) or always (2).
+ */
+static int msgSend(int noConsoleMessage, const char *prefix,
+    const char *pFormat, va_list pvar, int newline)
+{
+    threadPvt *ptp;
+    char *pbuffer;
+    int size = pvtData.maxMsgSize;
+    int nchar, totalChar = 0;
+    int toConsole;
+
+    if (pvtData.atExit) {
         FILE *console = pvtData.console ? pvtData.console : stderr;
 
-        va_start(pvar, pFormat);
-        nchar = vfprintf(console, pFormat, pvar);
-        va_end (pvar);
+        if (noConsoleMessage)
+            return 0;
+        if (prefix)
+            fputs(prefix, console);
+        nchar = vfprintf(console, pFormat ? pFormat : "", pvar);
+        if (newline)
+            fputc('\n', console);
         fflush(console);
+        return nchar;
     }
 
-    if (pvtData.atExit)
+    toConsole = !noConsoleMessage && pvtData.toConsole &&
+        epicsThreadIsOkToBlock();
+
+    ptp = getThreadPvt();
+    if (ptp) {
+        pbuffer = ptp->buffer;
+    }
+    else {
+        /* Format straight into the queue */
+        pbuffer = msgbufGetFree(noConsoleMessage || toConsole);
+        if (!pbuffer)
+            return 0;
+    }
+
+    if (prefix) {
+        totalChar = strlen(prefix);
+        if (totalChar > size / 2)
+            totalChar = size / 2;
+        memcpy(pbuffer, prefix, totalChar);
+    }
+    if (newline)
+        size--;
+    nchar = tvsnPrint(pbuffer + totalChar, size - totalChar, pFormat, pvar);
+    totalChar += nchar;
+    if (newline == 2 || (newline && (totalChar == 0 ||
+            pbuffer[totalChar - 1] != '\n'))) {
+        pbuffer[totalChar++] = '\n';
+        pbuffer[totalChar] = '\0';
+    }
+
+    if (ptp && msgRepeated(ptp, pFormat, pbuffer, noConsoleMessage))
         return nchar;
 
-    pbuffer = msgbufGetFree(isOkToBlock);
-    if (!pbuffer)
-        return 0;
+    if (toConsole) {
+        FILE *console = pvtData.console ? pvtData.console : stderr;
 
-    va_start(pvar, pFormat);
-    nchar = tvsnPrint(pbuffer, pvtData.maxMsgSize, pFormat?pFormat:"", pvar);
-    va_end(pvar);
-    msgbufSetSize(nchar);
+        fputs(pbuffer, console);
+        fflush(console);
+    }
+
+    if (!ptp)
+        msgbufSetSize(totalChar);
+    else
+        msgbufSend(pbuffer, totalChar, noConsoleMessage || toConsole);
     return nchar;
 }
 
-int errlogVprintf(const char *pFormat,va_list pvar)
+int errlogPrintf(const char *pFormat, ...)
 {
+    va_list pvar;
     int nchar;
-    char *pbuffer;
-    int isOkToBlock;
-    FILE *console;
 
     if (epicsInterruptIsInterruptContext()) {
         epicsInterruptContextMessage
-            ("errlogVprintf called from interrupt level\n");
+            ("errlogPrintf called from interrupt level\n");
         return 0;
     }
 
     errlogInit(0);
-    if (pvtData.atExit)
-        return 0;
-    isOkToBlock = epicsThreadIsOkToBlock();
+    va_start(pvar, pFormat);
+    nchar = msgSend(0, NULL, pFormat, pvar, 0);
+    va_end(pvar);
+    return nchar;
+}
 
-    pbuffer = msgbufGetFree(isOkToBlock);
-    if (!pbuffer) {
-        console = pvtData.console ? pvtData.console : stderr;
-        vfprintf(console, pFormat, pvar);
-        fflush(console);
+int errlogVprintf(const char *pFormat,va_list pvar)
+{
+    if (epicsInterruptIsInterruptContext()) {
+        epicsInterruptContextMessage
+            ("errlogVprintf called from interrupt level\n");
         return 0;
     }
 
-    nchar = tvsnPrint(pbuffer, pvtData.maxMsgSize, pFormat?pFormat:"", pvar);
-    if (pvtData.atExit || (isOkToBlock && pvtData.toConsole)) {
-        console = pvtData.console ? pvtData.console : stderr;
-        fprintf(console, "%s", pbuffer);
-        fflush(console);
-    }
-    msgbufSetSize(nchar);
-    return nchar;
+    errlogInit(0);
+    return msgSend(0, NULL, pFormat, pvar, 0);
 }
 
 int errlogMessage(const char *message)
@@ -204,9 +420,6 @@ int errlogPrintfNoConsole(const char *pFormat, ...)
 
 int errlogVprintfNoConsole(const char *pFormat, va_list pvar)
 {
-    int nchar;
-    char *pbuffer;
-
     if (epicsInterruptIsInterruptContext()) {
         epicsInterruptContextMessage
             ("errlogVprintfNoConsole called from interrupt level\n");
@@ -214,16 +427,7 @@ int errlogVprintfNoConsole(const char *pFormat, va_list pvar)
     }
 
     errlogInit(0);
-    if (pvtData.atExit)
-        return 0;
-
-    pbuffer = msgbufGetFree(1);
-    if (!pbuffer)
-        return 0;
-
-    nchar = tvsnPrint(pbuffer, pvtData.maxMsgSize, pFormat?pFormat:"", pvar);
-    msgbufSetSize(nchar);
-    return nchar;
+    return msgSend(1, NULL, pFormat, pvar, 0);
 }
 
 
@@ -231,7 +435,6 @@ int errlogSevPrintf(errlogSevEnum severity, const char *pFormat, ...)
 {
     va_list pvar;
     int nchar;
-    int isOkToBlock;
 
     if (epicsInterruptIsInterruptContext()) {
         epicsInterruptContextMessage
@@ -243,17 +446,6 @@ int errlogSevPrintf(errlogSevEnum severity, const char *pFormat, ...)
     if (pvtData.sevToLog > severity)
         return 0;
 
-    isOkToBlock = epicsThreadIsOkToBlock();
-    if (pvtData.atExit || (isOkToBlock && pvtData.toConsole)) {
-        FILE *console = pvtData.console ? pvtData.console : stderr;
-
-        fprintf(console, "sevr=%s ", errlogGetSevEnumString(severity));
-        va_start(pvar, pFormat);
-        vfprintf(console, pFormat, pvar);
-        va_end(pvar);
-        fflush(console);
-    }
-
     va_start(pvar, pFormat);
     nchar = errlogSevVprintf(severity, pFormat, pvar);
     va_end(pvar);
@@ -262,10 +454,7 @@ int errlogSevPrintf(errlogSevEnum severity, const char *pFormat, ...)
 
 int errlogSevVprintf(errlogSevEnum severity, const char *pFormat, va_list pvar)
 {
-    char *pnext;
-    int nchar;
-    int totalChar = 0;
-    int isOkToBlock;
+    char prefix[32];
 
     if (epicsInterruptIsInterruptContext()) {
         epicsInterruptContextMessage
@@ -274,24 +463,8 @@ int errlogSevVprintf(errlogSevEnum severity, const char *pFormat, va_list pvar)
     }
 
     errlogInit(0);
-    if (pvtData.atExit)
-        return 0;
-
-    isOkToBlock = epicsThreadIsOkToBlock();
-    pnext = msgbufGetFree(isOkToBlock);
-    if (!pnext)
-        return 0;
-
-    nchar = sprintf(pnext, "sevr=%s ", errlogGetSevEnumString(severity));
-    pnext += nchar; totalChar += nchar;
-    nchar = tvsnPrint(pnext, pvtData.maxMsgSize - totalChar - 1, pFormat, pvar);
-    pnext += nchar; totalChar += nchar;
-    if (pnext[-1] != '\n') {
-        strcpy(pnext,"\n");
-        totalChar++;
-    }
-    msgbufSetSize(totalChar);
-    return nchar;
+    sprintf(prefix, "sevr=%s ", errlogGetSevEnumString(severity));
+    return msgSend(0, prefix, pFormat, pvar, 1);
 }
 
 
@@ -381,14 +554,70 @@ int errlogSetConsole(FILE *stream)
     return 0;
 }
 
+void errlogSetRateLimit(double seconds)
+{
+    errlogInit(0);
+    if (seconds > 0.0) {
+        pvtData.rateLimit = seconds;
+        epicsEventSignal(pvtData.waitForWork);
+    }
+    else {
+        pvtData.rateLimit = 0.0;
+        flushThreadRepeats(1);
+    }
+}
+
+void errlogShow(int level)
+{
+    int queued, maxQueued, missed;
+    size_t nLogged, nDiscarded;
+
+    errlogInit(0);
+    epicsMutexMustLock(pvtData.msgQueueLock);
+    queued = ellCount(&pvtData.msgQueue);
+    maxQueued = pvtData.maxQueued;
+    missed = pvtData.missedMessages;
+    nLogged = pvtData.nLogged;
+    nDiscarded = pvtData.nDiscarded;
+    epicsMutexUnlock(pvtData.msgQueueLock);
+
+    printf("errlog: %d messages queued, %d at most, buffer %d bytes\n",
+        queued, maxQueued, pvtData.buffersize);
+    printf("  %lu logged, %lu discarded, %lu suppressed as repeats\n",
+        (unsigned long) nLogged, (unsigned long) (nDiscarded + missed),
+        (unsigned long) epicsAtomicGetSizeT(&pvtData.nSuppressed));
+    if (pvtData.rateLimit > 0.0)
+        printf("  Repeats limited to one per %g seconds\n", pvtData.rateLimit);
+    else
+        printf("  Repeats not limited\n");
+
+    if (level >= 1) {
+        threadPvt *ptp;
+
+        epicsMutexMustLock(pvtData.threadListLock);
+        printf("  %d threads have logged\n", ellCount(&pvtData.threadList));
+        for (ptp = (threadPvt *) ellFirst(&pvtData.threadList); ptp;
+             ptp = (threadPvt *) ellNext(&ptp->node)) {
+            int i;
+
+            epicsMutexMustLock(ptp->lock);
+            for (i = 0; i < REPEAT_SITES; i++) {
+                if (ptp->sites[i].format && ptp->sites[i].repeats)
+                    printf("    %u repeats pending of \"%s\"\n",
+                        ptp->sites[i].repeats, ptp->sites[i].text);
+            }
+            epicsMutexUnlock(ptp->lock);
+        }
+        epicsMutexUnlock(pvtData.threadListLock);
+    }
+}
+
 void errPrintf(long status, const char *pFileName, int lineno,
     const char *pformat, ...)
 {
     va_list pvar;
-    char    *pnext;
-    int     nchar;
-    int     totalChar=0;
-    int     isOkToBlock;
+    char    prefix[512];
+    int     nchar = 0;
     char    name[256];
 
     if (epicsInterruptIsInterruptContext()) {
@@ -397,57 +626,25 @@ void errPrintf(long status, const char *pFileName, int lineno,
     }
 
     errlogInit(0);
-    isOkToBlock = epicsThreadIsOkToBlock();
     if (status == 0)
         status = errno;
 
-    if (status > 0) {
-        errSymLookup(status, name, sizeof(name));
-    }
-
-    if (pvtData.atExit || (isOkToBlock && pvtData.toConsole)) {
-        FILE *console = pvtData.console ? pvtData.console : stderr;
-
-        if (pFileName)
-            fprintf(console, "filename=\"%s\" line number=%d\n",
-                pFileName, lineno);
-        if (status > 0)
-            fprintf(console, "%s ", name);
-
-        va_start(pvar, pformat);
-        vfprintf(console, pformat, pvar);
-        va_end(pvar);
-        fputc('\n', console);
-        fflush(console);
-    }
-
-    if (pvtData.atExit)
-        return;
-
-    pnext = msgbufGetFree(isOkToBlock);
-    if (!pnext)
-        return;
-
+    prefix[0] = '\0';
     if (pFileName) {
-        nchar = sprintf(pnext,"filename=\"%s\" line number=%d\n",
-            pFileName, lineno);
-        pnext += nchar; totalChar += nchar;
+        nchar = epicsSnprintf(prefix, sizeof(prefix),
+            "filename=\"%s\" line number=%d\n", pFileName, lineno);
+        if (nchar >= sizeof(prefix))
+            nchar = sizeof(prefix) - 1;
     }
 
     if (status > 0) {
-        nchar = sprintf(pnext,"%s ",name);
-        pnext += nchar; totalChar += nchar;
+        errSymLookup(status, name, sizeof(name));
+        epicsSnprintf(prefix + nchar, sizeof(prefix) - nchar, "%s ", name);
     }
+
     va_start(pvar, pformat);
-    nchar = tvsnPrint(pnext, pvtData.maxMsgSize - totalChar - 1, pformat, pvar);
+    msgSend(0, prefix, pformat, pvar, 2);
     va_end(pvar);
-    if (nchar>0) {
-        pnext += nchar;
-        totalChar += nchar;
-    }
-    strcpy(pnext, "\n");
-    totalChar++ ; /*include the \n */
-    msgbufSetSize(totalChar);
 }
 
 
@@ -486,6 +683,9 @@ static void errlogInitPvt(void *arg)
     pvtData.waitForExit = epicsEventMustCreate(epicsEventEmpty);
     pvtData.pbuffer = callocMustSucceed(1, pvtData.buffersize,
         "errlogInitPvt");
+    pvtData.threadPvtId = epicsThreadPrivateCreate();
+    pvtData.threadListLock = epicsMutexMustCreate();
+    ellInit(&pvtData.threadList);
 
     errSymBld();    /* Better not to do this lazily... */
 
@@ -550,6 +750,18 @@ void errlogFlush(void)
     epicsMutexUnlock(pvtData.flushLock);
 }
 
+/* Send the repeat summaries of all threads */
+static void flushThreadRepeats(int all)
+{
+    threadPvt *ptp;
+
+    epicsMutexMustLock(pvtData.threadListLock);
+    for (ptp = (threadPvt *) ellFirst(&pvtData.threadList); ptp;
+         ptp = (threadPvt *) ellNext(&ptp->node))
+        flushRepeats(ptp, all);
+    epicsMutexUnlock(pvtData.threadListLock);
+}
+
 static void errlogThread(void)
 {
     listenerNode *plistenerNode;
@@ -558,7 +770,16 @@ static void errlogThread(void)
 
     epicsAtExit(errlogExitHandler,0);
     while (TRUE) {
-        epicsEventMustWait(pvtData.waitForWork);
+        double rateLimit = pvtData.rateLimit;
+
+        if (rateLimit > 0.0)
+            epicsEventWaitWithTimeout(pvtData.waitForWork, rateLimit);
+        else
+            epicsEventMustWait(pvtData.waitForWork);
+
+        if (rateLimit > 0.0 || pvtData.atExit)
+            flushThreadRepeats(pvtData.atExit);
+
         while ((pmessage = msgbufGetSend(&noConsoleMessage))) {
             epicsMutexMustLock(pvtData.listenerLock);
             if (pvtData.toConsole && !noConsoleMessage) {
@@ -637,6 +858,7 @@ static char * msgbufGetFree(int noConsoleMessage)
         nchar = sprintf(pnextSend->message,
             "errlog: %d messages were discarded\n", pvtData.missedMessages);
         pnextSend->length = nchar + 1;
+        pvtData.nDiscarded += pvtData.missedMessages;
         pvtData.missedMessages = 0;
         ellAdd(&pvtData.msgQueue, &pnextSend->node);
     }
@@ -659,6 +881,9 @@ static void msgbufSetSize(int size)
 
     pnextSend->length = size+1;
     ellAdd(&pvtData.msgQueue, &pnextSend->node);
+    pvtData.nLogged++;
+    if (ellCount(&pvtData.msgQueue) > pvtData.maxQueued)
+        pvtData.maxQueued = ellCount(&pvtData.msgQueue);
     epicsMutexUnlock(pvtData.msgQueueLock);
     epicsEventSignal(pvtData.waitForWork);
 }
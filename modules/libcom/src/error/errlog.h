@@ -75,6 +75,8 @@ LIBCOM_API int errlogSetConsole(FILE *stream);
 LIBCOM_API int errlogInit(int bufsize);
 LIBCOM_API int errlogInit2(int bufsize, int maxMsgSize);
 LIBCOM_API void errlogFlush(void);
+LIBCOM_API void errlogSetRateLimit(double seconds);
+LIBCOM_API void errlogShow(int level);
 
 LIBCOM_API void errPrintf(long status, const char *pFileName, int lineno,
     const char *pformat, ...) EPICS_PRINTF_STYLE(4,5);
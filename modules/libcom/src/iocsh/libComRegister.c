@@ -225,6 +225,27 @@ static void errlogInit2CallFunc(const iocshArgBuf *args)
     errlogInit2(args[0].ival, args[1].ival);
 }
 
+/* errlogSetRateLimit */
+static const iocshArg errlogSetRateLimitArg0 = { "seconds",iocshArgDouble};
+static const iocshArg * const errlogSetRateLimitArgs[1] =
+    {&errlogSetRateLimitArg0};
+static const iocshFuncDef errlogSetRateLimitFuncDef =
+    {"errlogSetRateLimit",1,errlogSetRateLimitArgs};
+static void errlogSetRateLimitCallFunc(const iocshArgBuf *args)
+{
+    errlogSetRateLimit(args[0].dval);
+}
+
+/* errlogShow */
+static const iocshArg errlogShowArg0 = { "level",iocshArgInt};
+static const iocshArg * const errlogShowArgs[1] = {&errlogShowArg0};
+static const iocshFuncDef errlogShowFuncDef =
+    {"errlogShow",1,errlogShowArgs};
+static void errlogShowCallFunc(const iocshArgBuf *args)
+{
+    errlogShow(args[0].ival);
+}
+
 /* errlog */
 IOCSH_STATIC_FUNC void errlog(const char *message)
 {
@@ -416,6 +437,8 @@ void epicsStdCall libComRegister(void)
     iocshRegister(&eltcFuncDef, eltcCallFunc);
     iocshRegister(&errlogInitFuncDef,errlogInitCallFunc);
     iocshRegister(&errlogInit2FuncDef,errlogInit2CallFunc);
+    iocshRegister(&errlogSetRateLimitFuncDef, errlogSetRateLimitCallFunc);
+    iocshRegister(&errlogShowFuncDef, errlogShowCallFunc);
     iocshRegister(&errlogFuncDef, errlogCallFunc);
     iocshRegister(&iocLogPrefixFuncDef, iocLogPrefixCallFunc);
 
@@ -11,10 +11,9 @@
  * Implementation of core macro substitution library (macLib)
  *
  * The implementation is fairly unsophisticated and linked lists are
- * used to store macro values. Typically there will will be only a
- * small number of macros and performance won't be a problem. Special
- * measures are taken to avoid unnecessary expansion of macros whose
- * definitions reference other macros. Whenever a macro is created,
+ * used to store macro values, with a hash table to find them by name.
+ * Special measures are taken to avoid unnecessary expansion of macros
+ * whose definitions reference other macros. Whenever a macro is created,
  * modified or deleted, a "dirty" flag is set; this causes a full
  * expansion of all macros the next time a macro value is read
  *
@@ -29,6 +28,7 @@
 #include "dbDefs.h"
 #include "errlog.h"
 #include "dbmf.h"
+#include "epicsString.h"
 #include "macLib.h"
 
 
@@ -39,6 +39,7 @@
  */
 typedef struct mac_entry {
     ELLNODE     node;           /* prev and next pointers */
+    struct mac_entry *hashNext; /* next entry in the same hash bucket */
     char        *name;          /* entry name */
     char        *type;          /* entry type */
     char        *rawval;        /* raw (unexpanded) value */
@@ -50,6 +51,26 @@ typedef struct mac_entry {
     int         level;          /* scoping level */
 } MAC_ENTRY;
 
+/*
+ * Part of a compiled template: literal text, or a macro reference which
+ * starts with "$(" or "${" and includes the closing bracket
+ */
+typedef struct mac_segment {
+    const char  *text;          /* points into the template's source */
+    size_t      length;         /* length of the text */
+    int         ref;            /* is this a macro reference? */
+} MAC_SEGMENT;
+
+/*
+ * Compiled template, the segments are followed by a copy of the source
+ */
+struct mac_template {
+    long        magic;          /* magic number */
+    char        *source;        /* copy of the source string */
+    int         nsegs;          /* number of segments */
+    MAC_SEGMENT seg[1];         /* segments in order */
+};
+
 
 /*** Local function prototypes ***/
 
@@ -57,9 +78,7 @@ typedef struct mac_entry {
  * These static functions peform low-level operations on macro entries
  */
 static MAC_ENTRY *first   ( MAC_HANDLE *handle );
-static MAC_ENTRY *last    ( MAC_HANDLE *handle );
 static MAC_ENTRY *next    ( MAC_ENTRY  *entry );
-static MAC_ENTRY *previous( MAC_ENTRY  *entry );
 
 static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special );
 static MAC_ENTRY *lookup( MAC_HANDLE *handle, const char *name, int special );
@@ -82,6 +101,13 @@ static char *Strdup( const char *string );
  * Magic number for validating context.
  */
 #define MAC_MAGIC 0xbadcafe     /* ...sells sub-standard coffee? */
+#define MAC_TEMPLATE_MAGIC 0xcafef00d
+
+/*
+ * Number of hash buckets, must be a power of 2
+ */
+#define MAC_HASH_SIZE 64
+#define HASH( name ) ( epicsStrHash( name, 0 ) & ( MAC_HASH_SIZE - 1 ) )
 
 /*
  * Flag bits
@@ -126,6 +152,12 @@ epicsStdCall macCreateHandle(
     handle->debug = 0;
     handle->flags = 0;
     ellInit( &handle->list );
+    handle->hash = calloc( MAC_HASH_SIZE, sizeof( MAC_ENTRY * ) );
+    if ( handle->hash == NULL ) {
+        errlogPrintf( "macCreateHandle: failed to allocate context\n" );
+        dbmfFree( handle );
+        return -1;
+    }
 
     /* use environment variables if so specified */
     if (pairs && pairs[0] && !strcmp(pairs[0],"") && pairs[1] && !strcmp(pairs[1],"environ") && !pairs[3]) {
@@ -135,6 +167,7 @@ epicsStdCall macCreateHandle(
         /* if supplied, load macro definitions */
         for ( ; pairs && pairs[0]; pairs += 2 ) {
             if ( macPutValue( handle, pairs[0], pairs[1] ) < 0 ) {
+                free( handle->hash );
                 dbmfFree( handle );
                 return -1;
             }
@@ -381,6 +414,7 @@ epicsStdCall macDeleteHandle(
 
     /* clear magic field and free context structure */
     handle->magic = 0;
+    free( handle->hash );
     dbmfFree( handle );
 
     return 0;
@@ -503,38 +537,209 @@ epicsStdCall macReportMacros(
     return 0;
 }
 
-/******************** beginning of static functions ********************/
+/*
+ * Compile a string that may contain macro references into a template
+ * of literal text and macro reference segments, which can be expanded
+ * repeatedly without parsing the string again
+ */
+MAC_TEMPLATE *                  /* NULL = ERROR */
+epicsStdCall macCompileTemplate(
+    const char  *src )          /* source string */
+{
+    MAC_TEMPLATE *tmpl;
+    MAC_HANDLE *scratch;
+    MAC_SEGMENT *seg;
+    const char *r, *lit;
+    char scratchval[MAC_SIZE + 1];
+    size_t length = strlen( src );
+    int nsegs = 1;
+    char quote = 0;
+
+    /* each reference may be preceded by literal text */
+    for ( r = src; ( r = strchr( r, '$' ) ) != NULL; r++ )
+        nsegs += 2;
+
+    tmpl = malloc( sizeof( MAC_TEMPLATE ) +
+                   ( nsegs - 1 ) * sizeof( MAC_SEGMENT ) + length + 1 );
+    if ( tmpl == NULL ) {
+        errlogPrintf( "macCompileTemplate: failed to allocate template\n" );
+        return NULL;
+    }
+    tmpl->magic  = MAC_TEMPLATE_MAGIC;
+    tmpl->source = ( char * ) &tmpl->seg[nsegs];
+    strcpy( tmpl->source, src );
+
+    /* the end of a reference is found by expanding it in an empty context,
+       which only depends on its syntax */
+    if ( macCreateHandle( &scratch, NULL ) < 0 ) {
+        free( tmpl );
+        return NULL;
+    }
+    scratch->flags |= FLAG_SUPPRESS_WARNINGS;
+
+    /* scan characters as trans() does at level 0 */
+    seg = tmpl->seg;
+    for ( r = lit = tmpl->source; *r != '\0'; r++ ) {
+
+        if ( quote ) {
+            if ( *r == quote )
+                quote = 0;
+        }
+        else if ( *r == '"' || *r == '\'' ) {
+            quote = *r;
+        }
+
+        if ( *r == '$' && *( r + 1 ) != '\0' &&
+             strchr( "({", *( r + 1 ) ) != NULL && quote != '\'' ) {
+            MAC_ENTRY entry;
+            char *v = scratchval;
+
+            if ( r > lit ) {
+                seg->text   = lit;
+                seg->length = r - lit;
+                seg->ref    = FALSE;
+                seg++;
+            }
+
+            entry.name  = tmpl->source;
+            entry.type  = "string";
+            entry.error = FALSE;
+            seg->text = r;
+            refer( scratch, &entry, 0, &r, &v, scratchval + MAC_SIZE );
+            seg->length = r + 1 - seg->text;
+            seg->ref    = TRUE;
+            seg++;
+            lit = r + 1;
+        }
+        else if ( *r == '\\' && *( r + 1 ) != '\0' ) {
+            r++;
+        }
+    }
+    if ( r > lit ) {
+        seg->text   = lit;
+        seg->length = r - lit;
+        seg->ref    = FALSE;
+        seg++;
+    }
+    tmpl->nsegs = seg - tmpl->seg;
+
+    macDeleteHandle( scratch );
+    return tmpl;
+}
 
 /*
- * Return pointer to first macro entry (could be preprocessor macro)
+ * Expand a compiled template, giving the same result as expanding its
+ * source string with macExpandString()
  */
-static MAC_ENTRY *first( MAC_HANDLE *handle )
+long                            /* strlen(dest), <0 if any macros are */
+                                /* undefined */
+epicsStdCall macExpandTemplate(
+    MAC_HANDLE  *handle,        /* opaque handle */
+
+    const MAC_TEMPLATE *tmpl,   /* compiled template */
+
+    char        *dest,          /* destination string */
+
+    long        capacity )      /* capacity of destination buffer (dest) */
 {
-    return ( MAC_ENTRY * ) ellFirst( &handle->list );
+    MAC_ENTRY entry;
+    const MAC_SEGMENT *seg;
+    char *d, *dend;
+    long length;
+
+    /* check handle and template */
+    if ( handle == NULL || handle->magic != MAC_MAGIC ) {
+        errlogPrintf( "macExpandTemplate: NULL or invalid handle\n" );
+        return -1;
+    }
+    if ( tmpl == NULL || tmpl->magic != MAC_TEMPLATE_MAGIC ) {
+        errlogPrintf( "macExpandTemplate: NULL or invalid template\n" );
+        return -1;
+    }
+
+    /* debug output */
+    if ( handle->debug & 1 )
+        printf( "macExpandTemplate( %s, capacity = %ld )\n",
+                tmpl->source, capacity );
+
+    /* Check size */
+    if (capacity <= 1)
+        return -1;
+
+    /* expand raw values if necessary */
+    if ( expand( handle ) < 0 )
+        errlogPrintf( "macExpandTemplate: failed to expand raw values\n" );
+
+    /* fill in necessary fields in fake macro entry structure */
+    entry.name  = tmpl->source;
+    entry.type  = "string";
+    entry.error = FALSE;
+
+    /* copy literal text and expand the references */
+    d    = dest;
+    dend = dest + capacity - 1;
+    *d   = '\0';
+    for ( seg = tmpl->seg; seg < tmpl->seg + tmpl->nsegs; seg++ ) {
+        if ( seg->ref ) {
+            const char *r = seg->text;
+
+            refer( handle, &entry, 0, &r, &d, dend );
+        }
+        else {
+            size_t n = seg->length;
+
+            if ( n > ( size_t ) ( dend - d ) )
+                n = dend - d;
+            memcpy( d, seg->text, n );
+            d += n;
+            *d = '\0';
+        }
+    }
+
+    /* return +/- #chars copied depending on successful expansion */
+    length = d - dest;
+    length = ( entry.error ) ? -length : length;
+
+    /* debug output */
+    if ( handle->debug & 1 )
+        printf( "macExpandTemplate() -> %ld\n", length );
+
+    return length;
 }
 
 /*
- * Return pointer to last macro entry (could be preprocessor macro)
+ * Free a compiled template
  */
-static MAC_ENTRY *last( MAC_HANDLE *handle )
+void
+epicsStdCall macDeleteTemplate(
+    MAC_TEMPLATE *tmpl )        /* compiled template */
 {
-    return ( MAC_ENTRY * ) ellLast( &handle->list );
+    if ( tmpl == NULL )
+        return;
+    if ( tmpl->magic != MAC_TEMPLATE_MAGIC ) {
+        errlogPrintf( "macDeleteTemplate: invalid template\n" );
+        return;
+    }
+    tmpl->magic = 0;
+    free( tmpl );
 }
 
+/******************** beginning of static functions ********************/
+
 /*
- * Return pointer to next macro entry (could be preprocessor macro)
+ * Return pointer to first macro entry (could be preprocessor macro)
  */
-static MAC_ENTRY *next( MAC_ENTRY *entry )
+static MAC_ENTRY *first( MAC_HANDLE *handle )
 {
-    return ( MAC_ENTRY * ) ellNext( ( ELLNODE * ) entry );
+    return ( MAC_ENTRY * ) ellFirst( &handle->list );
 }
 
 /*
- * Return pointer to previous macro entry (could be preprocessor macro)
+ * Return pointer to next macro entry (could be preprocessor macro)
  */
-static MAC_ENTRY *previous( MAC_ENTRY *entry )
+static MAC_ENTRY *next( MAC_ENTRY *entry )
 {
-    return ( MAC_ENTRY * ) ellPrevious( ( ELLNODE * ) entry );
+    return ( MAC_ENTRY * ) ellNext( ( ELLNODE * ) entry );
 }
 
 /*
@@ -544,6 +749,7 @@ static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special )
 {
     ELLLIST   *list  = &handle->list;
     MAC_ENTRY *entry = ( MAC_ENTRY * ) dbmfMalloc( sizeof( MAC_ENTRY ) );
+    MAC_ENTRY **bucket;
 
     if ( entry != NULL ) {
         entry->name   = Strdup( name );
@@ -562,6 +768,11 @@ static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special )
             entry->level   = handle->level;
 
             ellAdd( list, ( ELLNODE * ) entry );
+
+            /* newest first in its bucket, so scoping works */
+            bucket = &handle->hash[HASH( name )];
+            entry->hashNext = *bucket;
+            *bucket = entry;
         }
     }
 
@@ -579,8 +790,9 @@ static MAC_ENTRY *lookup( MAC_HANDLE *handle, const char *name, int special )
         printf( "lookup-> level = %d, name = %s, special = %d\n",
                 handle->level, name, special );
 
-    /* search backwards so scoping works */
-    for ( entry = last( handle ); entry != NULL; entry = previous( entry ) ) {
+    /* buckets are searched newest first so scoping works */
+    for ( entry = handle->hash[HASH( name )]; entry != NULL;
+          entry = entry->hashNext ) {
         if ( entry->special != special )
             continue;
         if ( strcmp( name, entry->name ) == 0 )
@@ -627,9 +839,14 @@ static char *rawval( MAC_HANDLE *handle, MAC_ENTRY *entry, const char *value )
 static void delete( MAC_HANDLE *handle, MAC_ENTRY *entry )
 {
     ELLLIST *list = &handle->list;
+    MAC_ENTRY **pprev = &handle->hash[HASH( entry->name )];
 
     ellDelete( list, ( ELLNODE * ) entry );
 
+    while ( *pprev != entry )
+        pprev = &( *pprev )->hashNext;
+    *pprev = entry->hashNext;
+
     dbmfFree( entry->name );
     if ( entry->rawval != NULL )
         dbmfFree( entry->rawval );
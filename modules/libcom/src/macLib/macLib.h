@@ -47,8 +47,13 @@ typedef struct {
     int         debug;          /**< \brief debugging level */
     ELLLIST     list;           /**< \brief macro name / value list */
     int         flags;          /**< \brief operating mode flags */
+    struct mac_entry **hash;    /**< \brief macro entries hashed by name */
 } MAC_HANDLE;
 
+/** \brief A string compiled for repeated expansion, see macCompileTemplate()
+ */
+typedef struct mac_template MAC_TEMPLATE;
+
 /** \name Core Library
  *  The core library provides a minimal set of basic operations.
  *  @{
@@ -194,6 +199,44 @@ LIBCOM_API long
 epicsStdCall macPopScope(
     MAC_HANDLE  *handle         /**< opaque handle */
 );
+/**
+ * \brief Compiles a string which may contain macro references
+ * \return The compiled template; NULL = ERROR
+ *
+ * The string is split once into literal text and macro references, so
+ * it can be expanded many times against different macro definitions with
+ * macExpandTemplate() without being parsed again. The template does not
+ * depend on any handle, and must be freed with macDeleteTemplate().
+ */
+LIBCOM_API MAC_TEMPLATE *
+epicsStdCall macCompileTemplate(
+    const char  *src            /**< source string */
+);
+/**
+ * \brief Expands a compiled template
+ * \return Returns the length of the expanded string, <0 if any macro are
+ * undefined
+ *
+ * The result is the same as that of macExpandString() given the source
+ * string of the template.
+ */
+LIBCOM_API long
+epicsStdCall macExpandTemplate(
+    MAC_HANDLE  *handle,        /**< opaque handle */
+
+    const MAC_TEMPLATE *tmpl,   /**< compiled template */
+
+    char        *dest,          /**< destination string */
+
+    long        capacity        /**< capacity of destination buffer (dest) */
+);
+/**
+ * \brief Frees a compiled template
+ */
+LIBCOM_API void
+epicsStdCall macDeleteTemplate(
+    MAC_TEMPLATE *tmpl          /**< compiled template */
+);
 /**
  * \brief Reports details of current definitions
  * \return 0 = OK; <0 = ERROR
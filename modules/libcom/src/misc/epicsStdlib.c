@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <float.h>
+#include <limits.h>
 
 #include "epicsMath.h"
 #include "epicsStdlib.h"
@@ -20,20 +21,149 @@
 #include "epicsConvert.h"
 
 
+/* Plain decimal numbers are by far the most common input, so they are
+ * converted here without the C library; strto*() are still used for
+ * anything else, including overflows, so the results don't change.
+ */
+
+#define MAX_DIGITS 19       /* always fits in 64 bits */
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+/* Sign and magnitude of a decimal integer, returns the end or NULL if
+ * strto*() must handle it.
+ */
+static char * quickInteger(const char *str, int base, int *pneg,
+    epicsUInt64 *pval)
+{
+    const char *cp = str;
+    epicsUInt64 val = 0;
+    int n;
+
+    if (base != 10 && base != 0)
+        return NULL;
+    *pneg = *cp == '-';
+    if (*cp == '-' || *cp == '+')
+        cp++;
+    if (!IS_DIGIT(*cp))
+        return NULL;
+    if (base == 0 && cp[0] == '0' &&
+        (IS_DIGIT(cp[1]) || cp[1] == 'x' || cp[1] == 'X'))
+        return NULL;    /* octal or hex */
+
+    for (n = 0; IS_DIGIT(*cp); n++) {
+        if (n == MAX_DIGITS)
+            return NULL;
+        val = val * 10 + (*cp++ - '0');
+    }
+    *pval = val;
+    return (char *) cp;
+}
+
+/* Doubles with up to 15 digits and small exponents are converted
+ * exactly by a single multiply or divide (Clinger's fast path).  That
+ * needs arithmetic in double precision, not x87 extended precision.
+ */
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+
+static const double exactPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define MAX_EXACT 9007199254740992.0    /* 2^53 */
+
+/* Returns the end, or NULL if strtod() must handle it */
+static char * quickDouble(const char *str, double *pval)
+{
+    const char *cp = str;
+    epicsUInt64 mant = 0;
+    double value;
+    int neg, digits = 0, seen = 0, exp10 = 0;
+
+    neg = *cp == '-';
+    if (*cp == '-' || *cp == '+')
+        cp++;
+    if (cp[0] == '0' && (cp[1] == 'x' || cp[1] == 'X'))
+        return NULL;
+
+    for (; IS_DIGIT(*cp); cp++, seen = 1) {
+        if (digits == MAX_DIGITS)
+            return NULL;
+        mant = mant * 10 + (*cp - '0');
+        digits += mant != 0;
+    }
+    if (*cp == '.') {
+        for (cp++; IS_DIGIT(*cp); cp++, seen = 1) {
+            if (digits == MAX_DIGITS)
+                return NULL;
+            mant = mant * 10 + (*cp - '0');
+            digits += mant != 0;
+            exp10--;
+        }
+    }
+    if (!seen)
+        return NULL;
+
+    if (*cp == 'e' || *cp == 'E') {
+        const char *ep = cp + 1;
+        int eneg = *ep == '-', e = 0;
+
+        if (*ep == '-' || *ep == '+')
+            ep++;
+        if (IS_DIGIT(*ep)) {
+            for (; IS_DIGIT(*ep); ep++)
+                if (e < 10000)
+                    e = e * 10 + (*ep - '0');
+            exp10 += eneg ? -e : e;
+            cp = ep;
+        }
+    }
+
+    value = (double) mant;
+    if (mant) {
+        if (mant > (epicsUInt64) 1 << 53 || exp10 < -22 || exp10 > 22 + 15)
+            return NULL;
+        if (exp10 < 0)
+            value /= exactPow10[-exp10];
+        else {
+            if (exp10 > 22) {
+                /* 1e30 is 1e8 * 1e22, exact if 1e8 still is */
+                value *= exactPow10[exp10 - 22];
+                if (value > MAX_EXACT)
+                    return NULL;
+                exp10 = 22;
+            }
+            value *= exactPow10[exp10];
+        }
+    }
+    *pval = neg ? -value : value;
+    return (char *) cp;
+}
+
+#else
+#define quickDouble(str, pval) NULL
+#endif
+
+
 /* These are the conversion primitives */
 
 LIBCOM_API int
 epicsParseLong(const char *str, long *to, int base, char **units)
 {
-    int c;
+    int c, neg;
     char *endp;
+    epicsUInt64 mag;
     long value;
 
     while ((c = *str) && isspace(c))
         ++str;
 
     errno = 0;
-    value = strtol(str, &endp, base);
+    endp = quickInteger(str, base, &neg, &mag);
+    if (endp && mag <= (epicsUInt64) LONG_MAX + neg)
+        value = neg && mag ? -(long) (mag - 1) - 1 : (long) mag;
+    else
+        value = strtol(str, &endp, base);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -56,15 +186,20 @@ epicsParseLong(const char *str, long *to, int base, char **units)
 LIBCOM_API int
 epicsParseULong(const char *str, unsigned long *to, int base, char **units)
 {
-    int c;
+    int c, neg;
     char *endp;
+    epicsUInt64 mag;
     unsigned long value;
 
     while ((c = *str) && isspace(c))
         ++str;
 
     errno = 0;
-    value = strtoul(str, &endp, base);
+    endp = quickInteger(str, base, &neg, &mag);
+    if (endp && !neg && mag <= ULONG_MAX)
+        value = (unsigned long) mag;
+    else
+        value = strtoul(str, &endp, base);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -87,15 +222,20 @@ epicsParseULong(const char *str, unsigned long *to, int base, char **units)
 LIBCOM_API int
 epicsParseLLong(const char *str, long long *to, int base, char **units)
 {
-    int c;
+    int c, neg;
     char *endp;
+    epicsUInt64 mag;
     long long value;
 
     while ((c = *str) && isspace(c))
         ++str;
 
     errno = 0;
-    value = strtoll(str, &endp, base);
+    endp = quickInteger(str, base, &neg, &mag);
+    if (endp && mag <= (epicsUInt64) LLONG_MAX + neg)
+        value = neg && mag ? -(long long) (mag - 1) - 1 : (long long) mag;
+    else
+        value = strtoll(str, &endp, base);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -118,15 +258,20 @@ epicsParseLLong(const char *str, long long *to, int base, char **units)
 LIBCOM_API int
 epicsParseULLong(const char *str, unsigned long long *to, int base, char **units)
 {
-    int c;
+    int c, neg;
     char *endp;
+    epicsUInt64 mag;
     unsigned long long value;
 
     while ((c = *str) && isspace(c))
         ++str;
 
     errno = 0;
-    value = strtoull(str, &endp, base);
+    endp = quickInteger(str, base, &neg, &mag);
+    if (endp && !neg)
+        value = (unsigned long long) mag;
+    else
+        value = strtoull(str, &endp, base);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -157,7 +302,9 @@ epicsParseDouble(const char *str, double *to, char **units)
         ++str;
 
     errno = 0;
-    value = epicsStrtod(str, &endp);
+    endp = quickDouble(str, &value);
+    if (!endp)
+        value = epicsStrtod(str, &endp);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include "epicsTypes.h"
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
 #include "epicsMutex.h"
 #include "epicsMessageQueue.h"
@@ -64,6 +65,8 @@ static struct {
     ELLLIST         timeProviders;
     gtProvider      *lastTimeProvider;
     epicsTimeStamp  lastProvidedTime;
+    void            *firstTimeProvider;     /* Read without timeListLock */
+    size_t          lastTime;               /* Packed lastProvidedTime */
 
     epicsMutexId    eventListLock;
     ELLLIST         eventProviders;
@@ -83,8 +86,105 @@ int osdTimeGetCurrent ( epicsTimeStamp *pDest );
 /* cleared if/when gtPvt.timeProviders contains more than the default osdTimeGetCurrent() */
 static int useOsdGetCurrent = 1;
 
+/* Where a size_t can hold a time stamp, epicsTimeGetCurrent() keeps the
+ * last time it provided packed in gtPvt.lastTime and ratchets it forwards
+ * with compare-and-swap.  It then only takes timeListLock when the highest
+ * priority provider fails.  Elsewhere gtPvt.lastProvidedTime is used, under
+ * the lock.
+ */
+#define LOCK_FREE_TIME (sizeof(size_t) >= sizeof(epicsUInt64))
+
 /* Implementation */
 
+static size_t timePack(const epicsTimeStamp *pts)
+{
+    return (size_t) (((epicsUInt64) pts->secPastEpoch << 32) | pts->nsec);
+}
+
+static void timeUnpack(epicsTimeStamp *pts, size_t packed)
+{
+    pts->secPastEpoch = (epicsUInt32) ((epicsUInt64) packed >> 32);
+    pts->nsec = (epicsUInt32) packed;
+}
+
+/* Move gtPvt.lastTime forwards to now, returns the value it had before,
+ * or the later value another thread stored first.
+ */
+static size_t timeAdvance(size_t now)
+{
+    size_t prev = epicsAtomicGetSizeT(&gtPvt.lastTime);
+
+    while (now > prev) {
+        size_t seen = epicsAtomicCmpAndSwapSizeT(&gtPvt.lastTime,
+            prev, now);
+
+        if (seen == prev)
+            break;
+        prev = seen;
+    }
+    return prev;
+}
+
+/* Provide the time ts from ptp, unless it is older than the last time
+ * provided, in which case provide that again.
+ */
+static void timeRatchet(gtProvider *ptp, const epicsTimeStamp *pts,
+    epicsTimeStamp *pDest)
+{
+    epicsTimeStamp last;
+    int key;
+
+    if (LOCK_FREE_TIME) {
+        size_t now = timePack(pts);
+        size_t prev = timeAdvance(now);
+        epicsTimeStamp ts;
+
+        if (now >= prev) {
+            *pDest = *pts;
+            if (gtPvt.lastTimeProvider != ptp)
+                gtPvt.lastTimeProvider = ptp;
+            return;
+        }
+
+        /* Another thread may have read a later time and stored it first.
+         * That was before this thread saw it, so asking the provider again
+         * must give at least as late a time unless it really went back.
+         */
+        if (ptp->get.Time(&ts) == epicsTimeOK && timePack(&ts) >= prev) {
+            now = timePack(&ts);
+            prev = timeAdvance(now);
+            timeUnpack(pDest, now >= prev ? now : prev);
+            if (gtPvt.lastTimeProvider != ptp)
+                gtPvt.lastTimeProvider = ptp;
+            return;
+        }
+        timeUnpack(&last, prev);
+    }
+    else {
+        if (epicsTimeGreaterThanEqual(pts, &gtPvt.lastProvidedTime)) {
+            *pDest = *pts;
+            gtPvt.lastProvidedTime = *pts;
+            gtPvt.lastTimeProvider = ptp;
+            return;
+        }
+        last = gtPvt.lastProvidedTime;
+    }
+
+    *pDest = last;
+    key = epicsInterruptLock();
+    gtPvt.ErrorCounts++;
+    epicsInterruptUnlock(key);
+
+    IFDEBUG(10) {
+        char lastText[40], buff[40];
+
+        epicsTimeToStrftime(lastText, sizeof(lastText), tsfmt, &last);
+        epicsTimeToStrftime(buff, sizeof(buff), tsfmt, pts);
+        printf("eTGC provider '%s' returned older time\n"
+            "    %s, using %s instead\n", ptp->name, buff, lastText);
+    }
+}
+
 static void generalTime_InitOnce(void *dummy)
 {
     ellInit(&gtPvt.timeProviders);
@@ -153,46 +253,39 @@ int generalTimeGetExceptPriority(epicsTimeStamp *pDest, int *pPrio, int ignore)
 int epicsStdCall epicsTimeGetCurrent(epicsTimeStamp *pDest)
 {
     gtProvider *ptp;
+    gtProvider *first = NULL;
     int status = S_time_noProvider;
     epicsTimeStamp ts;
 
     if(useOsdGetCurrent)
         return osdTimeGetCurrent(pDest);
 
-    generalTime_Init();
-
     IFDEBUG(20)
         printf("epicsTimeGetCurrent()\n");
 
+    /* Providers are never removed, and are only registered after
+     * initialization, so no locks are needed while the first one works.
+     */
+    if (LOCK_FREE_TIME) {
+        first = (gtProvider *) epicsAtomicGetPtrT(&gtPvt.firstTimeProvider);
+        if (first && first->get.Time(&ts) == epicsTimeOK) {
+            timeRatchet(first, &ts, pDest);
+            return epicsTimeOK;
+        }
+    }
+
+    generalTime_Init();
+
     epicsMutexMustLock(gtPvt.timeListLock);
     for (ptp = (gtProvider *)ellFirst(&gtPvt.timeProviders);
          ptp; ptp = (gtProvider *)ellNext(&ptp->node)) {
+        if (ptp == first)
+            continue;   /* Just failed */
 
         status = ptp->get.Time(&ts);
         if (status == epicsTimeOK) {
             /* check time is monotonic */
-            if (epicsTimeGreaterThanEqual(&ts, &gtPvt.lastProvidedTime)) {
-                *pDest = ts;
-                gtPvt.lastProvidedTime = ts;
-                gtPvt.lastTimeProvider = ptp;
-            } else {
-                int key;
-
-                *pDest = gtPvt.lastProvidedTime;
-                key = epicsInterruptLock();
-                gtPvt.ErrorCounts++;
-                epicsInterruptUnlock(key);
-
-                IFDEBUG(10) {
-                    char last[40], buff[40];
-
-                    epicsTimeToStrftime(last, sizeof(last), tsfmt,
-                        &gtPvt.lastProvidedTime);
-                    epicsTimeToStrftime(buff, sizeof(buff), tsfmt, &ts);
-                    printf("eTGC provider '%s' returned older time\n"
-                        "    %s, using %s instead\n", ptp->name, buff, last);
-                }
-            }
+            timeRatchet(ptp, &ts, pDest);
             break;
         }
     }
@@ -389,9 +482,12 @@ static void insertProvider(gtProvider *ptp, ELLLIST *plist, epicsMutexId lock)
         ellAdd(plist, &ptp->node);
     }
 
-    /* Check to see if we have more than just the OS default time source */
-    if(plist==&gtPvt.timeProviders && (ellCount(plist)!=1 || ptp->get.Time!=&osdTimeGetCurrent)) {
-        useOsdGetCurrent = 0;
+    if (plist == &gtPvt.timeProviders) {
+        /* Check to see if we have more than just the OS default time source */
+        if (ellCount(plist) != 1 || ptp->get.Time != &osdTimeGetCurrent)
+            useOsdGetCurrent = 0;
+
+        epicsAtomicSetPtrT(&gtPvt.firstTimeProvider, ellFirst(plist));
     }
 
     epicsMutexUnlock(lock);
@@ -33,6 +33,12 @@ typedef struct {
     unsigned int maxThreads;
     unsigned int workerStack;
     unsigned int workerPriority;
+    /* Non-zero gives each worker its own run queue.  Jobs queued by a
+     * worker go on its own queue, and idle workers steal jobs from the
+     * queues of busy ones.  All maxThreads workers are started with the
+     * pool.
+     */
+    unsigned int workStealing;
 } epicsThreadPoolConfig;
 
 typedef struct epicsThreadPool epicsThreadPool;
@@ -162,6 +162,11 @@ void epicsJobDestroy(epicsJob *job)
     }
     pool = job->pool;
 
+    if (pool->conf.workStealing) {
+        stealJobDestroy(job);
+        return;
+    }
+
     epicsMutexMustLock(pool->guard);
 
     assert(!job->dead);
@@ -186,9 +191,21 @@ int epicsJobMove(epicsJob *job, epicsThreadPool *newpool)
 
     /* remove from current pool */
     if (pool) {
+        int busy;
+
         epicsMutexMustLock(pool->guard);
 
-        if (job->queued || job->running) {
+        if (pool->conf.workStealing) {
+            epicsMutexId lock = stealJobLock(pool, job);
+
+            epicsMutexMustLock(lock);
+            busy = job->queued || job->running || job->refs;
+            epicsMutexUnlock(lock);
+        }
+        else {
+            busy = job->queued || job->running;
+        }
+        if (busy) {
             epicsMutexUnlock(pool->guard);
             return S_pool_jobBusy;
         }
@@ -220,6 +237,9 @@ int epicsJobQueue(epicsJob *job)
     if (!pool)
         return S_pool_noPool;
 
+    if (pool->conf.workStealing)
+        return stealJobQueue(job);
+
     epicsMutexMustLock(pool->guard);
 
     assert(!job->dead);
@@ -307,6 +327,9 @@ int epicsJobUnqueue(epicsJob *job)
     if (!pool)
         return S_pool_noPool;
 
+    if (pool->conf.workStealing)
+        return stealJobUnqueue(job);
+
     epicsMutexMustLock(pool->guard);
 
     assert(!job->dead);
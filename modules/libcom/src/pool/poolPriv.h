@@ -15,6 +15,23 @@
 #include "epicsEvent.h"
 #include "epicsMutex.h"
 
+/* Number of locks shared by the jobs of a work stealing pool */
+#define POOL_JOB_LOCKS 16
+
+/* A worker of a work stealing pool and its run queue.
+ * The worker takes jobs from the tail of its own queue,
+ * other workers steal them from the head.  A job which queues
+ * itself again while running goes on the head.
+ */
+typedef struct poolWorker {
+    epicsThreadPool *pool;
+    epicsMutexId lock; /* guards jobs */
+    ELLLIST jobs;
+    size_t nJobs; /* atomic copy of the jobs count */
+    int sleeping; /* atomic, waiting on wakeup */
+    epicsEventId wakeup;
+} poolWorker;
+
 struct epicsThreadPool {
     ELLNODE sharedNode;
     size_t sharedCount;
@@ -58,8 +75,22 @@ struct epicsThreadPool {
 
     /* copy of config passed when created */
     epicsThreadPoolConfig conf;
+
+    /* Work stealing mode, see poolSteal.c.
+     * jobs is not used, queued jobs stay in the owned list.
+     */
+    poolWorker *workers;
+    unsigned int nWorkers;
+    size_t nextWorker; /* atomic, picks queues for other threads' jobs */
+    size_t queuedCount; /* atomic, # of jobs on worker queues */
+    size_t busyCount; /* atomic, # of workers looking for or running jobs */
+    epicsMutexId jobLocks[POOL_JOB_LOCKS];
 };
 
+/* The lock which guards the state of a job in a work stealing pool */
+#define stealJobLock(pPool, pJob) \
+    ((pPool)->jobLocks[((size_t) (pJob) >> 6) % POOL_JOB_LOCKS])
+
 /* Called after manipulating counters to check that invariants are preserved */
 #define CHECKCOUNT(pPool) do { \
     if (!(pPool)->shutdown) { \
@@ -83,6 +114,14 @@ struct epicsThreadPool {
  * Based on the queued flag jobnode is added to the appropriate
  * list.
  */
+/* In a work stealing pool jobnode always stays in the owned list and the
+ * flags are guarded by stealJobLock().  A queued job is on the queue of
+ * the worker its worker member points to, which guards stealnode.
+ * Taking the job off that queue clears worker and counts a reference
+ * until the worker taking it has checked, under the job lock, that the
+ * job is still to run.  A job is only freed once it is not running and
+ * there are no such references.
+ */
 struct epicsJob {
     ELLNODE jobnode;
     epicsJobFunction func;
@@ -93,6 +132,11 @@ struct epicsJob {
     unsigned int running:1;
     unsigned int freewhendone:1; /* lazy delete of running job */
     unsigned int dead:1; /* flag to catch use of freed objects */
+
+    /* Work stealing mode */
+    ELLNODE stealnode;
+    void *worker; /* atomic, poolWorker whose queue holds stealnode */
+    int refs; /* atomic, # of workers which have taken the job */
 };
 
 #ifdef __cplusplus
@@ -101,6 +145,16 @@ extern "C" {
 
 int createPoolThread(epicsThreadPool *pool);
 
+/* Work stealing mode, see poolSteal.c */
+int stealPoolStart(epicsThreadPool *pool);
+void stealPoolWakeAll(epicsThreadPool *pool);
+int stealPoolWait(epicsThreadPool *pool, double timeout);
+void stealPoolFree(epicsThreadPool *pool);
+void stealPoolReport(epicsThreadPool *pool, FILE *fd);
+int stealJobQueue(epicsJob *job);
+int stealJobUnqueue(epicsJob *job);
+void stealJobDestroy(epicsJob *job);
+
 #ifdef __cplusplus
 }
 #endif
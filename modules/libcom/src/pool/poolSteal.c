@@ -0,0 +1,422 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* Work stealing mode of the thread pool.
+ *
+ * Each worker has its own run queue, so queueing and running jobs does
+ * not go through the pool mutex.  Jobs queued by a worker go on its own
+ * queue, which it works through newest first.  Jobs queued by other
+ * threads are spread over the workers.  A worker with nothing left to do
+ * steals the oldest job from another worker's queue before it sleeps.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "errlog.h"
+#include "ellLib.h"
+#include "epicsAtomic.h"
+#include "epicsThread.h"
+#include "epicsMutex.h"
+#include "epicsEvent.h"
+#include "cantProceed.h"
+
+#include "epicsThreadPool.h"
+#include "poolPriv.h"
+
+static epicsThreadOnceId workerIdOnce = EPICS_THREAD_ONCE_INIT;
+static epicsThreadPrivateId workerId; /* poolWorker of this thread */
+
+static void workerIdInit(void *unused)
+{
+    workerId = epicsThreadPrivateCreate();
+}
+
+/* Jobs are pushed on the tail of the queue, or the head if behind */
+static void pushJob(poolWorker *w, epicsJob *job, int behind)
+{
+    epicsAtomicIncrSizeT(&w->pool->queuedCount);
+
+    epicsMutexMustLock(w->lock);
+    if (behind)
+        ellInsert(&w->jobs, NULL, &job->stealnode);
+    else
+        ellAdd(&w->jobs, &job->stealnode);
+    epicsAtomicSetPtrT(&job->worker, w);
+    epicsAtomicIncrSizeT(&w->nJobs);
+    epicsMutexUnlock(w->lock);
+}
+
+/* Take the newest job from our own queue, or the oldest from another's */
+static epicsJob* popJob(poolWorker *w, int steal)
+{
+    ELLNODE *cur;
+    epicsJob *job = NULL;
+
+    if (!epicsAtomicGetSizeT(&w->nJobs))
+        return NULL;
+
+    epicsMutexMustLock(w->lock);
+    cur = steal ? ellGet(&w->jobs) : ellPop(&w->jobs);
+    if (cur) {
+        job = CONTAINER(cur, epicsJob, stealnode);
+        epicsAtomicIncrIntT(&job->refs);
+        epicsAtomicSetPtrT(&job->worker, NULL);
+        epicsAtomicDecrSizeT(&w->nJobs);
+    }
+    epicsMutexUnlock(w->lock);
+
+    if (job)
+        epicsAtomicDecrSizeT(&w->pool->queuedCount);
+    return job;
+}
+
+static epicsJob* takeJob(poolWorker *self)
+{
+    epicsThreadPool *pool = self->pool;
+    unsigned int n = pool->nWorkers;
+    unsigned int idx = self - pool->workers;
+    unsigned int i;
+    epicsJob *job = popJob(self, 0);
+
+    for (i = 1; !job && i < n; i++)
+        job = popJob(&pool->workers[(idx + i) % n], 1);
+    return job;
+}
+
+/* Wake a sleeping worker, trying w first */
+static void wakeWorker(epicsThreadPool *pool, poolWorker *w)
+{
+    unsigned int n = pool->nWorkers;
+    unsigned int idx = w - pool->workers;
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        poolWorker *other = &pool->workers[(idx + i) % n];
+
+        if (epicsAtomicGetIntT(&other->sleeping) &&
+            epicsAtomicCmpAndSwapIntT(&other->sleeping, 1, 0) == 1) {
+            epicsEventMustTrigger(other->wakeup);
+            return;
+        }
+    }
+}
+
+/* Remove a queued job from its worker's queue.
+ * Caller holds the job lock.
+ */
+static int unqueueLocked(epicsJob *job)
+{
+    poolWorker *w;
+
+    if (!job->queued)
+        return S_pool_jobIdle;
+
+    w = epicsAtomicGetPtrT(&job->worker);
+    if (w) {
+        epicsMutexMustLock(w->lock);
+        /* unless a worker took it meanwhile */
+        if (epicsAtomicGetPtrT(&job->worker) == w) {
+            ellDelete(&w->jobs, &job->stealnode);
+            epicsAtomicSetPtrT(&job->worker, NULL);
+            epicsAtomicDecrSizeT(&w->nJobs);
+            epicsAtomicDecrSizeT(&w->pool->queuedCount);
+        }
+        epicsMutexUnlock(w->lock);
+    }
+    job->queued = 0;
+    return 0;
+}
+
+/* Called with the job lock held, which is released */
+static void releaseJob(epicsThreadPool *pool, epicsJob *job,
+    epicsMutexId lock)
+{
+    int free_it = job->freewhendone && !job->running &&
+        !epicsAtomicGetIntT(&job->refs);
+
+    if (free_it)
+        job->dead = 1;
+    epicsMutexUnlock(lock);
+
+    if (free_it) {
+        epicsMutexMustLock(pool->guard);
+        ellDelete(&pool->owned, &job->jobnode);
+        epicsMutexUnlock(pool->guard);
+        free(job);
+    }
+}
+
+static void runJob(poolWorker *self, epicsJob *job)
+{
+    epicsThreadPool *pool = self->pool;
+    epicsMutexId lock = stealJobLock(pool, job);
+
+    epicsMutexMustLock(lock);
+    epicsAtomicDecrIntT(&job->refs);
+
+    /* Was it unqueued, or queued again, since we took it,
+     * or did another worker which took it get here first?
+     */
+    if (!job->queued || job->running || job->freewhendone ||
+        epicsAtomicGetPtrT(&job->worker)) {
+        releaseJob(pool, job, lock);
+        return;
+    }
+
+    for (;;) {
+        job->queued = 0;
+        job->running = 1;
+        epicsMutexUnlock(lock);
+
+        (*job->func)(job->arg, epicsJobModeRun);
+
+        epicsMutexMustLock(lock);
+        job->running = 0;
+        /* job may be re-queued from within callback */
+        if (!job->queued || job->freewhendone)
+            break;
+        /* Run it again straight away if nothing else is waiting here,
+         * otherwise it goes behind the jobs that are.
+         */
+        if (epicsAtomicGetSizeT(&self->nJobs) || pool->pauserun) {
+            pushJob(self, job, 1);
+            break;
+        }
+    }
+    releaseJob(pool, job, lock);
+}
+
+static void workerMain(void *arg)
+{
+    poolWorker *self = arg;
+    epicsThreadPool *pool = self->pool;
+    unsigned int nrun;
+
+    epicsThreadPrivateSet(workerId, self);
+
+    while (!pool->shutdown) {
+        epicsJob *job = NULL;
+
+        epicsAtomicIncrSizeT(&pool->busyCount);
+        if (!pool->pauserun) {
+            job = takeJob(self);
+            if (!job) {
+                /* Look again after announcing that we will sleep, so a
+                 * job queued meanwhile is either found or wakes us up.
+                 * Compare-and-swap for its full memory barrier.
+                 */
+                epicsAtomicCmpAndSwapIntT(&self->sleeping, 0, 1);
+                job = takeJob(self);
+                if (job)
+                    epicsAtomicSetIntT(&self->sleeping, 0);
+            }
+        }
+        else {
+            epicsAtomicCmpAndSwapIntT(&self->sleeping, 0, 1);
+        }
+
+        if (job) {
+            runJob(self, job);
+            epicsAtomicDecrSizeT(&pool->busyCount);
+            continue;
+        }
+
+        if (!epicsAtomicDecrSizeT(&pool->busyCount) &&
+            !epicsAtomicGetSizeT(&pool->queuedCount))
+            epicsEventSignal(pool->observerWakeup);
+
+        epicsEventMustWait(self->wakeup);
+        epicsAtomicSetIntT(&self->sleeping, 0);
+    }
+
+    epicsMutexMustLock(pool->guard);
+    nrun = --pool->threadsRunning;
+    epicsMutexUnlock(pool->guard);
+
+    if (!nrun)
+        epicsEventSignal(pool->shutdownEvent);
+}
+
+/* Called with the pool guard held */
+int stealPoolStart(epicsThreadPool *pool)
+{
+    unsigned int i, n = pool->conf.maxThreads;
+
+    epicsThreadOnce(&workerIdOnce, &workerIdInit, NULL);
+
+    pool->workers = callocMustSucceed(n, sizeof(*pool->workers),
+        "stealPoolStart");
+    for (i = 0; i < POOL_JOB_LOCKS; i++)
+        pool->jobLocks[i] = epicsMutexMustCreate();
+    for (i = 0; i < n; i++) {
+        poolWorker *w = &pool->workers[i];
+
+        w->pool = pool;
+        w->lock = epicsMutexMustCreate();
+        ellInit(&w->jobs);
+        w->wakeup = epicsEventMustCreate(epicsEventEmpty);
+    }
+    pool->nWorkers = n;
+
+    /* Jobs on the queues of workers that could not be started will be
+     * stolen by the others.
+     */
+    for (i = 0; i < n; i++) {
+        if (epicsThreadCreate("PoolWorker", pool->conf.workerPriority,
+                pool->conf.workerStack, &workerMain, &pool->workers[i]))
+            pool->threadsRunning++;
+    }
+    return pool->threadsRunning ? 0 : S_pool_noThreads;
+}
+
+void stealPoolWakeAll(epicsThreadPool *pool)
+{
+    unsigned int i;
+
+    for (i = 0; i < pool->nWorkers; i++) {
+        epicsAtomicSetIntT(&pool->workers[i].sleeping, 0);
+        epicsEventMustTrigger(pool->workers[i].wakeup);
+    }
+}
+
+int stealPoolWait(epicsThreadPool *pool, double timeout)
+{
+    int waited = 0;
+
+    while (epicsAtomicGetSizeT(&pool->queuedCount) ||
+           epicsAtomicGetSizeT(&pool->busyCount)) {
+        waited = 1;
+        if (timeout < 0.0) {
+            epicsEventMustWait(pool->observerWakeup);
+        }
+        else {
+            switch (epicsEventWaitWithTimeout(pool->observerWakeup, timeout)) {
+            case epicsEventWaitError:
+                cantProceed("epicsThreadPoolWait: failed to wait for Event");
+                break;
+            case epicsEventWaitTimeout:
+                return S_pool_timeout;
+            case epicsEventWaitOK:
+                break;
+            }
+        }
+    }
+
+    /* pass the wakeup on to any other observer */
+    if (waited)
+        epicsEventSignal(pool->observerWakeup);
+    return 0;
+}
+
+/* Called after all workers have stopped */
+void stealPoolFree(epicsThreadPool *pool)
+{
+    unsigned int i;
+
+    for (i = 0; i < pool->nWorkers; i++) {
+        epicsMutexDestroy(pool->workers[i].lock);
+        epicsEventDestroy(pool->workers[i].wakeup);
+    }
+    for (i = 0; i < POOL_JOB_LOCKS; i++)
+        epicsMutexDestroy(pool->jobLocks[i]);
+    free(pool->workers);
+}
+
+void stealPoolReport(epicsThreadPool *pool, FILE *fd)
+{
+    unsigned int i;
+
+    fprintf(fd, "  Work stealing, %lu jobs queued, %lu workers busy\n",
+            (unsigned long) epicsAtomicGetSizeT(&pool->queuedCount),
+            (unsigned long) epicsAtomicGetSizeT(&pool->busyCount));
+    for (i = 0; i < pool->nWorkers; i++) {
+        poolWorker *w = &pool->workers[i];
+
+        fprintf(fd, "  worker %u: %lu jobs queued%s\n", i,
+                (unsigned long) epicsAtomicGetSizeT(&w->nJobs),
+                epicsAtomicGetIntT(&w->sleeping) ? ", sleeping" : "");
+    }
+}
+
+int stealJobQueue(epicsJob *job)
+{
+    epicsThreadPool *pool = job->pool;
+    epicsMutexId lock = stealJobLock(pool, job);
+    poolWorker *w = NULL;
+    int ret = 0;
+
+    epicsMutexMustLock(lock);
+
+    assert(!job->dead);
+
+    if (pool->pauseadd) {
+        ret = S_pool_paused;
+    }
+    else if (job->freewhendone) {
+        ret = S_pool_jobBusy;
+    }
+    else if (!job->queued) {
+        job->queued = 1;
+        /* A running job is queued again by its worker when it finishes */
+        if (!job->running) {
+            w = epicsThreadPrivateGet(workerId);
+            if (!w || w->pool != pool)
+                w = &pool->workers[epicsAtomicIncrSizeT(&pool->nextWorker)
+                    % pool->nWorkers];
+            pushJob(w, job, 0);
+        }
+    }
+
+    epicsMutexUnlock(lock);
+
+    if (w)
+        wakeWorker(pool, w);
+    return ret;
+}
+
+int stealJobUnqueue(epicsJob *job)
+{
+    epicsMutexId lock = stealJobLock(job->pool, job);
+    int ret;
+
+    epicsMutexMustLock(lock);
+    assert(!job->dead);
+    ret = unqueueLocked(job);
+    epicsMutexUnlock(lock);
+    return ret;
+}
+
+void stealJobDestroy(epicsJob *job)
+{
+    epicsThreadPool *pool = job->pool;
+    epicsMutexId lock = stealJobLock(pool, job);
+
+    epicsMutexMustLock(pool->guard);
+    epicsMutexMustLock(lock);
+
+    assert(!job->dead);
+
+    unqueueLocked(job);
+
+    if (job->running || job->freewhendone ||
+        epicsAtomicGetIntT(&job->refs)) {
+        /* freed by the worker which has it */
+        job->freewhendone = 1;
+        epicsMutexUnlock(lock);
+    }
+    else {
+        ellDelete(&pool->owned, &job->jobnode);
+        job->dead = 1;
+        epicsMutexUnlock(lock);
+        free(job);
+    }
+
+    epicsMutexUnlock(pool->guard);
+}
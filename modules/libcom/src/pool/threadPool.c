@@ -72,6 +72,21 @@ epicsThreadPool* epicsThreadPoolCreate(epicsThreadPoolConfig *opts)
 
     epicsMutexMustLock(pool->guard);
 
+    if (pool->conf.workStealing) {
+        if (stealPoolStart(pool)) {
+            epicsMutexUnlock(pool->guard);
+            errlogPrintf("Error: Unable to create any threads for thread pool\n");
+            stealPoolFree(pool);
+            goto cleanup;
+        }
+        else if (pool->threadsRunning < pool->conf.maxThreads) {
+            errlogPrintf("Warning: Unable to create all threads for thread pool (%u/%u)\n",
+                         pool->threadsRunning, pool->conf.maxThreads);
+        }
+        epicsMutexUnlock(pool->guard);
+        return pool;
+    }
+
     for (i = 0; i < pool->conf.initialThreads; i++) {
         createPoolThread(pool);
     }
@@ -118,6 +133,10 @@ void epicsThreadPoolControlImpl(epicsThreadPool *pool, epicsThreadPoolOption opt
         if (!val && !pool->pauserun)
             pool->pauserun = 1;
 
+        else if (val && pool->pauserun && pool->conf.workStealing) {
+            pool->pauserun = 0;
+            stealPoolWakeAll(pool);
+        }
         else if (val && pool->pauserun) {
             int jobs = ellCount(&pool->jobs);
             pool->pauserun = 0;
@@ -160,6 +179,10 @@ void epicsThreadPoolControl(epicsThreadPool *pool, epicsThreadPoolOption opt, un
 int epicsThreadPoolWait(epicsThreadPool *pool, double timeout)
 {
     int ret = 0;
+
+    if (pool->conf.workStealing)
+        return stealPoolWait(pool, timeout);
+
     epicsMutexMustLock(pool->guard);
 
     while (ellCount(&pool->jobs) > 0 || pool->threadsAreAwake > 0) {
@@ -225,7 +248,10 @@ void epicsThreadPoolDestroy(epicsThreadPool *pool)
 
     pool->shutdown = 1;
     /* wakeup all */
-    if (pool->threadsWaking < pool->threadsSleeping) {
+    if (pool->conf.workStealing) {
+        stealPoolWakeAll(pool);
+    }
+    else if (pool->threadsWaking < pool->threadsSleeping) {
         pool->threadsWaking = pool->threadsSleeping;
         epicsEventSignal(pool->workerWakeup);
     }
@@ -255,6 +281,8 @@ void epicsThreadPoolDestroy(epicsThreadPool *pool)
             job->pool = NULL; /* orphan */
     }
 
+    if (pool->conf.workStealing)
+        stealPoolFree(pool);
     epicsEventDestroy(pool->workerWakeup);
     epicsEventDestroy(pool->shutdownEvent);
     epicsEventDestroy(pool->observerWakeup);
@@ -281,6 +309,8 @@ void epicsThreadPoolReport(epicsThreadPool *pool, FILE *fd)
         fprintf(fd, "  Pause workers\n");
     if (pool->shutdown)
         fprintf(fd, "  Shutdown in progress\n");
+    if (pool->conf.workStealing)
+        stealPoolReport(pool, fd);
 
     for (cur = ellFirst(&pool->jobs); cur; cur = ellNext(cur)) {
         epicsJob *job = CONTAINER(cur, epicsJob, jobnode);
@@ -360,6 +390,8 @@ LIBCOM_API epicsThreadPool* epicsThreadPoolGetShared(epicsThreadPoolConfig *opts
             continue;
         if (cur->conf.workerStack < opts->workerStack)
             continue;
+        if (!cur->conf.workStealing != !opts->workStealing)
+            continue;
 
         cur->sharedCount++;
         assert(cur->sharedCount > 0);
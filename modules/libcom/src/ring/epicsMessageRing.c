@@ -0,0 +1,334 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Each slot of the ring has a sequence number which tells whose turn it
+ * is: the slot for message number n is free to be written when its
+ * sequence is n, and holds the message once it is n+1.  The receiver
+ * sets it to n+capacity when it is done, which frees the slot for the
+ * next round.  Multiple senders claim message numbers by compare and
+ * swap on the tail index, a single sender just increments it.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "epicsAtomic.h"
+#include "epicsEvent.h"
+#include "epicsMessageRing.h"
+
+/* Keep the indices of the sender and the receiver in separate
+ * cache lines, so they don't bounce between CPUs when either moves.
+ */
+#define CACHE_LINE_SIZE 64
+
+typedef union {
+    size_t index;
+    int flag;
+    char pad[CACHE_LINE_SIZE];
+} ringIndex;
+
+typedef struct ringSlot {
+    size_t seq;
+    unsigned int size;
+    /* message follows */
+} ringSlot;
+
+struct epicsMessageRingPvt {
+    char *slots;
+    size_t mask;            /* capacity - 1 */
+    size_t slotSize;
+    unsigned int maxMessageSize;
+    int multi;
+    epicsEventId ready;
+
+    ringIndex head;         /* next to receive, receiver only */
+    ringIndex tail;         /* next to send */
+    ringIndex waiting;      /* receiver is waiting on ready */
+};
+
+#define SLOT(pring, n) \
+    ((ringSlot *) ((pring)->slots + ((n) & (pring)->mask) * (pring)->slotSize))
+
+static epicsMessageRingId ringCreate(unsigned int capacity,
+    unsigned int maximumMessageSize, int multi)
+{
+    struct epicsMessageRingPvt *pring;
+    size_t n = 1, i;
+
+    while (n < capacity)
+        n <<= 1;
+
+    pring = calloc(1, sizeof(*pring));
+    if (!pring)
+        return NULL;
+    pring->mask = n - 1;
+    pring->slotSize = (sizeof(ringSlot) + maximumMessageSize +
+        sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    pring->maxMessageSize = maximumMessageSize;
+    pring->multi = multi;
+    pring->slots = malloc(n * pring->slotSize);
+    pring->ready = epicsEventCreate(epicsEventEmpty);
+    if (!pring->slots || !pring->ready) {
+        if (pring->ready)
+            epicsEventDestroy(pring->ready);
+        free(pring->slots);
+        free(pring);
+        return NULL;
+    }
+    for (i = 0; i < n; i++)
+        SLOT(pring, i)->seq = i;
+    return pring;
+}
+
+LIBCOM_API epicsMessageRingId epicsStdCall epicsMessageRingCreate(
+    unsigned int capacity, unsigned int maximumMessageSize)
+{
+    return ringCreate(capacity, maximumMessageSize, 0);
+}
+
+LIBCOM_API epicsMessageRingId epicsStdCall epicsMessageRingMultiCreate(
+    unsigned int capacity, unsigned int maximumMessageSize)
+{
+    return ringCreate(capacity, maximumMessageSize, 1);
+}
+
+LIBCOM_API void epicsStdCall epicsMessageRingDestroy(epicsMessageRingId pring)
+{
+    epicsEventDestroy(pring->ready);
+    free(pring->slots);
+    free(pring);
+}
+
+/* Claim the slot for the next message, returns NULL if the ring is full */
+static ringSlot * claimSlot(epicsMessageRingId pring, size_t *pn)
+{
+    size_t n = epicsAtomicGetSizeT(&pring->tail.index);
+
+    for (;;) {
+        ringSlot *pslot = SLOT(pring, n);
+        size_t seq = epicsAtomicGetSizeT(&pslot->seq);
+        size_t prev;
+
+        if (seq != n) {
+            /* Slot not yet freed by the receiver, unless another
+             * sender has claimed n meanwhile.
+             */
+            if ((ptrdiff_t) (seq - n) < 0)
+                return NULL;
+            n = epicsAtomicGetSizeT(&pring->tail.index);
+            continue;
+        }
+        if (!pring->multi) {
+            epicsAtomicSetSizeT(&pring->tail.index, n + 1);
+            *pn = n;
+            return pslot;
+        }
+        prev = epicsAtomicCmpAndSwapSizeT(&pring->tail.index, n, n + 1);
+        if (prev == n) {
+            *pn = n;
+            return pslot;
+        }
+        n = prev;
+    }
+}
+
+static void putMessage(ringSlot *pslot, size_t n, const void *message,
+    unsigned int size)
+{
+    pslot->size = size;
+    memcpy(pslot + 1, message, size);
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetSizeT(&pslot->seq, n + 1);
+}
+
+/* Compare-and-swap for its full memory barrier: the message must be
+ * visible before we look at the flag, see waitMessage().
+ */
+static void wakeReceiver(epicsMessageRingId pring)
+{
+    if (epicsAtomicCmpAndSwapIntT(&pring->waiting.flag, 1, 0) == 1)
+        epicsEventMustTrigger(pring->ready);
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingTrySend(epicsMessageRingId pring,
+    const void *message, unsigned int messageSize)
+{
+    ringSlot *pslot;
+    size_t n;
+
+    if (messageSize > pring->maxMessageSize)
+        return -1;
+    pslot = claimSlot(pring, &n);
+    if (!pslot)
+        return -1;
+    putMessage(pslot, n, message, messageSize);
+    wakeReceiver(pring);
+    return 0;
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingTrySendBatch(
+    epicsMessageRingId pring, const void *messages, unsigned int messageSize,
+    unsigned int count)
+{
+    const char *pmsg = messages;
+    unsigned int i;
+
+    if (messageSize > pring->maxMessageSize)
+        return -1;
+    for (i = 0; i < count; i++, pmsg += messageSize) {
+        size_t n;
+        ringSlot *pslot = claimSlot(pring, &n);
+
+        if (!pslot)
+            break;
+        putMessage(pslot, n, pmsg, messageSize);
+    }
+    if (i)
+        wakeReceiver(pring);
+    return i;
+}
+
+/* Returns the message size, -1 if it didn't fit, or -2 if empty */
+static int getMessage(epicsMessageRingId pring, void *message,
+    unsigned int size)
+{
+    size_t n = pring->head.index;
+    ringSlot *pslot = SLOT(pring, n);
+    int ret;
+
+    if (epicsAtomicGetSizeT(&pslot->seq) != n + 1)
+        return -2;
+    epicsAtomicReadMemoryBarrier();
+
+    ret = pslot->size;
+    if (pslot->size <= size)
+        memcpy(message, pslot + 1, pslot->size);
+    else
+        ret = -1;
+
+    /* Done with the slot before it is handed back */
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetSizeT(&pslot->seq, n + pring->mask + 1);
+    pring->head.index = n + 1;
+    return ret;
+}
+
+static int isEmpty(epicsMessageRingId pring)
+{
+    size_t n = pring->head.index;
+
+    return epicsAtomicGetSizeT(&SLOT(pring, n)->seq) != n + 1;
+}
+
+/* Wait for the ring to be non-empty, returns non-zero on timeout */
+static int waitMessage(epicsMessageRingId pring, double timeout)
+{
+    epicsEventStatus status = epicsEventOK;
+
+    /* Compare-and-swap for its full memory barrier: a message sent
+     * after the flag is visible wakes us, one sent before is seen here.
+     */
+    epicsAtomicCmpAndSwapIntT(&pring->waiting.flag, 0, 1);
+    if (isEmpty(pring)) {
+        if (timeout < 0.0)
+            epicsEventMustWait(pring->ready);
+        else
+            status = epicsEventWaitWithTimeout(pring->ready, timeout);
+    }
+    /* A stale trigger from a sender which saw the flag just before we
+     * cleared it only makes a later wait return early.
+     */
+    epicsAtomicSetIntT(&pring->waiting.flag, 0);
+    return status != epicsEventOK && isEmpty(pring);
+}
+
+static int receiveMessage(epicsMessageRingId pring, void *message,
+    unsigned int size, double timeout)
+{
+    for (;;) {
+        int ret = getMessage(pring, message, size);
+
+        if (ret != -2)
+            return ret;
+        if (timeout == 0.0 || waitMessage(pring, timeout))
+            return -1;
+    }
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingTryReceive(
+    epicsMessageRingId pring, void *message, unsigned int size)
+{
+    return receiveMessage(pring, message, size, 0.0);
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingReceive(epicsMessageRingId pring,
+    void *message, unsigned int size)
+{
+    return receiveMessage(pring, message, size, -1.0);
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingReceiveWithTimeout(
+    epicsMessageRingId pring, void *message, unsigned int size, double timeout)
+{
+    return receiveMessage(pring, message, size, timeout);
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingTryReceiveBatch(
+    epicsMessageRingId pring, void *messages, unsigned int size,
+    unsigned int count, unsigned int *sizes)
+{
+    char *pmsg = messages;
+    unsigned int i;
+
+    if (size < pring->maxMessageSize)
+        return -1;
+    for (i = 0; i < count; i++, pmsg += size) {
+        int ret = getMessage(pring, pmsg, size);
+
+        if (ret < 0)
+            break;
+        if (sizes)
+            sizes[i] = ret;
+    }
+    return i;
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingReceiveBatch(
+    epicsMessageRingId pring, void *messages, unsigned int size,
+    unsigned int count, unsigned int *sizes)
+{
+    int ret;
+
+    while (!(ret = epicsMessageRingTryReceiveBatch(pring, messages, size,
+            count, sizes)) && count)
+        waitMessage(pring, -1.0);
+    return ret;
+}
+
+LIBCOM_API int epicsStdCall epicsMessageRingPending(epicsMessageRingId pring)
+{
+    size_t head = epicsAtomicGetSizeT(&pring->head.index);
+    size_t tail = epicsAtomicGetSizeT(&pring->tail.index);
+
+    /* Includes messages still being written by their senders */
+    return (int) (tail - head);
+}
+
+LIBCOM_API void epicsStdCall epicsMessageRingShow(epicsMessageRingId pring,
+    int level)
+{
+    printf("Message Ring Used:%d  Slots:%lu  %s producer\n",
+        epicsMessageRingPending(pring), (unsigned long) pring->mask + 1,
+        pring->multi ? "Multiple" : "Single");
+    if (level >= 1)
+        printf("  Maximum size:%u  Receiver %s\n", pring->maxMessageSize,
+            epicsAtomicGetIntT(&pring->waiting.flag) ? "waiting" : "running");
+}
@@ -0,0 +1,194 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/**
+ * \file epicsMessageRing.h
+ * \brief A message queue for a single receiver thread
+ *
+ * \details
+ * An epicsMessageRing passes messages from one or more sender threads to
+ * a single receiver thread on a first in, first out basis, like an
+ * epicsMessageQueue, but without a mutex.  The messages are kept in a
+ * circular buffer of fixed size slots whose positions are claimed and
+ * released with epicsAtomic operations.  The single producer variant may
+ * only be sent to by one thread at a time; the multiple producer variant
+ * works with any number of sender threads.  Only one thread may receive
+ * from either variant at a time.
+ *
+ * Senders never wait: a send fails if the ring is full.  The receiver
+ * waits on an event only when the ring is empty.  Batches of messages
+ * of the same size can be sent and received with one call, which only
+ * checks once whether the receiver must be woken.
+ */
+
+#ifndef INCepicsMessageRingh
+#define INCepicsMessageRingh
+
+#include "libComAPI.h"
+
+/** \brief An identifier for a message ring */
+typedef struct epicsMessageRingPvt *epicsMessageRingId;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Create a message ring for a single sender thread
+ * \param capacity Number of messages the ring can hold, rounded up
+ * to a power of two
+ * \param maximumMessageSize Number of bytes of the largest message
+ * \return An identifier for the new ring, or NULL on failure
+ */
+LIBCOM_API epicsMessageRingId epicsStdCall epicsMessageRingCreate(
+    unsigned int capacity, unsigned int maximumMessageSize);
+/**
+ * \brief Create a message ring for any number of sender threads
+ * \param capacity Number of messages the ring can hold, rounded up
+ * to a power of two
+ * \param maximumMessageSize Number of bytes of the largest message
+ * \return An identifier for the new ring, or NULL on failure
+ */
+LIBCOM_API epicsMessageRingId epicsStdCall epicsMessageRingMultiCreate(
+    unsigned int capacity, unsigned int maximumMessageSize);
+/**
+ * \brief Destroy a message ring and free its memory
+ */
+LIBCOM_API void epicsStdCall epicsMessageRingDestroy(epicsMessageRingId id);
+
+/**
+ * \brief Try to send a message
+ * \returns 0 if the message was queued.
+ * \returns -1 if the ring is full or the message is larger than the
+ * maximum message size.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingTrySend(epicsMessageRingId id,
+    const void *message, unsigned int messageSize);
+/**
+ * \brief Try to send a batch of messages
+ *
+ * The messages are \p messageSize bytes each and are stored one after
+ * the other at \p messages.  As many are queued as there is space for.
+ * \returns The number of messages queued, or -1 if \p messageSize is
+ * larger than the maximum message size.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingTrySendBatch(epicsMessageRingId id,
+    const void *messages, unsigned int messageSize, unsigned int count);
+
+/**
+ * \brief Try to receive a message
+ *
+ * A message larger than \p size is discarded.
+ * \returns Number of bytes in the message.
+ * \returns -1 if the ring is empty or the buffer too small.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingTryReceive(epicsMessageRingId id,
+    void *message, unsigned int size);
+/**
+ * \brief Receive a message, waiting for one to be sent if the ring is empty
+ * \returns Number of bytes in the message.
+ * \returns -1 if the buffer is too small for the message.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingReceive(epicsMessageRingId id,
+    void *message, unsigned int size);
+/**
+ * \brief Receive a message, waiting up to \p timeout seconds for one to
+ * be sent if the ring is empty
+ * \returns Number of bytes in the message.
+ * \returns -1 if no message arrived in time or the buffer is too small.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingReceiveWithTimeout(
+    epicsMessageRingId id, void *message, unsigned int size, double timeout);
+/**
+ * \brief Try to receive a batch of messages
+ *
+ * Up to \p count messages are copied to \p messages, \p size bytes
+ * apart, and their lengths stored in \p sizes unless it is NULL.
+ * \p size must be at least the maximum message size.
+ * \returns The number of messages received, or -1 if \p size is too small.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingTryReceiveBatch(
+    epicsMessageRingId id, void *messages, unsigned int size,
+    unsigned int count, unsigned int *sizes);
+/**
+ * \brief Receive a batch of messages, waiting for one to be sent if the
+ * ring is empty
+ *
+ * As epicsMessageRingTryReceiveBatch(), but returns at least one message.
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingReceiveBatch(
+    epicsMessageRingId id, void *messages, unsigned int size,
+    unsigned int count, unsigned int *sizes);
+
+/**
+ * \brief How many messages are queued
+ */
+LIBCOM_API int epicsStdCall epicsMessageRingPending(epicsMessageRingId id);
+/**
+ * \brief Display some information about the message ring
+ * \param level Controls the amount of information displayed.
+ */
+LIBCOM_API void epicsStdCall epicsMessageRingShow(epicsMessageRingId id,
+    int level);
+
+#ifdef __cplusplus
+}
+
+#include <new>
+
+/** \brief C++ wrapper of an epicsMessageRing.
+ *
+ *  The senders argument of the constructor picks the single or the
+ *  multiple producer variant.
+ */
+class epicsMessageRing {
+public:
+    enum producers { single, multiple };
+
+    epicsMessageRing(unsigned int capacity, unsigned int maximumMessageSize,
+                     producers senders = single)
+        : id(senders == single ?
+             epicsMessageRingCreate(capacity, maximumMessageSize) :
+             epicsMessageRingMultiCreate(capacity, maximumMessageSize))
+    {
+        if (!id)
+            throw std::bad_alloc();
+    }
+    ~epicsMessageRing() { epicsMessageRingDestroy(id); }
+
+    int trySend(const void *message, unsigned int messageSize)
+        { return epicsMessageRingTrySend(id, message, messageSize); }
+    int trySend(const void *messages, unsigned int messageSize,
+                unsigned int count)
+        { return epicsMessageRingTrySendBatch(id, messages, messageSize, count); }
+    int tryReceive(void *message, unsigned int size)
+        { return epicsMessageRingTryReceive(id, message, size); }
+    int receive(void *message, unsigned int size)
+        { return epicsMessageRingReceive(id, message, size); }
+    int receive(void *message, unsigned int size, double timeout)
+        { return epicsMessageRingReceiveWithTimeout(id, message, size, timeout); }
+    int tryReceive(void *messages, unsigned int size, unsigned int count,
+                   unsigned int *sizes = 0)
+        { return epicsMessageRingTryReceiveBatch(id, messages, size, count, sizes); }
+    int receive(void *messages, unsigned int size, unsigned int count,
+                unsigned int *sizes)
+        { return epicsMessageRingReceiveBatch(id, messages, size, count, sizes); }
+    unsigned int pending()
+        { return epicsMessageRingPending(id); }
+    void show(unsigned int level = 0)
+        { epicsMessageRingShow(id, level); }
+
+private:
+    epicsMessageRing(const epicsMessageRing &);
+    epicsMessageRing& operator=(const epicsMessageRing &);
+
+    epicsMessageRingId id;
+};
+
+#endif /* __cplusplus */
+
+#endif /* INCepicsMessageRingh */
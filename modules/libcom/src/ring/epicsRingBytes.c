@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include "epicsSpin.h"
+#include "epicsAtomic.h"
 #include "dbDefs.h"
 #include "epicsRingBytes.h"
 
@@ -33,15 +34,62 @@
  */
 #define SLOP    16
 
+/* Keep the indices of the writer and the reader in separate
+ * cache lines, so they don't bounce between CPUs on every put and get.
+ */
+#define CACHE_LINE_SIZE 64
+
+typedef union {
+    volatile int index;
+    char pad[CACHE_LINE_SIZE];
+} ringIndex;
+
 typedef struct ringPvt {
     epicsSpinId    lock;
-    volatile int   nextPut;
-    volatile int   nextGet;
     int            size;
     int            highWaterMark;
+    ringIndex      nextPut;
+    ringIndex      nextGet;
     volatile char buffer[1]; /* actually larger */
 }ringPvt;
 
+/*
+ * Without the lock there is one writer and one reader.  Each reads the
+ * other's index with acquire semantics, and updates its own index with
+ * release semantics once it is done with the data.  The spinlock orders
+ * everything by itself.  The compiler's acquire and release fences are
+ * free on x86, the epicsAtomic barriers are full fences.
+ */
+#ifdef __ATOMIC_ACQUIRE
+#  define ACQUIRE_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#  define RELEASE_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+#  define ACQUIRE_FENCE() epicsAtomicReadMemoryBarrier()
+#  define RELEASE_FENCE() epicsAtomicWriteMemoryBarrier()
+#endif
+
+static int acquire(const ringPvt *pring, const ringIndex *pnext)
+{
+    int index = pnext->index;
+    if (!pring->lock)
+        ACQUIRE_FENCE();
+    return index;
+}
+
+static void release(ringPvt *pring, ringIndex *pnext, int index)
+{
+    if (!pring->lock)
+        RELEASE_FENCE();
+    pnext->index = index;
+}
+
+static void updateHighWaterMark(ringPvt *pring, int nextPut, int nextGet)
+{
+    int used = nextPut - nextGet;
+    if (used < 0) used += pring->size;
+    if (used > pring->highWaterMark) pring->highWaterMark = used;
+}
+
 LIBCOM_API epicsRingBytesId  epicsStdCall epicsRingBytesCreate(int size)
 {
     ringPvt *pring = malloc(sizeof(ringPvt) + size + SLOP);
@@ -49,8 +97,8 @@ LIBCOM_API epicsRingBytesId  epicsStdCall epicsRingBytesCreate(int size)
         return NULL;
     pring->size = size + SLOP;
     pring->highWaterMark = 0;
-    pring->nextGet = 0;
-    pring->nextPut = 0;
+    pring->nextGet.index = 0;
+    pring->nextPut.index = 0;
     pring->lock    = 0;
     return((void *)pring);
 }
@@ -79,8 +127,8 @@ LIBCOM_API int epicsStdCall epicsRingBytesGet(
     int count;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    nextGet = pring->nextGet;
-    nextPut = pring->nextPut;
+    nextGet = pring->nextGet.index;
+    nextPut = acquire(pring, &pring->nextPut);
     size = pring->size;
 
     if (nextGet <= nextPut) {
@@ -109,7 +157,7 @@ LIBCOM_API int epicsStdCall epicsRingBytesGet(
             nbytes = count;
         }
     }
-    pring->nextGet = nextGet;
+    release(pring, &pring->nextGet, nextGet);
 
     if (pring->lock) epicsSpinUnlock(pring->lock);
     return nbytes;
@@ -120,11 +168,11 @@ LIBCOM_API int epicsStdCall epicsRingBytesPut(
 {
     ringPvt *pring = (ringPvt *)id;
     int nextGet, nextPut, size;
-    int freeCount, copyCount, topCount, used;
+    int freeCount, copyCount, topCount;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    nextGet = pring->nextGet;
-    nextPut = pring->nextPut;
+    nextGet = acquire(pring, &pring->nextGet);
+    nextPut = pring->nextPut.index;
     size = pring->size;
 
     if (nextPut < nextGet) {
@@ -157,22 +205,88 @@ LIBCOM_API int epicsStdCall epicsRingBytesPut(
             nextPut = nLeft;
         }
     }
-    pring->nextPut = nextPut;
-
-    used = nextPut - nextGet;
-    if (used < 0) used += pring->size;
-    if (used > pring->highWaterMark) pring->highWaterMark = used;
+    release(pring, &pring->nextPut, nextPut);
+    updateHighWaterMark(pring, nextPut, nextGet);
 
     if (pring->lock) epicsSpinUnlock(pring->lock);
     return nbytes;
 }
+
+LIBCOM_API int epicsStdCall epicsRingBytesGetSpan(
+    epicsRingBytesId id, char **pdata)
+{
+    ringPvt *pring = (ringPvt *)id;
+    int nextGet, nextPut;
+
+    if (pring->lock) epicsSpinLock(pring->lock);
+    nextGet = pring->nextGet.index;
+    nextPut = acquire(pring, &pring->nextPut);
+    if (pring->lock) epicsSpinUnlock(pring->lock);
+
+    *pdata = (char *)&pring->buffer[nextGet];
+    if (nextGet <= nextPut)
+        return nextPut - nextGet;
+    else
+        return pring->size - nextGet;
+}
+
+LIBCOM_API void epicsStdCall epicsRingBytesConsume(
+    epicsRingBytesId id, int nbytes)
+{
+    ringPvt *pring = (ringPvt *)id;
+    int nextGet;
+
+    if (pring->lock) epicsSpinLock(pring->lock);
+    nextGet = pring->nextGet.index + nbytes;
+    if (nextGet >= pring->size)
+        nextGet -= pring->size;
+    release(pring, &pring->nextGet, nextGet);
+    if (pring->lock) epicsSpinUnlock(pring->lock);
+}
+
+LIBCOM_API int epicsStdCall epicsRingBytesPutSpan(
+    epicsRingBytesId id, char **pdata)
+{
+    ringPvt *pring = (ringPvt *)id;
+    int nextGet, nextPut;
+    int freeCount, topCount;
+
+    if (pring->lock) epicsSpinLock(pring->lock);
+    nextGet = acquire(pring, &pring->nextGet);
+    nextPut = pring->nextPut.index;
+    if (pring->lock) epicsSpinUnlock(pring->lock);
+
+    *pdata = (char *)&pring->buffer[nextPut];
+    if (nextPut < nextGet) {
+        freeCount = nextGet - nextPut - SLOP;
+        return freeCount > 0 ? freeCount : 0;
+    }
+    freeCount = pring->size - nextPut + nextGet - SLOP;
+    topCount = pring->size - nextPut;
+    return freeCount < topCount ? freeCount : topCount;
+}
+
+LIBCOM_API void epicsStdCall epicsRingBytesCommit(
+    epicsRingBytesId id, int nbytes)
+{
+    ringPvt *pring = (ringPvt *)id;
+    int nextPut;
+
+    if (pring->lock) epicsSpinLock(pring->lock);
+    nextPut = pring->nextPut.index + nbytes;
+    if (nextPut >= pring->size)
+        nextPut -= pring->size;
+    release(pring, &pring->nextPut, nextPut);
+    updateHighWaterMark(pring, nextPut, pring->nextGet.index);
+    if (pring->lock) epicsSpinUnlock(pring->lock);
+}
 
 LIBCOM_API void epicsStdCall epicsRingBytesFlush(epicsRingBytesId id)
 {
     ringPvt *pring = (ringPvt *)id;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    pring->nextGet = pring->nextPut;
+    pring->nextGet.index = pring->nextPut.index;
     if (pring->lock) epicsSpinUnlock(pring->lock);
 }
 
@@ -182,8 +296,8 @@ LIBCOM_API int epicsStdCall epicsRingBytesFreeBytes(epicsRingBytesId id)
     int nextGet, nextPut;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    nextGet = pring->nextGet;
-    nextPut = pring->nextPut;
+    nextGet = pring->nextGet.index;
+    nextPut = pring->nextPut.index;
     if (pring->lock) epicsSpinUnlock(pring->lock);
 
     if (nextPut < nextGet)
@@ -199,8 +313,8 @@ LIBCOM_API int epicsStdCall epicsRingBytesUsedBytes(epicsRingBytesId id)
     int used;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    nextGet = pring->nextGet;
-    nextPut = pring->nextPut;
+    nextGet = pring->nextGet.index;
+    nextPut = pring->nextPut.index;
     if (pring->lock) epicsSpinUnlock(pring->lock);
 
     used = nextPut - nextGet;
@@ -222,7 +336,7 @@ LIBCOM_API int epicsStdCall epicsRingBytesIsEmpty(epicsRingBytesId id)
     int isEmpty;
 
     if (pring->lock) epicsSpinLock(pring->lock);
-    isEmpty = (pring->nextPut == pring->nextGet);
+    isEmpty = (pring->nextPut.index == pring->nextGet.index);
     if (pring->lock) epicsSpinUnlock(pring->lock);
 
     return isEmpty;
@@ -244,7 +358,7 @@ LIBCOM_API void epicsStdCall epicsRingBytesResetHighWaterMark(epicsRingBytesId i
     ringPvt *pring = (ringPvt *)id;
     int used;
     if (pring->lock) epicsSpinLock(pring->lock);
-    used = pring->nextGet - pring->nextPut;
+    used = pring->nextPut.index - pring->nextGet.index;
     if (used < 0) used += pring->size;
     pring->highWaterMark = used;
     if (pring->lock) epicsSpinUnlock(pring->lock);
@@ -23,6 +23,10 @@
  * \note If there is only one writer it is not necessary to lock for puts.
  * If there is a single reader it is not necessary to lock for gets.
  * epicsRingBytesLocked uses a spinlock.
+ *
+ * The span routines give direct access to the buffer, so data can be
+ * produced or consumed in place instead of being copied through a
+ * separate array.
  */
 
 #ifndef INCepicsRingBytesh
@@ -73,6 +77,47 @@ LIBCOM_API int  epicsStdCall epicsRingBytesGet(
  */
 LIBCOM_API int  epicsStdCall epicsRingBytesPut(
     epicsRingBytesId id, char *value,int nbytes);
+/**
+ * \brief Find the data at the head of the ring buffer without copying it
+ *
+ * The data may wrap around the end of the buffer, in which case the span
+ * only reaches to the end; after epicsRingBytesConsume() the next call
+ * returns the rest.
+ * \param id RingbufferID returned by epicsRingBytesCreate()
+ * \param pdata Where to put the address of the first byte
+ * \return The number of bytes that can be read at \c *pdata
+ * \note The bytes stay in the ring until they are consumed. With the
+ * locked variant only one reader at a time may use a span.
+ */
+LIBCOM_API int  epicsStdCall epicsRingBytesGetSpan(
+    epicsRingBytesId id, char **pdata);
+/**
+ * \brief Remove bytes read with epicsRingBytesGetSpan() from the ring buffer
+ * \param id RingbufferID returned by epicsRingBytesCreate()
+ * \param nbytes How many bytes to remove, at most the span length
+ */
+LIBCOM_API void epicsStdCall epicsRingBytesConsume(
+    epicsRingBytesId id, int nbytes);
+/**
+ * \brief Find free space in the ring buffer to write data in place
+ *
+ * The span ends at the end of the buffer, so it may be shorter than
+ * epicsRingBytesFreeBytes(); after epicsRingBytesCommit() the next call
+ * returns the space at the start.
+ * \param id RingbufferID returned by epicsRingBytesCreate()
+ * \param pdata Where to put the address of the free space
+ * \return The number of bytes that can be written at \c *pdata
+ * \note With the locked variant only one writer at a time may use a span.
+ */
+LIBCOM_API int  epicsStdCall epicsRingBytesPutSpan(
+    epicsRingBytesId id, char **pdata);
+/**
+ * \brief Add bytes written with epicsRingBytesPutSpan() to the ring buffer
+ * \param id RingbufferID returned by epicsRingBytesCreate()
+ * \param nbytes How many bytes were written, at most the span length
+ */
+LIBCOM_API void epicsStdCall epicsRingBytesCommit(
+    epicsRingBytesId id, int nbytes);
 /**
  * \brief Make the ring buffer empty
  * \param id RingbufferID returned by epicsRingBytesCreate()
@@ -55,6 +55,20 @@ LIBCOM_API int epicsStdCall epicsRingPointerPush(epicsRingPointerId id, void *p)
     return((pvoidPointer->push(p) ? 1 : 0));
 }
 
+LIBCOM_API int epicsStdCall epicsRingPointerPushMany(epicsRingPointerId id,
+    void * const *p, int n)
+{
+    voidPointer *pvoidPointer = reinterpret_cast<voidPointer*>(id);
+    return(pvoidPointer->pushMany(p, n));
+}
+
+LIBCOM_API int epicsStdCall epicsRingPointerPopMany(epicsRingPointerId id,
+    void **p, int n)
+{
+    voidPointer *pvoidPointer = reinterpret_cast<voidPointer*>(id);
+    return(pvoidPointer->popMany(p, n));
+}
+
 LIBCOM_API void epicsStdCall epicsRingPointerFlush(epicsRingPointerId id)
 {
     voidPointer *pvoidPointer = reinterpret_cast<voidPointer*>(id);
@@ -23,6 +23,12 @@
  * \note If there is only one writer it is not necessary to lock pushes.
  * If there is a single reader it is not necessary to lock pops.
  * epicsRingPointerLocked uses a spinlock.
+ *
+ * The writer's and the reader's indices are kept in separate cache lines.
+ * Without the lock the index of the other side is read with acquire and
+ * the own index updated with release semantics, so an element is never
+ * seen before it has been stored. Pushing or popping several elements
+ * in one call needs only one index update (and one lock) for all of them.
  */
 
 #ifndef INCepicsRingPointerh
@@ -30,6 +36,7 @@
 
 
 #include "epicsSpin.h"
+#include "epicsAtomic.h"
 #include "libComAPI.h"
 
 #ifdef __cplusplus
@@ -57,6 +64,20 @@ public: /* Functions */
      * \return The element, or NULL if the ring was empty
      */
     T* pop();
+    /**\brief Push several entries on the ring
+     * \param p Array of the pointers to push
+     * \param n Number of entries in the array
+     * \return The number of entries pushed, less than \c n if the ring
+     * filled up
+     */
+    int pushMany(T * const *p, int n);
+    /**\brief Take several elements off the ring
+     * \param p Array to store the elements in
+     * \param n Maximum number of elements to take
+     * \return The number of elements stored in \c p, 0 if the ring
+     * was empty
+     */
+    int popMany(T **p, int n);
     /**\brief Remove all elements from the ring.
      * \note If this operation is performed on a ring buffer of the
      * unsecured kind, all access to the ring should be locked.
@@ -103,13 +124,23 @@ private: /* Prevent compiler-generated member functions */
     epicsRingPointer& operator=(const epicsRingPointer &);
     int getUsedNoLock() const;
 
+    /* One index per cache line, so the writer and the reader
+     * don't bounce a shared line between CPUs on every operation.
+     */
+    union ringIndex {
+        volatile int index;
+        char pad[64];
+    };
+    int acquire(const ringIndex &next) const;
+    void release(ringIndex &next, int index);
+
 private: /* Data */
     epicsSpinId lock;
-    volatile int nextPush;
-    volatile int nextPop;
     int size;
     int highWaterMark;
     T  * volatile * buffer;
+    ringIndex nextPush;
+    ringIndex nextPop;
 };
 
 extern "C" {
@@ -148,6 +179,25 @@ LIBCOM_API int  epicsStdCall epicsRingPointerPush(epicsRingPointerId id,void *p)
  * \return The pointer from the buffer, or NULL if the ring was empty
  */
 LIBCOM_API void* epicsStdCall epicsRingPointerPop(epicsRingPointerId id) ;
+/**
+ * \brief Push several pointers into the ring buffer
+ * \param id Ring buffer identifier
+ * \param p Array of the pointers to push
+ * \param n Number of pointers in the array
+ * \return The number of pointers pushed, less than \c n if the buffer
+ * filled up
+ */
+LIBCOM_API int  epicsStdCall epicsRingPointerPushMany(epicsRingPointerId id,
+    void * const *p, int n);
+/**
+ * \brief Take several elements off the ring
+ * \param id Ring buffer identifier
+ * \param p Array to store the pointers in
+ * \param n Maximum number of pointers to take
+ * \return The number of pointers stored in \c p, 0 if the ring was empty
+ */
+LIBCOM_API int  epicsStdCall epicsRingPointerPopMany(epicsRingPointerId id,
+    void **p, int n);
 /**
  * \brief Remove all elements from the ring
  * \param id Ring buffer identifier
@@ -218,9 +268,11 @@ LIBCOM_API void epicsStdCall epicsRingPointerResetHighWaterMark(epicsRingPointer
 
 template <class T>
 inline epicsRingPointer<T>::epicsRingPointer(int sz, bool locked) :
-    lock(0), nextPush(0), nextPop(0), size(sz+1), highWaterMark(0),
+    lock(0), size(sz+1), highWaterMark(0),
     buffer(new T* [sz+1])
 {
+    nextPush.index = 0;
+    nextPop.index = 0;
     if (locked)
         lock = epicsSpinCreate();
 }
@@ -232,19 +284,51 @@ inline epicsRingPointer<T>::~epicsRingPointer()
     delete [] buffer;
 }
 
+/* The spinlock orders everything already, the fences are only needed
+ * between the single writer and the single reader.  Where the compiler
+ * provides acquire and release fences they cost nothing on x86, the
+ * epicsAtomic barriers are full fences.
+ */
+template <class T>
+inline int epicsRingPointer<T>::acquire(const ringIndex &next) const
+{
+    int index = next.index;
+    if (!lock) {
+#ifdef __ATOMIC_ACQUIRE
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#else
+        epicsAtomicReadMemoryBarrier();
+#endif
+    }
+    return index;
+}
+
+template <class T>
+inline void epicsRingPointer<T>::release(ringIndex &next, int index)
+{
+    if (!lock) {
+#ifdef __ATOMIC_RELEASE
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+        epicsAtomicWriteMemoryBarrier();
+#endif
+    }
+    next.index = index;
+}
+
 template <class T>
 inline bool epicsRingPointer<T>::push(T *p)
 {
     if (lock) epicsSpinLock(lock);
-    int next = nextPush;
+    int next = nextPush.index;
     int newNext = next + 1;
     if(newNext>=size) newNext=0;
-    if (newNext == nextPop) {
+    if (newNext == acquire(nextPop)) {
         if (lock) epicsSpinUnlock(lock);
         return(false);
     }
     buffer[next] = p;
-    nextPush = newNext;
+    release(nextPush, newNext);
     int used = getUsedNoLock();
     if (used > highWaterMark) highWaterMark = used;
     if (lock) epicsSpinUnlock(lock);
@@ -255,25 +339,64 @@ template <class T>
 inline T* epicsRingPointer<T>::pop()
 {
     if (lock) epicsSpinLock(lock);
-    int next = nextPop;
-    if (next == nextPush) {
+    int next = nextPop.index;
+    if (next == acquire(nextPush)) {
         if (lock) epicsSpinUnlock(lock);
         return(0);
     }
     T*p  = buffer[next];
     ++next;
     if(next >=size) next = 0;
-    nextPop = next;
+    release(nextPop, next);
     if (lock) epicsSpinUnlock(lock);
     return(p);
 }
 
+template <class T>
+inline int epicsRingPointer<T>::pushMany(T * const *p, int n)
+{
+    if (lock) epicsSpinLock(lock);
+    int next = nextPush.index;
+    int free = acquire(nextPop) - next - 1;
+    if (free < 0) free += size;
+    if (n > free) n = free;
+    for (int i = 0; i < n; i++) {
+        buffer[next] = p[i];
+        if (++next >= size) next = 0;
+    }
+    if (n > 0) {
+        release(nextPush, next);
+        int used = getUsedNoLock();
+        if (used > highWaterMark) highWaterMark = used;
+    }
+    if (lock) epicsSpinUnlock(lock);
+    return n < 0 ? 0 : n;
+}
+
+template <class T>
+inline int epicsRingPointer<T>::popMany(T **p, int n)
+{
+    if (lock) epicsSpinLock(lock);
+    int next = nextPop.index;
+    int used = acquire(nextPush) - next;
+    if (used < 0) used += size;
+    if (n > used) n = used;
+    for (int i = 0; i < n; i++) {
+        p[i] = buffer[next];
+        if (++next >= size) next = 0;
+    }
+    if (n > 0)
+        release(nextPop, next);
+    if (lock) epicsSpinUnlock(lock);
+    return n < 0 ? 0 : n;
+}
+
 template <class T>
 inline void epicsRingPointer<T>::flush()
 {
     if (lock) epicsSpinLock(lock);
-    nextPop = 0;
-    nextPush = 0;
+    nextPop.index = 0;
+    nextPush.index = 0;
     if (lock) epicsSpinUnlock(lock);
 }
 
@@ -281,7 +404,7 @@ template <class T>
 inline int epicsRingPointer<T>::getFree() const
 {
     if (lock) epicsSpinLock(lock);
-    int n = nextPop - nextPush - 1;
+    int n = nextPop.index - nextPush.index - 1;
     if (n < 0) n += size;
     if (lock) epicsSpinUnlock(lock);
     return n;
@@ -290,7 +413,7 @@ inline int epicsRingPointer<T>::getFree() const
 template <class T>
 inline int epicsRingPointer<T>::getUsedNoLock() const
 {
-    int n = nextPush - nextPop;
+    int n = nextPush.index - nextPop.index;
     if (n < 0) n += size;
     return n;
 }
@@ -315,7 +438,7 @@ inline bool epicsRingPointer<T>::isEmpty() const
 {
     bool isEmpty;
     if (lock) epicsSpinLock(lock);
-    isEmpty = (nextPush == nextPop);
+    isEmpty = (nextPush.index == nextPop.index);
     if (lock) epicsSpinUnlock(lock);
     return isEmpty;
 }
@@ -324,7 +447,7 @@ template <class T>
 inline bool epicsRingPointer<T>::isFull() const
 {
     if (lock) epicsSpinLock(lock);
-    int count = nextPush - nextPop +1;
+    int count = nextPush.index - nextPop.index +1;
     if (lock) epicsSpinUnlock(lock);
     return((count == 0) || (count == size));
 }
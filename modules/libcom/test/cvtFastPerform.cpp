@@ -242,6 +242,94 @@ private:
 };
 
 
+// How cvtDoubleToString() handled large numbers and high precisions
+// before it had its own exact conversions, for comparison.
+
+static void oldCvtDoubleToString(double src, char *dst, int prec)
+{
+    if (prec > 8 || src > 1e7 || src < -1e7) {
+        if (prec > 8 || src > 1e16 || src < -1e16) {
+            if (prec > 17) prec = 17;
+            sprintf(dst, "%*.*e", prec + 7, prec, src);
+        } else {
+            if (prec > 3) prec = 3;
+            sprintf(dst, "%.*f", prec, src);
+        }
+    }
+    else
+        cvtDoubleToString(src, dst, prec);
+}
+
+class PerfOldCvtFastDouble : public PerfConverter {
+    static const int digits = 17;
+public:
+    PerfOldCvtFastDouble ()
+    {
+        for (int i = 0; i <= digits; i++)
+            measured[i] = 0;    // Some targets seem to need this
+    }
+    int maxPrecision (void) const { return digits; }
+    const char *name (void) const { return "sprintf fallback"; }
+    void target (double srcD, float srcF, char *dst, size_t len, int prec) const
+    {
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+        oldCvtDoubleToString ( srcD, dst, prec );
+    }
+    void add(int prec, double elapsed) { measured[prec] += elapsed; }
+    double total (int prec) {
+        double total = measured[prec];
+        measured[prec] = 0;
+        return total;
+    }
+private:
+    double measured[digits+1];
+};
+
+
+class PerfCvtFastShortest : public PerfConverter {
+    static const int digits = 0;
+public:
+    PerfCvtFastShortest ()
+    {
+        for (int i = 0; i <= digits; i++)
+            measured[i] = 0;    // Some targets seem to need this
+    }
+    int maxPrecision (void) const { return digits; }
+    const char *name (void) const { return "shortest string"; }
+    void target (double srcD, float srcF, char *dst, size_t len, int prec) const
+    {
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+        cvtDoubleToShortestString ( srcD, dst );
+    }
+    void add(int prec, double elapsed) { measured[prec] += elapsed; }
+    double total (int prec) {
+        double total = measured[prec];
+        measured[prec] = 0;
+        return total;
+    }
+private:
+    double measured[digits+1];
+};
+
+
 class PerfSNPrintf : public PerfConverter {
     static const int digits = 17;
 public:
@@ -336,10 +424,12 @@ private:
 
 MAIN(cvtFastPerform)
 {
-    Perf t(4);
+    Perf t(6);
 
     t.addConverter( new PerfCvtFastFloat );
     t.addConverter( new PerfCvtFastDouble );
+    t.addConverter( new PerfOldCvtFastDouble );
+    t.addConverter( new PerfCvtFastShortest );
     t.addConverter( new PerfSNPrintf );
     t.addConverter( new PerfStreamBuf );
 
@@ -15,6 +15,8 @@
 #include <math.h>
 #include <float.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "epicsUnitTest.h"
 #include "cvtFast.h"
@@ -35,6 +37,97 @@
     testOk(!status, "epicsParse"#typ"('%s') OK", buf); \
     testOk(fabs(val_##typ - lit) < 0.5 * pow(10, -prec), #lit " => '%s'", buf);
 
+#define tryShortest(typ, lit, str) \
+    len = cvt##typ##ToShortestString(lit, buf); \
+    testOk(len == strlen(str) && !strcmp(buf, str), \
+        "cvt"#typ"ToShortestString(" #lit ") -> \"%s\"", buf);
+
+static double randomDouble(void)
+{
+    double mant = rand() / (RAND_MAX + 1.0) + rand() / (RAND_MAX + 1.0) / 1e9;
+    double val = ldexp(mant, rand() % 2000 - 1000);
+
+    return rand() & 1 ? -val : val;
+}
+
+/* Values outside the range of the fast code must match sprintf() */
+static void testMatchSprintf(void)
+{
+    char buf[80], ref[80];
+    int i, badDouble = 0, badFloat = 0;
+
+    for (i = 0; i < 100000; i++) {
+        double val = randomDouble();
+        float flt = (float) val;
+        int prec = rand() % 18;
+
+        if (i & 1)
+            val = flt = (float) (rand() % 100000000) * 1e8 / (rand() % 10 + 1);
+
+        cvtDoubleToString(val, buf, prec);
+        if (prec > 8 || val > 1e16 || val < -1e16)
+            sprintf(ref, "%*.*e", prec + 7, prec, val);
+        else if (val > 1e7 || val < -1e7)
+            sprintf(ref, "%.*f", prec > 3 ? 3 : prec, val);
+        else
+            strcpy(ref, buf);
+        if (strcmp(buf, ref) && !badDouble++)
+            testDiag("cvtDoubleToString(%.17g, %d) -> '%s' not '%s'",
+                val, prec, buf, ref);
+
+        prec %= 13;
+        cvtFloatToString(flt, buf, prec);
+        if (prec > 8 || flt >= 1e8 || flt <= -1e8)
+            sprintf(ref, "%*.*e", prec + 6, prec, (double) flt);
+        else if (flt > 1e7 || flt < -1e7)
+            sprintf(ref, "%.*f", prec > 3 ? 3 : prec, (double) flt);
+        else
+            strcpy(ref, buf);
+        if (strcmp(buf, ref) && !badFloat++)
+            testDiag("cvtFloatToString(%.9g, %d) -> '%s' not '%s'",
+                flt, prec, buf, ref);
+    }
+    testOk(!badDouble, "cvtDoubleToString matches sprintf (%d differ)",
+        badDouble);
+    testOk(!badFloat, "cvtFloatToString matches sprintf (%d differ)",
+        badFloat);
+}
+
+/* Shortest strings must read back exactly, and one digit less won't */
+static void testShortestRoundTrip(void)
+{
+    char buf[80];
+    int i, bad = 0;
+
+    for (i = 0; i < 100000; i++) {
+        double val = randomDouble();
+        int n = 0, digits = 0;
+        const char *pc;
+
+        cvtDoubleToShortestString(val, buf);
+        for (pc = buf; *pc && *pc != 'e'; pc++) {
+            if (*pc == '0' && n)
+                n++;
+            else if (*pc >= '1' && *pc <= '9')
+                digits = ++n;
+        }
+        if (epicsStrtod(buf, NULL) != val)
+            bad++;
+        else if (digits > 1) {
+            char shorter[40];
+
+            sprintf(shorter, "%.*e", digits - 2, val);
+            if (epicsStrtod(shorter, NULL) == val)
+                bad++;
+        }
+        if (bad == 1) {
+            testDiag("cvtDoubleToShortestString(%.17g) -> '%s'", val, buf);
+            bad++;
+        }
+    }
+    testOk(!bad, "cvtDoubleToShortestString round trips");
+}
+
 
 MAIN(cvtFastTest)
 {
@@ -55,7 +148,7 @@ MAIN(cvtFastTest)
 #endif
 #endif
 
-    testPlan(1062);
+    testPlan(1076);
 
     /* Arguments: type, value, num chars */
     testDiag("------------------------------------------------------");
@@ -456,5 +549,24 @@ MAIN(cvtFastTest)
     tryFString(Double, 1e+17, 4, 11);
     tryFString(Double, 1e+17, 5, 12);
 
+    testDiag("------------------------------------------------------");
+    testDiag("** Double and Float matching sprintf **");
+    testMatchSprintf();
+
+    testDiag("------------------------------------------------------");
+    testDiag("** Shortest round-trip strings **");
+    tryShortest(Double, 0.1, "0.1");
+    tryShortest(Double, 100, "100");
+    tryShortest(Double, 1e23, "1e+23");
+    tryShortest(Double, 5e-324, "5e-324");
+    tryShortest(Double, 1.0/3, "0.3333333333333333");
+    tryShortest(Double, -2.5e-5, "-2.5e-05");
+    tryShortest(Double, DBL_MAX, "1.7976931348623157e+308");
+    tryShortest(Float, 0.1f, "0.1");
+    tryShortest(Float, 16777216.0f, "16777216");
+    tryShortest(Float, FLT_MAX, "3.4028235e+38");
+    tryShortest(Float, -1e10f, "-1e+10");
+    testShortestRoundTrip();
+
     return testDone();
 }
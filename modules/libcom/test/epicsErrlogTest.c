@@ -82,6 +82,8 @@ typedef struct {
     epicsEventId done;
 } clientPvt;
 
+static void testRateLimit(void);
+static void testDirectConsole(void);
 static void testLogPrefix(void);
 static void acceptNewClient( void *pParam );
 static void readFromClient( void *pParam );
@@ -173,7 +175,7 @@ MAIN(epicsErrlogTest)
     char msg[256];
     clientPvt pvt, pvt2;
 
-    testPlan(40);
+    testPlan(49);
 
     strcpy(msg, truncmsg);
 
@@ -376,10 +378,108 @@ MAIN(epicsErrlogTest)
     testOk(1 == errlogRemoveListeners(&logClient, &pvt),
         "Removed 1 listener");
 
+    testRateLimit();
+    testDirectConsole();
     testLogPrefix();
 
     return testDone();
 }
+static char rateMsgs[8][80];
+static unsigned int rateCount;
+
+static void rateClient(void *raw, const char *msg)
+{
+    if (rateCount < NELEMENTS(rateMsgs))
+        strncpy(rateMsgs[rateCount], msg, sizeof(rateMsgs[0]) - 1);
+    rateCount++;
+}
+
+/* Every call comes from the same call site */
+static void rateMsg(const char *text)
+{
+    errlogPrintfNoConsole("Rate %s\n", text);
+}
+
+static void testRateLimit(void)
+{
+    int i;
+
+    testDiag("Testing rate limiting of repeated messages");
+
+    /* Clear "errlog: <n> messages were discarded" status */
+    errlogPrintfNoConsole(".");
+    errlogFlush();
+
+    errlogAddListener(&rateClient, NULL);
+    errlogSetRateLimit(0.2);
+
+    for (i = 0; i < 10; i++)
+        rateMsg("A");
+    errlogFlush();
+    testOk(rateCount == 1, "1 of 10 identical messages logged (%u)",
+        rateCount);
+
+    rateMsg("B");
+    errlogFlush();
+    testOk(rateCount == 3, "Different message logged with summary (%u)",
+        rateCount);
+    testOk(strcmp(rateMsgs[1], "errlog: \"Rate A\" repeated 9 more times\n")
+        == 0, "Summary of the repeats of A");
+    testOk(strcmp(rateMsgs[2], "Rate B\n") == 0, "Followed by B");
+
+    for (i = 0; i < 3; i++)
+        rateMsg("B");
+    epicsThreadSleep(0.6);
+    errlogFlush();
+    testOk(rateCount == 4 &&
+        strcmp(rateMsgs[3], "errlog: \"Rate B\" repeated 3 more times\n") == 0,
+        "Summary logged after the interval (%u)", rateCount);
+
+    errlogSetRateLimit(0.0);
+    rateMsg("C");
+    rateMsg("C");
+    errlogFlush();
+    testOk(rateCount == 6, "Repeats logged without rate limit (%u)",
+        rateCount);
+
+    testOk(1 == errlogRemoveListeners(&rateClient, NULL),
+        "Removed 1 listener");
+}
+
+static void testDirectConsole(void)
+{
+    FILE *fp = tmpfile();
+    char line[80];
+    int isOkToBlock = epicsThreadIsOkToBlock();
+    int lines = 0;
+
+    testDiag("Testing console output from a thread that may block");
+
+    if (!fp) {
+        testSkip(2, "tmpfile() failed");
+        return;
+    }
+
+    errlogFlush();
+    errlogSetConsole(fp);
+    epicsThreadSetOkToBlock(1);
+
+    errlogPrintf("Direct %d\n", 1);
+    rewind(fp);
+    testOk(fgets(line, sizeof(line), fp) && strcmp(line, "Direct 1\n") == 0,
+        "Message written before errlogPrintf() returned");
+
+    errlogFlush();
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp))
+        lines++;
+    testOk(lines == 1, "Not written again by the errlog thread (%d)", lines);
+
+    epicsThreadSetOkToBlock(isOkToBlock);
+    errlogSetConsole(NULL);
+    fclose(fp);
+}
+
 /*
  * Tests the log prefix code
  * The prefix is only applied to log messages as they go out to the socket,
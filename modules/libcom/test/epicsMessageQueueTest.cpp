@@ -16,7 +16,9 @@
 #include <errno.h>
 
 #include "epicsMessageQueue.h"
+#include "epicsMessageRing.h"
 #include "epicsThread.h"
+#include "epicsTime.h"
 #include "epicsExit.h"
 #include "epicsEvent.h"
 #include "epicsAssert.h"
@@ -442,6 +444,205 @@ extern "C" void messageQueueTest(void *parm)
     epicsThreadMustJoin(rxThread);
 }
 
+/*
+ * Message rings
+ */
+static void ringSingleThread(epicsMessageRing::producers senders)
+{
+    epicsMessageRing r1(4, 20, senders);
+    char cbuf[80];
+    unsigned int sizes[8];
+    unsigned int i;
+    int len;
+
+    testDiag("Simple single-thread %s producer ring tests:",
+        senders == epicsMessageRing::single ? "single" : "multiple");
+    testOk1(r1.pending() == 0);
+    for (i = 1; i <= 4; i++)
+        r1.trySend(msg1, i);
+    testOk1(r1.pending() == 4);
+    testOk(r1.trySend(msg1, 5) < 0, "trySend to full ring fails");
+    testOk(r1.trySend(msg1, 21) < 0, "trySend of oversized message fails");
+    for (i = 1; i <= 4; i++) {
+        len = r1.tryReceive(cbuf, sizeof cbuf);
+        if (!testOk((len == (int)i) && (strncmp(msg1, cbuf, len) == 0),
+                "received message %u", i))
+            testDiag("wanted:%d got:%d", i, len);
+    }
+    testOk1(r1.tryReceive(cbuf, sizeof cbuf) < 0);
+    testOk1(r1.receive(cbuf, sizeof cbuf, 0.1) < 0);
+
+    r1.trySend(msg1, 10);
+    r1.trySend(msg1, 5);
+    testOk(r1.tryReceive(cbuf, 5) < 0, "too small buffer, message discarded");
+    testOk1(r1.tryReceive(cbuf, 5) == 5);
+
+    testOk(r1.trySend(msg1, 10, 6) == 4, "batch of 6 sent, 4 fit");
+    testOk1(r1.pending() == 4);
+    testOk(r1.tryReceive(cbuf, 10, 8, sizes) < 0, "batch buffers too small");
+    testOk1(r1.tryReceive(cbuf, 20, 3, sizes) == 3);
+    testOk1(sizes[0] == 10 && sizes[2] == 10 &&
+        strncmp(msg1 + 20, &cbuf[40], 10) == 0);
+    testOk1(r1.receive(cbuf, 20, 3, sizes) == 1);
+    testOk1(r1.pending() == 0);
+}
+
+#define NUM_MESSAGES 200000
+#define MAX_RING_SENDERS 2
+
+struct ringMessage {
+    int sender;
+    int seq;
+    double payload;
+};
+
+struct ringRun {
+    epicsMessageQueue *queue;
+    epicsMessageRing *ring;
+    int senders;
+    int batch;
+    epicsEventId start;
+};
+
+struct ringSenderArg {
+    ringRun *run;
+    int id;
+};
+
+extern "C" void
+ringSender(void *arg)
+{
+    ringRun *run = ((ringSenderArg *)arg)->run;
+    ringMessage msg[16];
+    int n, id = ((ringSenderArg *)arg)->id;
+    int total = NUM_MESSAGES / run->senders;
+
+    epicsEventMustWait(run->start);
+    epicsEventMustTrigger(run->start);  /* wake the other senders */
+    for (n = 0; n < total;) {
+        int i, count = run->batch;
+
+        if (count > total - n)
+            count = total - n;
+        for (i = 0; i < count; i++) {
+            msg[i].sender = id;
+            msg[i].seq = n + i;
+            msg[i].payload = 0.0;
+        }
+        if (run->queue) {
+            run->queue->send(msg, sizeof(msg[0]));
+            n++;
+        }
+        else if (count == 1) {
+            if (run->ring->trySend(msg, sizeof(msg[0])) == 0)
+                n++;
+            else
+                epicsThreadSleep(0.0);
+        }
+        else {
+            int sent = run->ring->trySend(msg, sizeof(msg[0]), count);
+
+            n += sent;
+            if (sent < count)
+                epicsThreadSleep(0.0);
+        }
+    }
+}
+
+/* Time passing NUM_MESSAGES messages through the queue or ring */
+static void ringThroughput(const char *what, ringRun *run)
+{
+    ringMessage msg[16];
+    unsigned int sizes[16];
+    int next[MAX_RING_SENDERS];
+    int i, n, errors = 0;
+    epicsThreadId tid[MAX_RING_SENDERS];
+    ringSenderArg args[MAX_RING_SENDERS];
+    epicsThreadOpts opts = {epicsThreadPriorityMedium,
+        epicsThreadStackMedium, 1};
+    epicsTimeStamp begin, end;
+    double delay;
+
+    run->start = epicsEventMustCreate(epicsEventEmpty);
+    for (i = 0; i < run->senders; i++) {
+        next[i] = 0;
+        args[i].run = run;
+        args[i].id = i;
+        tid[i] = epicsThreadCreateOpt("ringSender", ringSender, &args[i],
+            &opts);
+        if (!tid[i])
+            testAbort("epicsThreadCreate failed");
+    }
+
+    epicsTimeGetMonotonic(&begin);
+    epicsEventMustTrigger(run->start);
+    for (n = 0; n < NUM_MESSAGES;) {
+        int count;
+
+        if (run->queue)
+            count = run->queue->receive(msg, sizeof(msg)) == sizeof(msg[0]);
+        else if (run->batch == 1)
+            count = run->ring->receive(msg, sizeof(msg)) == sizeof(msg[0]);
+        else
+            count = run->ring->receive(msg, sizeof(msg[0]), 16, sizes);
+        if (count <= 0) {
+            errors++;
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            if (msg[i].seq != next[msg[i].sender]++)
+                errors++;
+        }
+        n += count;
+    }
+    epicsTimeGetMonotonic(&end);
+
+    for (i = 0; i < run->senders; i++)
+        epicsThreadMustJoin(tid[i]);
+    epicsEventDestroy(run->start);
+
+    delay = epicsTimeDiffInSeconds(&end, &begin);
+    testDiag("%s: %.2f million messages/s", what, n / delay * 1e-6);
+    testOk(errors == 0, "%s: %d messages received in order", what, n);
+}
+
+/* Runs at a higher priority than the senders, so that with a single CPU
+ * a real-time sender doesn't spin on a full ring while we wait to run.
+ */
+extern "C" void ringTest(void *parm)
+{
+    epicsMessageQueue queue(64, sizeof(ringMessage));
+    epicsMessageRing spsc(64, sizeof(ringMessage));
+    epicsMessageRing mpsc(64, sizeof(ringMessage), epicsMessageRing::multiple);
+    ringRun run;
+
+    ringSingleThread(epicsMessageRing::single);
+    ringSingleThread(epicsMessageRing::multiple);
+
+    testDiag("Throughput with %d messages:", NUM_MESSAGES);
+    run.queue = &queue;
+    run.ring = NULL;
+    run.senders = 1;
+    run.batch = 1;
+    ringThroughput("epicsMessageQueue, 1 sender", &run);
+    run.senders = MAX_RING_SENDERS;
+    ringThroughput("epicsMessageQueue, 2 senders", &run);
+
+    run.queue = NULL;
+    run.ring = &spsc;
+    run.senders = 1;
+    ringThroughput("Single producer ring", &run);
+    run.batch = 16;
+    ringThroughput("Single producer ring, batches of 16", &run);
+
+    run.ring = &mpsc;
+    run.senders = MAX_RING_SENDERS;
+    run.batch = 1;
+    ringThroughput("Multiple producer ring, 2 senders", &run);
+    run.batch = 16;
+    ringThroughput("Multiple producer ring, 2 senders, batches of 16", &run);
+}
+
 MAIN(epicsMessageQueueTest)
 {
     epicsThreadOpts opts = {
@@ -451,7 +652,7 @@ MAIN(epicsMessageQueueTest)
     };
     epicsThreadId testThread;
 
-    testPlan(70 + NUM_SENDERS);
+    testPlan(70 + NUM_SENDERS + 44);
 
     testThread = epicsThreadCreateOpt("messageQueueTest",
         messageQueueTest, NULL, &opts);
@@ -460,5 +661,12 @@ MAIN(epicsMessageQueueTest)
 
     epicsThreadMustJoin(testThread);
 
+    opts.priority = epicsThreadPriorityHigh;
+    testThread = epicsThreadCreateOpt("ringTest", ringTest, NULL, &opts);
+    if (!testThread)
+        testAbort("epicsThreadCreate failed");
+
+    epicsThreadMustJoin(testThread);
+
     return testDone();
 }
@@ -0,0 +1,146 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* Measure epicsParseDouble() and epicsParseLong() on the kind of
+ * strings found in database files and sent by CA clients, compared
+ * with calling strtod() and strtol() directly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsStdlib.h"
+#include "epicsTime.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#define NSTRINGS 1000
+#define NLOOPS 1000
+
+static char strings[NSTRINGS][24];
+
+static void makeDoubles(void)
+{
+    int i;
+
+    for (i = 0; i < NSTRINGS; i++) {
+        switch (i % 4) {
+        case 0:
+            sprintf(strings[i], "%d", rand() % 100000 - 50000);
+            break;
+        case 1:
+            sprintf(strings[i], "%.3f", rand() / 1000.0);
+            break;
+        case 2:
+            sprintf(strings[i], "%.6g", rand() * 1e-9);
+            break;
+        default:
+            sprintf(strings[i], "%.15g", rand() / 7.0);
+        }
+    }
+}
+
+static void makeLongs(void)
+{
+    int i;
+
+    for (i = 0; i < NSTRINGS; i++)
+        sprintf(strings[i], "%ld", (long) rand() - RAND_MAX / 2);
+}
+
+static double elapsed(const epicsTimeStamp *begin)
+{
+    epicsTimeStamp end;
+
+    epicsTimeGetMonotonic(&end);
+    return epicsTimeDiffInSeconds(&end, begin) * 1e9 / NSTRINGS / NLOOPS;
+}
+
+static void timeDoubles(void)
+{
+    epicsTimeStamp begin;
+    double sum = 0, check = 0, parse, native;
+    int i, j, bad = 0;
+
+    makeDoubles();
+    for (i = 0; i < NSTRINGS; i++) {
+        double val, ref = strtod(strings[i], NULL);
+
+        if (epicsParseDouble(strings[i], &val, NULL) || val != ref)
+            bad++;
+    }
+    testOk(!bad, "epicsParseDouble() agrees with strtod() (%d differ)", bad);
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0; j < NLOOPS; j++) {
+        for (i = 0; i < NSTRINGS; i++) {
+            double val;
+
+            epicsParseDouble(strings[i], &val, NULL);
+            sum += val;
+        }
+    }
+    parse = elapsed(&begin);
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0; j < NLOOPS; j++) {
+        for (i = 0; i < NSTRINGS; i++)
+            check += strtod(strings[i], NULL);
+    }
+    native = elapsed(&begin);
+
+    testDiag("epicsParseDouble: %6.1f ns, strtod: %6.1f ns", parse, native);
+    testOk(sum == check, "Same totals");
+}
+
+static void timeLongs(void)
+{
+    epicsTimeStamp begin;
+    long sum = 0, check = 0;
+    double parse, native;
+    int i, j, bad = 0;
+
+    makeLongs();
+    for (i = 0; i < NSTRINGS; i++) {
+        long val, ref = strtol(strings[i], NULL, 10);
+
+        if (epicsParseLong(strings[i], &val, 10, NULL) || val != ref)
+            bad++;
+    }
+    testOk(!bad, "epicsParseLong() agrees with strtol() (%d differ)", bad);
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0; j < NLOOPS; j++) {
+        for (i = 0; i < NSTRINGS; i++) {
+            long val;
+
+            epicsParseLong(strings[i], &val, 10, NULL);
+            sum += val;
+        }
+    }
+    parse = elapsed(&begin);
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0; j < NLOOPS; j++) {
+        for (i = 0; i < NSTRINGS; i++)
+            check += strtol(strings[i], NULL, 10);
+    }
+    native = elapsed(&begin);
+
+    testDiag("epicsParseLong:   %6.1f ns, strtol: %6.1f ns", parse, native);
+    testOk(sum == check, "Same totals");
+}
+
+MAIN(epicsStdlibPerform)
+{
+    testPlan(4);
+    timeDoubles();
+    timeLongs();
+    return testDone();
+}
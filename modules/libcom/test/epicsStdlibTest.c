@@ -73,7 +73,7 @@ MAIN(epicsStdlibTest)
     epicsInt64 i64;
     epicsUInt64 u64;
 
-    testPlan(199);
+    testPlan(208);
 
     testOk(epicsParseLong("", &l, 0, NULL) == S_stdlib_noConversion,
         "Long '' => noConversion");
@@ -419,6 +419,29 @@ MAIN(epicsStdlibTest)
         "Double '4294967294'");
     testOk(epicsScanDouble("4294967295", &d) && d == 4294967295.0,
         "Double '4294967295'");
+
+    testOk(epicsScanDouble("0.1", &d) && d == 0.1,
+        "Double '0.1'");
+    testOk(epicsScanDouble("1.5e30", &d) && d == 1.5e30,
+        "Double '1.5e30'");
+    testOk(epicsScanDouble("9007199254740993", &d) && d == 9007199254740992.0,
+        "Double '9007199254740993' rounds to even");
+    testOk(epicsScanDouble("123456789012345678901", &d) &&
+        d == 123456789012345678901.0,
+        "Double '123456789012345678901'");
+    testOk(epicsScanLLong("-9223372036854775808", &ll, 0) &&
+        ll == -9223372036854775807LL - 1,
+        "LLong '-9223372036854775808'");
+    testOk(epicsParseLLong("9223372036854775808", &ll, 0, NULL) ==
+        S_stdlib_overflow,
+        "LLong '9223372036854775808' => overflow");
+    testOk(epicsScanULLong("18446744073709551615", &ull, 0) &&
+        ull == 18446744073709551615ULL,
+        "ULLong '18446744073709551615'");
+    testOk(epicsScanLong("010", &l, 0) && l == 8,
+        "Long '010' base 0 is octal");
+    testOk(epicsScanLong("010", &l, 10) && l == 10,
+        "Long '010' base 10");
     testOk(epicsScanDouble("-4294967295", &d) && d == -4294967295.0,
         "Double '-4294967295'");
     testOk(epicsScanDouble("-4294967296", &d) && d == -4294967296.0,
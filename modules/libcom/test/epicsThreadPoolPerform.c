@@ -0,0 +1,100 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* Measure the rate at which a thread pool runs many short jobs which
+ * queue themselves again, with and without work stealing.
+ */
+
+#include <stdlib.h>
+
+#include "epicsThreadPool.h"
+#include "epicsAtomic.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "cantProceed.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#define NJOBS 64
+#define NRUNS 20000
+
+typedef struct {
+    epicsJob *job;
+    unsigned int left;
+    unsigned int sum;
+} perfJob;
+
+static size_t nRun;
+
+static void shortJob(void *arg, epicsJobMode mode)
+{
+    perfJob *pj = arg;
+    unsigned int i;
+
+    if (mode != epicsJobModeRun)
+        return;
+
+    /* a little work */
+    for (i = 0; i < 100; i++)
+        pj->sum += i * pj->left;
+
+    epicsAtomicIncrSizeT(&nRun);
+    if (--pj->left)
+        epicsJobQueue(pj->job);
+}
+
+static void timePool(unsigned int workStealing)
+{
+    epicsThreadPoolConfig conf;
+    epicsThreadPool *pool;
+    perfJob *jobs = callocMustSucceed(NJOBS, sizeof(*jobs), "timePool");
+    epicsTimeStamp begin, end;
+    double delay;
+    unsigned int i;
+
+    epicsThreadPoolConfigDefaults(&conf);
+    conf.initialThreads = conf.maxThreads;
+    conf.workStealing = workStealing;
+    pool = epicsThreadPoolCreate(&conf);
+    if (!pool)
+        testAbort("epicsThreadPoolCreate failed");
+
+    for (i = 0; i < NJOBS; i++) {
+        jobs[i].job = epicsJobCreate(pool, &shortJob, &jobs[i]);
+        jobs[i].left = NRUNS;
+    }
+    epicsAtomicSetSizeT(&nRun, 0);
+
+    epicsTimeGetMonotonic(&begin);
+    for (i = 0; i < NJOBS; i++)
+        epicsJobQueue(jobs[i].job);
+    epicsThreadPoolWait(pool, -1.0);
+    epicsTimeGetMonotonic(&end);
+
+    delay = epicsTimeDiffInSeconds(&end, &begin);
+    testDiag("%s, %u threads: %.2f million jobs/s",
+        workStealing ? "work stealing" : "shared queue", conf.maxThreads,
+        NJOBS * (double) NRUNS / delay * 1e-6);
+    testOk(epicsAtomicGetSizeT(&nRun) == NJOBS * (size_t) NRUNS,
+        "%lu jobs run", (unsigned long) epicsAtomicGetSizeT(&nRun));
+
+    for (i = 0; i < NJOBS; i++)
+        epicsJobDestroy(jobs[i].job);
+    epicsThreadPoolDestroy(pool);
+    free(jobs);
+}
+
+MAIN(epicsThreadPoolPerform)
+{
+    testPlan(2);
+
+    timePool(0);
+    timePool(1);
+
+    return testDone();
+}
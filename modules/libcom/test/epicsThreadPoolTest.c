@@ -19,6 +19,9 @@
 #include "epicsMutex.h"
 #include "epicsThread.h"
 
+/* Run the tests with work stealing pools */
+static unsigned int workStealing;
+
 /* Do nothing */
 static void nullop(void)
 {
@@ -111,6 +114,7 @@ static void postjobs(size_t icnt, size_t mcnt, int cork)
         epicsThreadPoolConfigDefaults(&conf);
         conf.initialThreads=icnt;
         conf.maxThreads=mcnt;
+        conf.workStealing=workStealing;
 
         testOk1((pool=epicsThreadPoolCreate(&conf))!=NULL);
         if(!pool)
@@ -204,12 +208,16 @@ static epicsJobFunction cleanupjobs[3] = {&cleanupjob0,&cleanupjob1,&cleanupjob2
 static void testcleanup(void)
 {
     int i=0;
+    epicsThreadPoolConfig conf;
     epicsThreadPool *pool;
     epicsJob *job[3];
 
     testDiag("testcleanup()");
 
-    testOk1((pool=epicsThreadPoolCreate(NULL))!=NULL);
+    flag0=0;
+    epicsThreadPoolConfigDefaults(&conf);
+    conf.workStealing=workStealing;
+    testOk1((pool=epicsThreadPoolCreate(&conf))!=NULL);
     if(!pool)
         return;
 
@@ -272,6 +280,7 @@ static void testreadd(void) {
 
     epicsThreadPoolConfigDefaults(&conf);
     conf.maxThreads = 2;
+    conf.workStealing = workStealing;
     testOk1((pool=epicsThreadPoolCreate(&conf))!=NULL);
     if(!pool)
         return;
@@ -328,8 +337,14 @@ static
 void testcancel(void)
 {
     epicsJob *job[2];
+    epicsThreadPoolConfig conf;
     epicsThreadPool *pool;
-    testOk1((pool=epicsThreadPoolCreate(NULL))!=NULL);
+
+    shouldneverrun=0;
+    numtoolate=0;
+    epicsThreadPoolConfigDefaults(&conf);
+    conf.workStealing=workStealing;
+    testOk1((pool=epicsThreadPoolCreate(&conf))!=NULL);
     if(!pool)
         return;
 
@@ -423,7 +438,7 @@ void testshared(void)
 
 MAIN(epicsThreadPoolTest)
 {
-    testPlan(171);
+    testPlan(265);
 
     nullop();
     oneop();
@@ -444,5 +459,15 @@ MAIN(epicsThreadPoolTest)
     testcancel();
     testshared();
 
+    testDiag("Work stealing");
+    workStealing=1;
+    postjobs(1,1,1);
+    postjobs(4,4,1);
+    postjobs(1,1,0);
+    postjobs(4,4,0);
+    testcleanup();
+    testreadd();
+    testcancel();
+
     return testDone();
 }
@@ -0,0 +1,143 @@
+/*************************************************************************\
+* Copyright (c) 2026 UChicago Argonne LLC, as Operator of Argonne
+*     National Laboratory.
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* Measure epicsTimeGetCurrent() when many threads time-stamp at once,
+ * as the scan and callback threads of an IOC do for every record they
+ * process.  A time provider is registered so the general time framework
+ * is used, rather than the shortcut taken when only the OS clock is.
+ */
+
+#include <stdio.h>
+
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "generalTimeSup.h"
+#include "epicsGeneralTime.h"
+#include "epicsUnitTest.h"
+#include "testMain.h"
+
+#define MAX_THREADS 16
+#define NCALLS 200000
+
+static epicsTimeStamp offset;
+
+/* Wall clock time, derived from the monotonic clock */
+static int perfGetTime(epicsTimeStamp *pDest)
+{
+    epicsTimeGetMonotonic(pDest);
+    pDest->secPastEpoch += offset.secPastEpoch;
+    pDest->nsec += offset.nsec;
+    if (pDest->nsec >= 1000000000u) {
+        pDest->nsec -= 1000000000u;
+        pDest->secPastEpoch++;
+    }
+    return epicsTimeOK;
+}
+
+typedef struct {
+    epicsEventId start;
+    epicsEventId done;
+    epicsMutexId lock;
+    int nRunning;
+    int nBackwards;
+} perfRun;
+
+static void stampThread(void *arg)
+{
+    perfRun *run = (perfRun *) arg;
+    epicsTimeStamp last, now;
+    int i, backwards = 0;
+
+    epicsEventMustWait(run->start);
+    epicsEventMustTrigger(run->start);  /* wake the next thread */
+    epicsTimeGetCurrent(&last);
+    for (i = 0; i < NCALLS; i++) {
+        epicsTimeGetCurrent(&now);
+        if (epicsTimeLessThan(&now, &last))
+            backwards++;
+        last = now;
+    }
+
+    epicsMutexMustLock(run->lock);
+    run->nBackwards += backwards;
+    if (--run->nRunning == 0)
+        epicsEventMustTrigger(run->done);
+    epicsMutexUnlock(run->lock);
+}
+
+static void timeThreads(int nThreads)
+{
+    perfRun run;
+    epicsTimeStamp begin, end;
+    double delay;
+    int i;
+
+    run.start = epicsEventMustCreate(epicsEventEmpty);
+    run.done = epicsEventMustCreate(epicsEventEmpty);
+    run.lock = epicsMutexMustCreate();
+    run.nRunning = nThreads;
+    run.nBackwards = 0;
+
+    for (i = 0; i < nThreads; i++) {
+        char name[16];
+
+        sprintf(name, "stamp%d", i);
+        epicsThreadMustCreate(name, epicsThreadPriorityMedium,
+            epicsThreadGetStackSize(epicsThreadStackSmall),
+            stampThread, &run);
+    }
+    epicsThreadSleep(0.1);
+
+    epicsTimeGetMonotonic(&begin);
+    epicsEventMustTrigger(run.start);
+    epicsEventMustWait(run.done);
+    epicsTimeGetMonotonic(&end);
+
+    delay = epicsTimeDiffInSeconds(&end, &begin);
+    testDiag("%2d threads: %8.1f ns per call, %6.2f million calls/s",
+        nThreads, delay * 1e9 / NCALLS,
+        (double) NCALLS * nThreads / delay * 1e-6);
+    testOk(run.nBackwards == 0, "%d threads saw time go backwards %d times",
+        nThreads, run.nBackwards);
+
+    epicsEventDestroy(run.start);
+    epicsEventDestroy(run.done);
+    epicsMutexDestroy(run.lock);
+}
+
+MAIN(epicsTimePerform)
+{
+    epicsTimeStamp now, mono;
+    int nThreads;
+
+    testPlan(6);
+
+    epicsTimeGetCurrent(&now);
+    epicsTimeGetMonotonic(&mono);
+    offset.secPastEpoch = now.secPastEpoch - mono.secPastEpoch - 1;
+    offset.nsec = now.nsec + 1000000000u - mono.nsec;
+    if (offset.nsec >= 1000000000u) {
+        offset.nsec -= 1000000000u;
+        offset.secPastEpoch++;
+    }
+    generalTimeRegisterCurrentProvider("Perform", 10, perfGetTime);
+    generalTimeResetErrorCounts();
+    testDiag("Using time provider '%s'", generalTimeHighestCurrentName());
+
+    for (nThreads = 1; nThreads <= MAX_THREADS; nThreads *= 2)
+        timeThreads(nThreads);
+
+    /* Readers racing each other is not the provider going backwards */
+    testOk(generalTimeGetErrorCounts() == 0,
+        "No provider errors counted with up to %d threads (%d)",
+        MAX_THREADS, generalTimeGetErrorCounts());
+
+    return testDone();
+}
@@ -22,6 +22,24 @@
 
 MAC_HANDLE *h;
 
+/* Expanding the string as a compiled template must give the same result */
+static void tcheck(const char *str, const char *expect)
+{
+    char output[MAC_SIZE] = {'\0'};
+    MAC_TEMPLATE *tmpl = macCompileTemplate(str);
+    long status = macExpandTemplate(h, tmpl, output, MAC_SIZE);
+    int expect_error = (expect[0] == '!');
+    int statBad = expect_error ^ (status < 0);
+    int strBad = strcmp(output, expect+1);
+
+    testOk(!statBad && !strBad, "template %s => %s", str, output);
+
+    if (strBad) {
+        testDiag("Got \"%s\", expected \"%s\"", output, expect+1);
+    }
+    macDeleteTemplate(tmpl);
+}
+
 static void check(const char *str, const char *expect)
 {
     char output[MAC_SIZE] = {'\0'};
@@ -40,10 +58,13 @@ static void check(const char *str, const char *expect)
         testDiag("Return status was %ld, expected %ld",
                  status, expect_error ? -expect_len : expect_len);
     }
+
+    tcheck(str, expect);
 }
 
 static void ovcheck(void)
 {
+    MAC_TEMPLATE *tmpl;
     char output[54];
     long status;
 
@@ -62,11 +83,58 @@ static void ovcheck(void)
     testOk(output[51] == 'z', "final character %x, expect 7a (z)", output[51]);
     testOk(output[52] == '\0', "terminator character %x, expect 0", output[52]);
     testOk(output[53] == '~', "sentinel character %x, expect 7e, (~)", output[53]);
+
+    tmpl = macCompileTemplate("abcdefghijklmnopqrstuvwxyz$(OVVAR)");
+    memset(output, '~', sizeof output);
+    status = macExpandTemplate(h, tmpl, output, 52);
+    testOk(status == 51 && output[50] == 'y' && output[51] == '\0' &&
+        output[52] == '~', "template expansion returned %ld, expected 51",
+        status);
+
+    memset(output, '~', sizeof output);
+    status = macExpandTemplate(h, tmpl, output, 27);
+    testOk(status == 26 && output[25] == 'z' && output[26] == '\0' &&
+        output[27] == '~', "template expansion returned %ld, expected 26",
+        status);
+    macDeleteTemplate(tmpl);
+}
+
+static void scopecheck(void)
+{
+    char name[16], value[MAC_SIZE];
+    long status;
+    int i, bad = 0;
+
+    /* More macros than hash buckets */
+    for (i = 0; i < 200; i++) {
+        sprintf(name, "M%d", i);
+        macPutValue(h, name, name + 1);
+    }
+    for (i = 0; i < 200; i++) {
+        sprintf(name, "M%d", i);
+        status = macGetValue(h, name, value, sizeof(value));
+        bad += status < 0 || atoi(value) != i;
+    }
+    testOk(bad == 0, "200 macros defined, %d wrong", bad);
+
+    macPushScope(h);
+    macPutValue(h, "M5", "inner");
+    macPushScope(h);
+    macPutValue(h, "M5", "innermost");
+    check("$(M5)", " innermost");
+    macPopScope(h);
+    check("$(M5)", " inner");
+    macPopScope(h);
+    check("$(M5)", " 5");
+
+    macPutValue(h, "M5", NULL);
+    check("$(M5)", "!$(M5)");
+    check("$(M6)", " 6");
 }
 
 MAIN(macLibTest)
 {
-    testPlan(93);
+    testPlan(191);
 
     if (macCreateHandle(&h, NULL))
         testAbort("macCreateHandle() failed");
@@ -221,6 +289,7 @@ MAIN(macLibTest)
     check("${FOO}", "!$(BAR)");
 
     ovcheck();
+    scopecheck();
 
     return testDone();
 }
@@ -21,6 +21,7 @@
 #include "epicsRingBytes.h"
 #include "errlog.h"
 #include "epicsEvent.h"
+#include "epicsTime.h"
 #include "epicsUnitTest.h"
 #include "testMain.h"
 
@@ -51,6 +52,114 @@ static void check(epicsRingBytesId ring, int expectedFree,
            highWaterMark, expectedHighWaterMark);
 }
 
+static void testSpans(const char *put)
+{
+    epicsRingBytesId ring = epicsRingBytesCreate(RINGSIZE);
+    char get[RINGSIZE];
+    char *span;
+    int n;
+
+    testDiag("Testing spans");
+
+    n = epicsRingBytesPutSpan(ring, &span);
+    testOk(n==RINGSIZE, "put span %d", n);
+    memcpy(span, put, 6);
+    epicsRingBytesCommit(ring, 6);
+    check(ring, RINGSIZE-6, 6);
+    n = epicsRingBytesGet(ring, get, RINGSIZE);
+    testOk(n==6 && memcmp(put,get,6)==0, "get matches span written");
+
+    n = epicsRingBytesPut(ring, (char *)put, 6);
+    testOk(n==6, "ring put %d", n);
+    n = epicsRingBytesGetSpan(ring, &span);
+    testOk(n==6 && memcmp(put,span,6)==0, "span matches put");
+    epicsRingBytesConsume(ring, 6);
+    check(ring, RINGSIZE, 6);
+
+    testDiag("Spans at the end of the buffer");
+    n = epicsRingBytesPut(ring, (char *)put, RINGSIZE);
+    n = epicsRingBytesGet(ring, get, RINGSIZE);
+    n = epicsRingBytesPutSpan(ring, &span);
+    testOk(n==4, "put span %d stops at the end", n);
+    memcpy(span, put, n);
+    epicsRingBytesCommit(ring, n);
+    n = epicsRingBytesPutSpan(ring, &span);
+    testOk(n==RINGSIZE-4, "put span %d at the start", n);
+    memcpy(span, put+4, n);
+    epicsRingBytesCommit(ring, n);
+    check(ring, 0, RINGSIZE);
+    n = epicsRingBytesPutSpan(ring, &span);
+    testOk(n==0, "no put span in full ring");
+
+    n = epicsRingBytesGetSpan(ring, &span);
+    testOk(n==4 && memcmp(put,span,4)==0, "get span %d stops at the end", n);
+    epicsRingBytesConsume(ring, n);
+    n = epicsRingBytesGetSpan(ring, &span);
+    testOk(n==RINGSIZE-4 && memcmp(put+4,span,n)==0,
+           "get span %d at the start", n);
+    epicsRingBytesConsume(ring, n);
+    check(ring, RINGSIZE, RINGSIZE);
+    n = epicsRingBytesGetSpan(ring, &span);
+    testOk(n==0, "no get span in empty ring");
+
+    epicsRingBytesDelete(ring);
+}
+
+#define MSGSIZE 64
+#define NMESSAGES 100000
+#define BATCH 32
+
+static void testThroughput(void)
+{
+    /* The ring adds 16 bytes, so messages don't straddle the end */
+    epicsRingBytesId ring = epicsRingBytesCreate(2*BATCH*MSGSIZE - 16);
+    char msg[MSGSIZE], get[MSGSIZE];
+    char *span;
+    epicsTimeStamp begin, end;
+    double copied, inPlace;
+    int i, j, bad = 0;
+
+    for (i = 0 ; i < MSGSIZE ; i++)
+        msg[i] = i;
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0 ; j < NMESSAGES ; j += BATCH) {
+        for (i = 0 ; i < BATCH ; i++)
+            epicsRingBytesPut(ring, msg, MSGSIZE);
+        for (i = 0 ; i < BATCH ; i++) {
+            epicsRingBytesGet(ring, get, MSGSIZE);
+            bad += get[i] != i;
+        }
+    }
+    epicsTimeGetMonotonic(&end);
+    copied = epicsTimeDiffInSeconds(&end, &begin) * 1e9 / NMESSAGES;
+
+    epicsTimeGetMonotonic(&begin);
+    for (j = 0 ; j < NMESSAGES ; j += BATCH) {
+        for (i = 0 ; i < BATCH ; i++) {
+            if (epicsRingBytesPutSpan(ring, &span) < MSGSIZE)
+                break;
+            memcpy(span, msg, MSGSIZE);
+            epicsRingBytesCommit(ring, MSGSIZE);
+        }
+        for (i = 0 ; i < BATCH ; i++) {
+            if (epicsRingBytesGetSpan(ring, &span) < MSGSIZE)
+                break;
+            bad += span[i] != i;
+            epicsRingBytesConsume(ring, MSGSIZE);
+        }
+        bad += i != BATCH;
+    }
+    epicsTimeGetMonotonic(&end);
+    inPlace = epicsTimeDiffInSeconds(&end, &begin) * 1e9 / NMESSAGES;
+
+    testOk(!bad, "Messages pass through the ring intact");
+    testDiag("%d byte messages: put/get %.1f ns, spans %.1f ns per message",
+             MSGSIZE, copied, inPlace);
+
+    epicsRingBytesDelete(ring);
+}
+
 MAIN(ringBytesTest)
 {
     int i, n;
@@ -60,7 +169,7 @@ MAIN(ringBytesTest)
     char get[RINGSIZE+1];
     epicsRingBytesId ring;
 
-    testPlan(292);
+    testPlan(323);
 
     pinfo = calloc(1,sizeof(info));
     if (!pinfo) {
@@ -128,5 +237,8 @@ MAIN(ringBytesTest)
     epicsEventDestroy(consumerEvent);
     free(pinfo);
 
+    testSpans(put);
+    testThroughput();
+
     return testDone();
 }
@@ -24,6 +24,7 @@
 #include "epicsRingPointer.h"
 #include "errlog.h"
 #include "epicsEvent.h"
+#include "epicsTime.h"
 #include "epicsUnitTest.h"
 #include "testMain.h"
 
@@ -139,6 +140,87 @@ static void testSingle(void)
     epicsRingPointerDelete(ring);
 }
 
+static void testMany(void)
+{
+    const int rsize = 100;
+    void *in[150], *out[150];
+    int i, n;
+    epicsRingPointerId ring = epicsRingPointerCreate(rsize);
+
+    testDiag("Testing bulk operations");
+
+    for(i=0; i<150; i++)
+        in[i] = int2ptr(i+1);
+
+    testOk1(epicsRingPointerPopMany(ring, out, 10)==0);
+    testOk1(epicsRingPointerPushMany(ring, in, 60)==60);
+    testOk1(epicsRingPointerGetUsed(ring)==60);
+    testOk1(epicsRingPointerPopMany(ring, out, 40)==40);
+    testOk(memcmp(out, in, 40*sizeof(void *))==0, "Popped in order");
+
+    testDiag("Fill it up, wrapping around the end");
+    n = epicsRingPointerPushMany(ring, in+60, 90);
+    testOk(n==rsize-20, "%d == %d", n, rsize-20);
+    testOk1(epicsRingPointerIsFull(ring));
+    testOk1(epicsRingPointerPushMany(ring, in, 1)==0);
+    testOk1(epicsRingPointerGetHighWaterMark(ring)==rsize);
+
+    testDiag("Drain it out");
+    n = epicsRingPointerPopMany(ring, out, 150);
+    testOk(n==rsize, "%d == %d", n, rsize);
+    testOk(memcmp(out, in+40, rsize*sizeof(void *))==0, "Popped in order");
+    testOk1(epicsRingPointerIsEmpty(ring));
+
+    epicsRingPointerDelete(ring);
+}
+
+#define NPOINTERS 1000000
+#define BATCH 32
+
+static void testThroughput(int locked)
+{
+    void *in[BATCH], *out[BATCH];
+    epicsTimeStamp begin, end;
+    double single, many;
+    int i, j, bad = 0;
+    epicsRingPointerId ring;
+    if(locked)
+        ring = epicsRingPointerLockedCreate(BATCH);
+    else
+        ring = epicsRingPointerCreate(BATCH);
+
+    for(i=0; i<BATCH; i++)
+        in[i] = int2ptr(i+1);
+
+    epicsTimeGetMonotonic(&begin);
+    for(j=0; j<NPOINTERS; j+=BATCH) {
+        for(i=0; i<BATCH; i++)
+            epicsRingPointerPush(ring, in[i]);
+        for(i=0; i<BATCH; i++)
+            out[i] = epicsRingPointerPop(ring);
+    }
+    epicsTimeGetMonotonic(&end);
+    single = epicsTimeDiffInSeconds(&end, &begin) * 1e9 / NPOINTERS;
+    bad += memcmp(out, in, sizeof(in))!=0;
+
+    epicsTimeGetMonotonic(&begin);
+    for(j=0; j<NPOINTERS; j+=BATCH) {
+        epicsRingPointerPushMany(ring, in, BATCH);
+        epicsRingPointerPopMany(ring, out, BATCH);
+    }
+    epicsTimeGetMonotonic(&end);
+    many = epicsTimeDiffInSeconds(&end, &begin) * 1e9 / NPOINTERS;
+    bad += memcmp(out, in, sizeof(in))!=0;
+
+    testOk(!bad, "Pointers pass through the %s ring intact",
+           locked ? "locked" : "unlocked");
+    testDiag("%s ring: push/pop %.1f ns, pushMany/popMany of %d %.1f ns"
+             " per pointer", locked ? "Locked" : "Unlocked", single,
+             BATCH, many);
+
+    epicsRingPointerDelete(ring);
+}
+
 typedef struct {
     epicsRingPointerId ring;
     epicsEventId sync, wait;
@@ -244,8 +326,11 @@ MAIN(ringPointerTest)
 {
     int prio = epicsThreadGetPrioritySelf();
 
-    testPlan(42);
+    testPlan(56);
     testSingle();
+    testMany();
+    testThroughput(0);
+    testThroughput(1);
     if (prio)
         epicsThreadSetPriority(epicsThreadGetIdSelf(), epicsThreadPriorityScanLow);
     testPair(0);